@@ -286,6 +286,9 @@ def print_struct(fields, key, value):
     for field in fields:
         cur_field = fields[field]
         field_type = cur_field['types'][0]
+        # e.g 'thumb' of InputMediaVideo, a local file is referred as "attach://<name>"
+        if cur_field['types'] == ['InputFile', 'String']:
+            field_type = 'String'
         field_required = cur_field['required']
         field_is_pointer = (str(field_type).strip().casefold() == str(key).strip().casefold())
         field_description = cur_field['description']['plaintext']
@@ -416,6 +419,7 @@ def generate_methods(input,output,declarations_only=False):
     parsed_json = json.loads(methods.read())
 
     for key in parsed_json:
+        # written by hand in the template, local files of the items are attached
         if key == 'sendMediaGroup':
             continue
         return_type = ""
@@ -436,15 +440,13 @@ def generate_methods(input,output,declarations_only=False):
             return_type += '>'
 
         return_type = map_tgvalue_to_cpp(return_type,True)
-        if not declarations_only:
-            print("std::pair<{1},opt_error> Bot::{0} ( ".format(key,return_type))
-        else:
+        async_type = "ApiFuture<std::pair<{},opt_error>>".format(return_type)
+        if declarations_only:
             print("/**\n\t@brief {}".format(parsed_json[key]["description"]["plaintext"]))
             for args in parsed_json[key]["arguments"]:
                 print("\t@param {} {}".format(args,parsed_json[key]["arguments"][args]["description"]["plaintext"]))
             print("\t@returns {}".format(return_type))
             print ("*/")
-            print("std::pair<{1},opt_error> {0} ( ".format(key, return_type))
 
         arguments = parsed_json[key]['arguments']
 
@@ -464,8 +466,9 @@ def generate_methods(input,output,declarations_only=False):
             else:
                 arg_type = arg_types[0]
 
+            # local file, bytes in memory or file_id/URL (see FileSource)
             if "InputFile" in arg_types:
-                arg_type = "std::string"
+                arg_type = "FileSource"
                 input_files.append(arg)
 
             required = arguments[arg]['required']
@@ -481,43 +484,67 @@ def generate_methods(input,output,declarations_only=False):
             item.append('\t'*15+ '{}\t{}{}'.format(arg_type,arg,
                                                    '={}' if declarations_only and not required else ''))
         item.sort(key=lambda x: 'std::optional' in x)
-        print(',\n'.join(item))
-        if not declarations_only:
-            print(') const {')
-        else:
-            print(') const;')
-            continue
 
-        if len(arguments) == 0:
-            print("return api->ApiCall<{}>(__func__);\n}}".format(return_type))
+        if declarations_only:
+            print("std::pair<{1},opt_error> {0} ( ".format(key, return_type))
+            print(',\n'.join(item))
+            print(') const;')
+            # asynchronous variant returns immediately, see ApiFuture
+            print("/**\n\t@brief Asynchronous version of {0}, does not block the calling thread".format(key))
+            print("\t@returns ApiFuture that receives result of {}".format(key))
+            print ("*/")
+            print("{1} {0}Async ( ".format(key, async_type))
+            print(',\n'.join(item))
+            print(') const;')
             continue
-        print("QueryBuilder builder;\nbuilder",end='')
 
-        for arg in arguments:
-            elems -= 1
-            if arg in input_files:
-                continue
-            separator = '' if elems else ';'
-            print(" << make_named_pair({}){}".format(arg,separator))
-        print(';')
+        # builder and files are the same for both variants
+        body = []
+        if len(arguments) > 0:
+            builder = "QueryBuilder builder;\nbuilder"
+            for arg in arguments:
+                elems -= 1
+                if arg in input_files:
+                    continue
+                separator = '' if elems else ';'
+                builder += " << make_named_pair({}){}\n".format(arg,separator)
+            body.append(builder + ';')
 
         if len(input_files) > 0:
-            print("std::vector<name_value_pair> params;\nparams.reserve({});".format(len(input_files)))
+            body.append("std::vector<name_file_pair> params;\nparams.reserve({});".format(len(input_files)))
             for arg in input_files:
                 if arguments[arg]['required']:
-                    print("params.push_back(name_value_pair{{\"{}\",std::move({})}});".format(arg,arg))
+                    body.append("params.push_back(name_file_pair{{\"{}\",{}}});".format(arg,arg))
                 else:
-                    print("if ({}.has_value())\n\tparams.push_back(name_value_pair{{\"{}\",std::move({}.value())}});".format(
+                    body.append("if ({}.has_value())\n\tparams.push_back(name_file_pair{{\"{}\",{}.value()}});".format(
                         arg,arg,arg))
 
-        if len(input_files) == 0 and len(unique_types) == 0:
-            print("return api->ApiCall<{}>(__func__,builder);".format(return_type))
+        if len(arguments) == 0:
+            call = "<{}>({{}})".format(return_type)
         elif len(input_files) > 0:
-            print("return api->ApiCall<{}>(__func__,builder,params);".format(return_type))
+            call = "<{}>({{}},builder,params)".format(return_type)
         elif len(unique_types) > 0:
-            print("return api->ApiCall<{},{}>(__func__,builder);".format(return_type,unique_types.pop()))
+            call = "<{},{}>({{}},builder)".format(return_type,unique_types.pop())
+        else:
+            call = "<{}>({{}},builder)".format(return_type)
 
-        print('}')
+        print("std::pair<{1},opt_error> Bot::{0} ( ".format(key,return_type))
+        print(',\n'.join(item))
+        print(') const {')
+        for line in body:
+            print(line)
+        print("return api->ApiCall{};\n}}".format(call.format("__func__")))
+
+        # __func__ would be the name of async variant, so API method name is passed explicitly
+        async_call = call.format('"{}"'.format(key))
+        if len(input_files) > 0:
+            async_call = async_call.replace("builder,params", "std::move(builder),std::move(params)")
+        print("{1} Bot::{0}Async ( ".format(key,async_type))
+        print(',\n'.join(item))
+        print(') const {')
+        for line in body:
+            print(line)
+        print("return api->ApiCallAsync{};\n}}".format(async_call))
     if declarations_only:
         print("};\n}")
     else:
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <cassert>
 #include <optional>
 #include <queue>
@@ -8,6 +9,8 @@
 
 #include "headers/update_manager.h"
 #include "headers/apimanager.h"
+#include "headers/file_downloader.h"
+#include "headers/prepared_call.h"
 
 namespace telegram {
 using opt_error = std::optional<Error>;
@@ -33,16 +36,36 @@ using opt_error = std::optional<Error>;
  * so users MUST NOT change arg names
  * 4) ApiCall is function from ApiManager class, that uses first parameter and a
  * name of method from Telegram Bot Api, so users MUST NOT change function names.
+ * 5) Every API method has an asynchronous variant with 'Async' suffix (e.g sendMessageAsync)
+ * that returns ApiFuture immediately. Results can be awaited with ApiFuture::get, passed to
+ * a callback with ApiFuture::then or combined with telegram::when_all
+ * 6) File parameters are FileSource: a path, a file_id or URL string, or bytes in memory
+ * (e.g sendPhoto(chat_id, FileSource::fromMemory(std::move(png), "chart.png")))
  */
 
 class Bot {
   std::unique_ptr<ApiManager> api;
+  std::unique_ptr<FileDownloader> downloader;
   UpdateManager updater;
-  bool stopPolling = false;
+  std::atomic<bool> stopPolling{false};
   bool webhookSet = false;
 
+  /// getUpdates with a read timeout that matches long polling 'timeout', used by Bot::start
+  std::string pollUpdates(std::optional<uint32_t> offset, std::optional<uint8_t> limit,
+                          uint32_t timeout,
+                          const std::optional<std::vector<std::string_view>> &allowed_updates);
+  /// getFile and download the file into the cache
+  std::pair<DownloadCache::Lease, opt_error> fetchFile(const std::string &file_id);
+
 public:
-  Bot(const std::string &token,std::size_t thread_number = std::thread::hardware_concurrency()) noexcept;
+  /**
+   * @param token - bot token
+   * @param thread_number - maximal number of threads that run handlers
+   * @param io_thread_number - maximal number of threads that perform outbound API calls (see Bot::async)
+   * Both pools are elastic, see Bot::setThreadPoolBounds and Bot::setIoThreadPoolBounds
+   */
+  Bot(const std::string &token,std::size_t thread_number = std::thread::hardware_concurrency(),
+      std::size_t io_thread_number = 2 * std::thread::hardware_concurrency()) noexcept;
   /**
    * @brief Set callback for Updates
    * \warning there can be only ONE callback for Updates
@@ -114,17 +137,197 @@ public:
    * \description Use this function to set sequence for id (this can be any number what
    * allows you to indentify sequence for routing)
    * @param id - any number that will be used to route callbacks of sequence
-   * @param seq - sequence that must be a std::shared_ptr
+   * @param seq - sequence (Sequence or StaticSequence) that must be a std::shared_ptr
+   */
+  template <class SequenceType>
+  void startSequence(int64_t id, std::shared_ptr<SequenceType> seq) {
+      using base_type = SequenceBase<typename SequenceType::EventType>;
+      updater.addSequence(id, std::shared_ptr<base_type>(std::move(seq)));
+  }
+  /**
+   * @brief Register sequence under 'name', so progress of users in it is saved
+   * to the state store (see Bot::setStateStore) and survives restarts
+   * \warning must be called before Bot::start
+   * @param name - unique name that identifies the sequence between restarts
+   * @param seq - sequence definition
+   */
+  template<class SequenceType>
+  void registerSequence(const std::string &name, std::shared_ptr<SequenceType> seq) {
+      using base_type = SequenceBase<typename SequenceType::EventType>;
+      updater.registerSequence(name, std::shared_ptr<base_type>(std::move(seq)));
+  }
+  /**
+   * @brief Set policies used while catching up with a backlog of updates (e.g after an outage)
+   * \description In catch-up mode too old messages are dropped or passed to
+   * CatchUpPolicy::on_stale, only the last edit of a message is routed, the handler pool
+   * keeps a worker per core and the poller requests full batches. The bot switches back
+   * to normal mode once updates are fresh again
+   */
+  void setCatchUpPolicy(CatchUpPolicy policy);
+  /**
+   * @brief Set storage of sequence progress and restore states saved in it
+   * \description Default implementation is MappedStateStore that keeps states in
+   * a local memory-mapped file:
+   * bot.setStateStore(std::make_unique<MappedStateStore>("bot_state.bin"));
+   * Register sequences before setting the store, otherwise their states are not restored
+   */
+  void setStateStore(std::unique_ptr<StateStore> store);
+  /**
+   * @brief Set bounds of the handler thread pool
+   * \description Pool grows when updates wait in the queue for too long or when workers
+   * are blocked on API calls, idle workers are retired down to 'min_threads'
+   */
+  void setThreadPoolBounds(std::size_t min_threads, std::size_t max_threads);
+  /**
+   * @brief Set bounds of the I/O thread pool (see Bot::async)
+   */
+  void setIoThreadPoolBounds(std::size_t min_threads, std::size_t max_threads);
+  /**
+   * @brief Send API calls through the event loop transport instead of blocking connections
+   * \description One loop thread multiplexes every request in flight over kept alive
+   * connections, so the number of concurrent calls is not limited by blocked threads.
+   * Available on Linux and used there by default, file uploads keep using blocking
+   * connections. Blocking connections (enable = false) open a new socket for every call
+   * \warning must be called before any API call is made
+   * @return true if transport is available on this platform
+   */
+  bool setEventLoopTransport(bool enable = true);
+  /**
+   * @brief Set limits of outbound API calls
+   * \description By default calls follow Telegram limits: 30 per second in total,
+   * 1 per second to a private chat and 20 per minute to a group. Calls to one chat are
+   * queued in order and chats are served in turn, so a busy chat does not delay others.
+   * Use non-positive rates to disable limits
+   */
+  void setRateLimits(RateLimits limits);
+  /**
+   * @brief Set how failed API calls are retried
+   * \description Calls rejected with 429 are retried after 'retry_after' from the reply,
+   * idempotent calls that failed with 5xx or got no reply are retried with backoff.
+   * When calls fail in a row, every call is held for a while (circuit breaker)
+   */
+  void setRetryPolicy(RetryPolicy policy);
+  /// totals of retried and failed API calls
+  ApiCounters apiCounters() const;
+  /**
+   * @brief Configure cache of file_id of uploaded local files
+   * \description A local file that was uploaded before is sent by file_id, unless it
+   * was modified since. The cache is kept in memory and enabled by default
+   * @param index_path - file that keeps the cache across restarts (one file per bot)
+   * @param capacity - maximal number of cached files, 0 disables the cache
+   * @return false if the index can not be written (the cache is kept in memory then)
+   */
+  bool setFileIdCache(const std::string &index_path = {},
+                      std::size_t capacity = FileIdCache::default_capacity);
+  /**
+   * @brief Download a file to 'destination'
+   * \description The file is found with getFile and kept in the download cache (see
+   * Bot::setDownloadCache), so the next request of the same file does not download it.
+   * The file is written to disk as it is received, broken downloads are resumed and
+   * concurrent requests of the same file wait for one download
+   * @param file_id - identifier of the file
+   * @param destination - path of the copy of the file
+   */
+  opt_error downloadFile(const std::string &file_id, const std::string &destination);
+  /**
+   * @brief Download a file and pass it to 'sink' by chunks
+   * \warning the file is not passed while it is received: it is downloaded to the download
+   * cache on disk first (as Bot::downloadFile), then read to 'sink', so it is never kept in memory
+   * @param file_id - identifier of the file
+   * @param sink - receives chunks of the file, returns false to stop
+   */
+  opt_error downloadFile(const std::string &file_id,
+                         const std::function<bool(const char *, std::size_t)> &sink);
+  /**
+   * @brief Download a file and map it into memory
+   * The file is not removed from the download cache while it is mapped
+   */
+  std::pair<MappedFile, opt_error> openFile(const std::string &file_id);
+  /**
+   * @brief Configure the cache of downloaded files
+   * \description Files are stored by their file_unique_id, the least recently used files
+   * are removed when the total size exceeds 'capacity' (files in use are kept)
+   * @param directory - directory of the cache ('tgbot_files-<user id>' in the temporary
+   * directory if empty, accessible by the user only)
+   * @param capacity - maximal total size of files in bytes
+   */
+  void setDownloadCache(const std::string &directory = {},
+                        std::uintmax_t capacity = DownloadCache::default_capacity);
+  /**
+   * @brief Talk to a self-hosted Bot API server (telegram-bot-api) instead of api.telegram.org
+   * \description The server can be reached over HTTP, HTTPS or a unix domain socket
+   * (with event loop transport, see Bot::setEventLoopTransport). In local mode files
+   * are not uploaded: the server reads them by file:// path (bytes in memory are written
+   * to temporary files first), and downloaded files are read from the server's disk,
+   * so the server must share the filesystem with the bot.
+   * Over a unix socket only local mode can send and download files: uploads and downloads
+   * need blocking transport, they fail with ErrorCodes::NotValid (without retries) otherwise.
+   * Must be called before the bot is started
+   * @param server - url of the server, unix socket and mode
+   * @return false if the server can not be used (e.g unix sockets are not supported on
+   * this platform), the bot keeps using the previous server then
+   */
+  bool setApiServer(const ApiServer &server);
+  /**
+   * @brief Configure the pool of connections used for API calls
+   * \description Concurrent handlers can have up to 'size' calls in flight (16 by default).
+   * With event loop transport (see Bot::setEventLoopTransport) connections are kept open
+   * between calls, so TLS handshakes are not repeated. Blocking connections open a new
+   * socket for every call and are not affected by 'idle_timeout' and 'max_requests'
+   * @param size - maximal number of connections
+   * @param idle_timeout - kept alive connections that were not used for this time are closed
+   * @param max_requests - kept alive connection is reopened after serving this number of requests
    */
-  template <class Event,class Check>
-  void startSequence(int64_t id, std::shared_ptr<Sequence<Event,Check>> seq) {
-      updater.addSequence(id, seq);
+  void setConnectionPool(std::size_t size,
+                         std::chrono::seconds idle_timeout = std::chrono::seconds(60),
+                         std::size_t max_requests = 1000);
+  /**
+   * @brief Run callable on the I/O executor and return immediately
+   * \description Handlers can hand blocking API calls off to the I/O threads, e.g
+   * bot.async([&]{ return bot.sendMessage(chat_id,"text"); });
+   * so the handler thread is not parked for the whole HTTP round trip
+   * @param f - callable without arguments
+   * @return std::future with the result of the callable
+   */
+  template <class F>
+  auto async(F&& f) const {
+      return api->execute(std::forward<F>(f));
   }
   /**
    * @brief Removes sequence for 'user_id'
    * @param id - id that was specified in startSequence
    */
   void stopSequence(int64_t id);
+  /**
+   * @brief Run callback once for the next update of CallbackType kind from 'id'
+   * \description The update is passed to the callback instead of being routed to
+   * sequences or callbacks. This is the building block of coroutine conversations,
+   * see headers/conversation.h
+   * \warning previous callback for 'id' is removed
+   * @param id - user id
+   * @param cb - callback that accepts object of the update
+   */
+  template <class CallbackType>
+  void onNextUpdate(int64_t id,
+                    std::function<void(typename traits::func_signature<CallbackType>::args_type&&)> cb) {
+      updater.addWaiter<CallbackType>(id, std::move(cb));
+  }
+  /**
+   * @brief Remove callback set with onNextUpdate for 'id'
+   */
+  void cancelNextUpdate(int64_t id);
+  /**
+   * @brief Get progress (step and user data) of the sequence started for 'id'
+   * \description Sequence object is shared between users, so per-user progress
+   * is kept separately and can be read or changed with these methods
+   * @return state if sequence exists, empty optional otherwise
+   */
+  std::optional<SequenceState> getSequenceState(int64_t id) const;
+  /**
+   * @brief Replace progress (step and user data) of the sequence started for 'id'
+   * @return true if sequence exists
+   */
+  bool setSequenceState(int64_t id, SequenceState state);
   /**
    * Use this method to get current webhook status. Requires no parameters.
    * On success, returns a WebhookInfo object.
@@ -143,7 +346,19 @@ public:
   /// stops the bot
   void stop();
 
-  /// TODO: add description
+  /**
+   * @brief Start long polling. Blocks until Bot::stop is called
+   * \description Polling is pipelined: a dedicated thread sends the next getUpdates request
+   * as soon as the previous reply is received, while the calling thread parses and routes
+   * received batches
+   * @param timeout - long polling timeout in seconds (30 by default)
+   * @param offset - identifier of the first update to be returned
+   * @param limit - maximal number of updates in one reply (1-100),
+   * by default it grows while there is a backlog and shrinks when the bot is idle
+   * @param allowed_updates - list of update types to receive (an empty list receives every
+   * type), by default only types that have registered handlers are received and no
+   * updates are requested while there are no handlers
+   */
   void start(std::optional<int64_t> timeout = {}, std::optional<int64_t> offset = {}, std::optional<int8_t> limit = {},
              std::optional<std::vector<std::string_view>> allowed_updates = {});
   /**
@@ -161,6 +376,56 @@ public:
           std::optional<uint32_t> offset = {}, std::optional<uint8_t> limit = {},
           std::optional<uint32_t> timeout = {},
           std::optional<std::vector<std::string_view>> allowed_updates = {});
+  /**
+   * @brief Send a group of photos and videos as an album
+   * \description 'media' of an item is a file_id, an URL or a path to a local file (see
+   * FileSource), 'type' is set if it is empty. Local files are uploaded in one request,
+   * they are examined in parallel and files uploaded before are sent by file_id
+   * (see Bot::setFileIdCache)
+   * @param chat_id - unique identifier for the target chat or username of the target channel
+   * @param media - 2-10 photos and videos
+   * @param disable_notification - sends the messages silently
+   * @param reply_to_message_id - if the messages are a reply, ID of the original message
+   * @return sent messages
+   */
+  std::pair<std::vector<Message>, opt_error>
+  sendMediaGroup(const std::variant<int64_t, std::string> &chat_id,
+                 std::vector<std::variant<InputMediaPhoto, InputMediaVideo>> media,
+                 std::optional<bool> disable_notification = {},
+                 std::optional<int64_t> reply_to_message_id = {}) const;
+  /**
+   * @brief Asynchronous version of sendMediaGroup, does not block the calling thread
+   * @returns ApiFuture that receives result of sendMediaGroup
+   */
+  ApiFuture<std::pair<std::vector<Message>, opt_error>>
+  sendMediaGroupAsync(const std::variant<int64_t, std::string> &chat_id,
+                      std::vector<std::variant<InputMediaPhoto, InputMediaVideo>> media,
+                      std::optional<bool> disable_notification = {},
+                      std::optional<int64_t> reply_to_message_id = {}) const;
+  /**
+   * @brief Prepare calls of a method whose arguments are partially the same for every call
+   * \description Constant arguments (e.g keyboard attached to most replies) are serialized
+   * here once, each call serializes only the rest of the arguments:
+   * \code
+   * auto reply = bot.prepare<Message>("sendMessage", make_named_pair(reply_markup));
+   * auto &&[message, error] = reply(make_named_pair(chat_id), make_named_pair(text));
+   * \endcode
+   * T (and TrueOrType) must match the result of the method, see its non-prepared version
+   * @param method - Telegram Bot Api method name, must stay valid (e.g string literal)
+   * @param constant - arguments sent with every call, made with 'make_named_pair'
+   */
+  template <class T, class TrueOrType = void, class... Args>
+  PreparedCall<T, TrueOrType> prepare(const char *method,
+                                      const std::pair<std::string_view, Args> &... constant) const {
+    QueryBuilder builder;
+    ((builder << constant), ...);
+    return prepare<T, TrueOrType>(method, builder);
+  }
+  /// Prepare calls of a method with constant arguments written to 'constant'
+  template <class T, class TrueOrType = void>
+  PreparedCall<T, TrueOrType> prepare(const char *method, const QueryBuilder &constant) const {
+    return {*api, method, constant};
+  }
 
   // --------------------- AUTOGENERATED CODE -------------------------------------
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <cassert>
 #include <optional>
 #include <queue>
@@ -8,6 +9,8 @@
 
 #include "headers/update_manager.h"
 #include "headers/apimanager.h"
+#include "headers/file_downloader.h"
+#include "headers/prepared_call.h"
 
 namespace telegram {
 using opt_error = std::optional<Error>;
@@ -33,16 +36,36 @@ using opt_error = std::optional<Error>;
  * so users MUST NOT change arg names
  * 4) ApiCall is function from ApiManager class, that uses first parameter and a
  * name of method from Telegram Bot Api, so users MUST NOT change function names.
+ * 5) Every API method has an asynchronous variant with 'Async' suffix (e.g sendMessageAsync)
+ * that returns ApiFuture immediately. Results can be awaited with ApiFuture::get, passed to
+ * a callback with ApiFuture::then or combined with telegram::when_all
+ * 6) File parameters are FileSource: a path, a file_id or URL string, or bytes in memory
+ * (e.g sendPhoto(chat_id, FileSource::fromMemory(std::move(png), "chart.png")))
  */
 
 class Bot {
   std::unique_ptr<ApiManager> api;
+  std::unique_ptr<FileDownloader> downloader;
   UpdateManager updater;
-  bool stopPolling = false;
+  std::atomic<bool> stopPolling{false};
   bool webhookSet = false;
 
+  /// getUpdates with a read timeout that matches long polling 'timeout', used by Bot::start
+  std::string pollUpdates(std::optional<uint32_t> offset, std::optional<uint8_t> limit,
+                          uint32_t timeout,
+                          const std::optional<std::vector<std::string_view>> &allowed_updates);
+  /// getFile and download the file into the cache
+  std::pair<DownloadCache::Lease, opt_error> fetchFile(const std::string &file_id);
+
 public:
-  Bot(const std::string &token,std::size_t thread_number = std::thread::hardware_concurrency()) noexcept;
+  /**
+   * @param token - bot token
+   * @param thread_number - maximal number of threads that run handlers
+   * @param io_thread_number - maximal number of threads that perform outbound API calls (see Bot::async)
+   * Both pools are elastic, see Bot::setThreadPoolBounds and Bot::setIoThreadPoolBounds
+   */
+  Bot(const std::string &token,std::size_t thread_number = std::thread::hardware_concurrency(),
+      std::size_t io_thread_number = 2 * std::thread::hardware_concurrency()) noexcept;
   /**
    * @brief Set callback for Updates
    * \warning there can be only ONE callback for Updates
@@ -114,17 +137,197 @@ public:
    * \description Use this function to set sequence for id (this can be any number what
    * allows you to indentify sequence for routing)
    * @param id - any number that will be used to route callbacks of sequence
-   * @param seq - sequence that must be a std::shared_ptr
+   * @param seq - sequence (Sequence or StaticSequence) that must be a std::shared_ptr
+   */
+  template <class SequenceType>
+  void startSequence(int64_t id, std::shared_ptr<SequenceType> seq) {
+      using base_type = SequenceBase<typename SequenceType::EventType>;
+      updater.addSequence(id, std::shared_ptr<base_type>(std::move(seq)));
+  }
+  /**
+   * @brief Register sequence under 'name', so progress of users in it is saved
+   * to the state store (see Bot::setStateStore) and survives restarts
+   * \warning must be called before Bot::start
+   * @param name - unique name that identifies the sequence between restarts
+   * @param seq - sequence definition
+   */
+  template<class SequenceType>
+  void registerSequence(const std::string &name, std::shared_ptr<SequenceType> seq) {
+      using base_type = SequenceBase<typename SequenceType::EventType>;
+      updater.registerSequence(name, std::shared_ptr<base_type>(std::move(seq)));
+  }
+  /**
+   * @brief Set policies used while catching up with a backlog of updates (e.g after an outage)
+   * \description In catch-up mode too old messages are dropped or passed to
+   * CatchUpPolicy::on_stale, only the last edit of a message is routed, the handler pool
+   * keeps a worker per core and the poller requests full batches. The bot switches back
+   * to normal mode once updates are fresh again
+   */
+  void setCatchUpPolicy(CatchUpPolicy policy);
+  /**
+   * @brief Set storage of sequence progress and restore states saved in it
+   * \description Default implementation is MappedStateStore that keeps states in
+   * a local memory-mapped file:
+   * bot.setStateStore(std::make_unique<MappedStateStore>("bot_state.bin"));
+   * Register sequences before setting the store, otherwise their states are not restored
+   */
+  void setStateStore(std::unique_ptr<StateStore> store);
+  /**
+   * @brief Set bounds of the handler thread pool
+   * \description Pool grows when updates wait in the queue for too long or when workers
+   * are blocked on API calls, idle workers are retired down to 'min_threads'
+   */
+  void setThreadPoolBounds(std::size_t min_threads, std::size_t max_threads);
+  /**
+   * @brief Set bounds of the I/O thread pool (see Bot::async)
+   */
+  void setIoThreadPoolBounds(std::size_t min_threads, std::size_t max_threads);
+  /**
+   * @brief Send API calls through the event loop transport instead of blocking connections
+   * \description One loop thread multiplexes every request in flight over kept alive
+   * connections, so the number of concurrent calls is not limited by blocked threads.
+   * Available on Linux and used there by default, file uploads keep using blocking
+   * connections. Blocking connections (enable = false) open a new socket for every call
+   * \warning must be called before any API call is made
+   * @return true if transport is available on this platform
+   */
+  bool setEventLoopTransport(bool enable = true);
+  /**
+   * @brief Set limits of outbound API calls
+   * \description By default calls follow Telegram limits: 30 per second in total,
+   * 1 per second to a private chat and 20 per minute to a group. Calls to one chat are
+   * queued in order and chats are served in turn, so a busy chat does not delay others.
+   * Use non-positive rates to disable limits
+   */
+  void setRateLimits(RateLimits limits);
+  /**
+   * @brief Set how failed API calls are retried
+   * \description Calls rejected with 429 are retried after 'retry_after' from the reply,
+   * idempotent calls that failed with 5xx or got no reply are retried with backoff.
+   * When calls fail in a row, every call is held for a while (circuit breaker)
+   */
+  void setRetryPolicy(RetryPolicy policy);
+  /// totals of retried and failed API calls
+  ApiCounters apiCounters() const;
+  /**
+   * @brief Configure cache of file_id of uploaded local files
+   * \description A local file that was uploaded before is sent by file_id, unless it
+   * was modified since. The cache is kept in memory and enabled by default
+   * @param index_path - file that keeps the cache across restarts (one file per bot)
+   * @param capacity - maximal number of cached files, 0 disables the cache
+   * @return false if the index can not be written (the cache is kept in memory then)
+   */
+  bool setFileIdCache(const std::string &index_path = {},
+                      std::size_t capacity = FileIdCache::default_capacity);
+  /**
+   * @brief Download a file to 'destination'
+   * \description The file is found with getFile and kept in the download cache (see
+   * Bot::setDownloadCache), so the next request of the same file does not download it.
+   * The file is written to disk as it is received, broken downloads are resumed and
+   * concurrent requests of the same file wait for one download
+   * @param file_id - identifier of the file
+   * @param destination - path of the copy of the file
+   */
+  opt_error downloadFile(const std::string &file_id, const std::string &destination);
+  /**
+   * @brief Download a file and pass it to 'sink' by chunks
+   * \warning the file is not passed while it is received: it is downloaded to the download
+   * cache on disk first (as Bot::downloadFile), then read to 'sink', so it is never kept in memory
+   * @param file_id - identifier of the file
+   * @param sink - receives chunks of the file, returns false to stop
+   */
+  opt_error downloadFile(const std::string &file_id,
+                         const std::function<bool(const char *, std::size_t)> &sink);
+  /**
+   * @brief Download a file and map it into memory
+   * The file is not removed from the download cache while it is mapped
+   */
+  std::pair<MappedFile, opt_error> openFile(const std::string &file_id);
+  /**
+   * @brief Configure the cache of downloaded files
+   * \description Files are stored by their file_unique_id, the least recently used files
+   * are removed when the total size exceeds 'capacity' (files in use are kept)
+   * @param directory - directory of the cache ('tgbot_files-<user id>' in the temporary
+   * directory if empty, accessible by the user only)
+   * @param capacity - maximal total size of files in bytes
+   */
+  void setDownloadCache(const std::string &directory = {},
+                        std::uintmax_t capacity = DownloadCache::default_capacity);
+  /**
+   * @brief Talk to a self-hosted Bot API server (telegram-bot-api) instead of api.telegram.org
+   * \description The server can be reached over HTTP, HTTPS or a unix domain socket
+   * (with event loop transport, see Bot::setEventLoopTransport). In local mode files
+   * are not uploaded: the server reads them by file:// path (bytes in memory are written
+   * to temporary files first), and downloaded files are read from the server's disk,
+   * so the server must share the filesystem with the bot.
+   * Over a unix socket only local mode can send and download files: uploads and downloads
+   * need blocking transport, they fail with ErrorCodes::NotValid (without retries) otherwise.
+   * Must be called before the bot is started
+   * @param server - url of the server, unix socket and mode
+   * @return false if the server can not be used (e.g unix sockets are not supported on
+   * this platform), the bot keeps using the previous server then
+   */
+  bool setApiServer(const ApiServer &server);
+  /**
+   * @brief Configure the pool of connections used for API calls
+   * \description Concurrent handlers can have up to 'size' calls in flight (16 by default).
+   * With event loop transport (see Bot::setEventLoopTransport) connections are kept open
+   * between calls, so TLS handshakes are not repeated. Blocking connections open a new
+   * socket for every call and are not affected by 'idle_timeout' and 'max_requests'
+   * @param size - maximal number of connections
+   * @param idle_timeout - kept alive connections that were not used for this time are closed
+   * @param max_requests - kept alive connection is reopened after serving this number of requests
+   */
+  void setConnectionPool(std::size_t size,
+                         std::chrono::seconds idle_timeout = std::chrono::seconds(60),
+                         std::size_t max_requests = 1000);
+  /**
+   * @brief Run callable on the I/O executor and return immediately
+   * \description Handlers can hand blocking API calls off to the I/O threads, e.g
+   * bot.async([&]{ return bot.sendMessage(chat_id,"text"); });
+   * so the handler thread is not parked for the whole HTTP round trip
+   * @param f - callable without arguments
+   * @return std::future with the result of the callable
    */
-  template <class Event,class Check>
-  void startSequence(int64_t id, std::shared_ptr<Sequence<Event,Check>> seq) {
-      updater.addSequence(id, seq);
+  template <class F>
+  auto async(F&& f) const {
+      return api->execute(std::forward<F>(f));
   }
   /**
    * @brief Removes sequence for 'user_id'
    * @param id - id that was specified in startSequence
    */
   void stopSequence(int64_t id);
+  /**
+   * @brief Run callback once for the next update of CallbackType kind from 'id'
+   * \description The update is passed to the callback instead of being routed to
+   * sequences or callbacks. This is the building block of coroutine conversations,
+   * see headers/conversation.h
+   * \warning previous callback for 'id' is removed
+   * @param id - user id
+   * @param cb - callback that accepts object of the update
+   */
+  template <class CallbackType>
+  void onNextUpdate(int64_t id,
+                    std::function<void(typename traits::func_signature<CallbackType>::args_type&&)> cb) {
+      updater.addWaiter<CallbackType>(id, std::move(cb));
+  }
+  /**
+   * @brief Remove callback set with onNextUpdate for 'id'
+   */
+  void cancelNextUpdate(int64_t id);
+  /**
+   * @brief Get progress (step and user data) of the sequence started for 'id'
+   * \description Sequence object is shared between users, so per-user progress
+   * is kept separately and can be read or changed with these methods
+   * @return state if sequence exists, empty optional otherwise
+   */
+  std::optional<SequenceState> getSequenceState(int64_t id) const;
+  /**
+   * @brief Replace progress (step and user data) of the sequence started for 'id'
+   * @return true if sequence exists
+   */
+  bool setSequenceState(int64_t id, SequenceState state);
   /**
    * Use this method to get current webhook status. Requires no parameters.
    * On success, returns a WebhookInfo object.
@@ -143,7 +346,19 @@ public:
   /// stops the bot
   void stop();
 
-  /// TODO: add description
+  /**
+   * @brief Start long polling. Blocks until Bot::stop is called
+   * \description Polling is pipelined: a dedicated thread sends the next getUpdates request
+   * as soon as the previous reply is received, while the calling thread parses and routes
+   * received batches
+   * @param timeout - long polling timeout in seconds (30 by default)
+   * @param offset - identifier of the first update to be returned
+   * @param limit - maximal number of updates in one reply (1-100),
+   * by default it grows while there is a backlog and shrinks when the bot is idle
+   * @param allowed_updates - list of update types to receive (an empty list receives every
+   * type), by default only types that have registered handlers are received and no
+   * updates are requested while there are no handlers
+   */
   void start(std::optional<int64_t> timeout = {}, std::optional<int64_t> offset = {}, std::optional<int8_t> limit = {},
              std::optional<std::vector<std::string_view>> allowed_updates = {});
   /**
@@ -161,6 +376,56 @@ public:
           std::optional<uint32_t> offset = {}, std::optional<uint8_t> limit = {},
           std::optional<uint32_t> timeout = {},
           std::optional<std::vector<std::string_view>> allowed_updates = {});
+  /**
+   * @brief Send a group of photos and videos as an album
+   * \description 'media' of an item is a file_id, an URL or a path to a local file (see
+   * FileSource), 'type' is set if it is empty. Local files are uploaded in one request,
+   * they are examined in parallel and files uploaded before are sent by file_id
+   * (see Bot::setFileIdCache)
+   * @param chat_id - unique identifier for the target chat or username of the target channel
+   * @param media - 2-10 photos and videos
+   * @param disable_notification - sends the messages silently
+   * @param reply_to_message_id - if the messages are a reply, ID of the original message
+   * @return sent messages
+   */
+  std::pair<std::vector<Message>, opt_error>
+  sendMediaGroup(const std::variant<int64_t, std::string> &chat_id,
+                 std::vector<std::variant<InputMediaPhoto, InputMediaVideo>> media,
+                 std::optional<bool> disable_notification = {},
+                 std::optional<int64_t> reply_to_message_id = {}) const;
+  /**
+   * @brief Asynchronous version of sendMediaGroup, does not block the calling thread
+   * @returns ApiFuture that receives result of sendMediaGroup
+   */
+  ApiFuture<std::pair<std::vector<Message>, opt_error>>
+  sendMediaGroupAsync(const std::variant<int64_t, std::string> &chat_id,
+                      std::vector<std::variant<InputMediaPhoto, InputMediaVideo>> media,
+                      std::optional<bool> disable_notification = {},
+                      std::optional<int64_t> reply_to_message_id = {}) const;
+  /**
+   * @brief Prepare calls of a method whose arguments are partially the same for every call
+   * \description Constant arguments (e.g keyboard attached to most replies) are serialized
+   * here once, each call serializes only the rest of the arguments:
+   * \code
+   * auto reply = bot.prepare<Message>("sendMessage", make_named_pair(reply_markup));
+   * auto &&[message, error] = reply(make_named_pair(chat_id), make_named_pair(text));
+   * \endcode
+   * T (and TrueOrType) must match the result of the method, see its non-prepared version
+   * @param method - Telegram Bot Api method name, must stay valid (e.g string literal)
+   * @param constant - arguments sent with every call, made with 'make_named_pair'
+   */
+  template <class T, class TrueOrType = void, class... Args>
+  PreparedCall<T, TrueOrType> prepare(const char *method,
+                                      const std::pair<std::string_view, Args> &... constant) const {
+    QueryBuilder builder;
+    ((builder << constant), ...);
+    return prepare<T, TrueOrType>(method, builder);
+  }
+  /// Prepare calls of a method with constant arguments written to 'constant'
+  template <class T, class TrueOrType = void>
+  PreparedCall<T, TrueOrType> prepare(const char *method, const QueryBuilder &constant) const {
+    return {*api, method, constant};
+  }
 
   // --------------------- AUTOGENERATED CODE -------------------------------------
 
@@ -180,6 +445,16 @@ std::pair<std::vector<Update>,opt_error> getUpdates (
 															std::optional<int64_t>	timeout={},
 															const std::optional<std::vector<std::string>>& 	allowed_updates={}
 ) const;
+/**
+	@brief Asynchronous version of getUpdates, does not block the calling thread
+	@returns ApiFuture that receives result of getUpdates
+*/
+ApiFuture<std::pair<std::vector<Update>,opt_error>> getUpdatesAsync ( 
+															std::optional<int64_t>	offset={},
+															std::optional<int64_t>	limit={},
+															std::optional<int64_t>	timeout={},
+															const std::optional<std::vector<std::string>>& 	allowed_updates={}
+) const;
 /**
 	@brief Use this method to specify a url and receive incoming updates via an outgoing webhook. Whenever there is an update for the bot, we will send an HTTPS POST request to the specified url, containing a JSON-serialized Update. In case of an unsuccessful request, we will give up after a reasonable amount of attempts. Returns True on success.
 	@param url HTTPS url to send updates to. Use an empty string to remove webhook integration
@@ -190,7 +465,17 @@ std::pair<std::vector<Update>,opt_error> getUpdates (
 */
 std::pair<bool,opt_error> setWebhook ( 
 															const std::string& 	url,
-															const std::optional<std::string>& 	certificate={},
+															const std::optional<FileSource>& 	certificate={},
+															std::optional<int64_t>	max_connections={},
+															const std::optional<std::vector<std::string>>& 	allowed_updates={}
+) const;
+/**
+	@brief Asynchronous version of setWebhook, does not block the calling thread
+	@returns ApiFuture that receives result of setWebhook
+*/
+ApiFuture<std::pair<bool,opt_error>> setWebhookAsync ( 
+															const std::string& 	url,
+															const std::optional<FileSource>& 	certificate={},
 															std::optional<int64_t>	max_connections={},
 															const std::optional<std::vector<std::string>>& 	allowed_updates={}
 ) const;
@@ -200,6 +485,13 @@ std::pair<bool,opt_error> setWebhook (
 */
 std::pair<bool,opt_error> deleteWebhook ( 
 
+) const;
+/**
+	@brief Asynchronous version of deleteWebhook, does not block the calling thread
+	@returns ApiFuture that receives result of deleteWebhook
+*/
+ApiFuture<std::pair<bool,opt_error>> deleteWebhookAsync ( 
+
 ) const;
 /**
 	@brief Use this method to get current webhook status. Requires no parameters. On success, returns a WebhookInfo object. If the bot is using getUpdates, will return an object with the url field empty.
@@ -207,6 +499,13 @@ std::pair<bool,opt_error> deleteWebhook (
 */
 std::pair<WebhookInfo,opt_error> getWebhookInfo ( 
 
+) const;
+/**
+	@brief Asynchronous version of getWebhookInfo, does not block the calling thread
+	@returns ApiFuture that receives result of getWebhookInfo
+*/
+ApiFuture<std::pair<WebhookInfo,opt_error>> getWebhookInfoAsync ( 
+
 ) const;
 /**
 	@brief A simple method for testing your bot's auth token. Requires no parameters. Returns basic information about the bot in form of a User object.
@@ -214,6 +513,13 @@ std::pair<WebhookInfo,opt_error> getWebhookInfo (
 */
 std::pair<User,opt_error> getMe ( 
 
+) const;
+/**
+	@brief Asynchronous version of getMe, does not block the calling thread
+	@returns ApiFuture that receives result of getMe
+*/
+ApiFuture<std::pair<User,opt_error>> getMeAsync ( 
+
 ) const;
 /**
 	@brief Use this method to send text messages. On success, the sent Message is returned.
@@ -235,6 +541,19 @@ std::pair<Message,opt_error> sendMessage (
 															std::optional<int64_t>	reply_to_message_id={},
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of sendMessage, does not block the calling thread
+	@returns ApiFuture that receives result of sendMessage
+*/
+ApiFuture<std::pair<Message,opt_error>> sendMessageAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	text,
+															const std::optional<std::string>& 	parse_mode={},
+															std::optional<bool>	disable_web_page_preview={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to forward messages of any kind. On success, the sent Message is returned.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -249,6 +568,16 @@ std::pair<Message,opt_error> forwardMessage (
 															int64_t	message_id,
 															std::optional<bool>	disable_notification={}
 ) const;
+/**
+	@brief Asynchronous version of forwardMessage, does not block the calling thread
+	@returns ApiFuture that receives result of forwardMessage
+*/
+ApiFuture<std::pair<Message,opt_error>> forwardMessageAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::variant<int64_t,std::string>& 	from_chat_id,
+															int64_t	message_id,
+															std::optional<bool>	disable_notification={}
+) const;
 /**
 	@brief Use this method to send photos. On success, the sent Message is returned.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -262,7 +591,20 @@ std::pair<Message,opt_error> forwardMessage (
 */
 std::pair<Message,opt_error> sendPhoto ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	photo,
+															const FileSource& 	photo,
+															const std::optional<std::string>& 	caption={},
+															const std::optional<std::string>& 	parse_mode={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
+/**
+	@brief Asynchronous version of sendPhoto, does not block the calling thread
+	@returns ApiFuture that receives result of sendPhoto
+*/
+ApiFuture<std::pair<Message,opt_error>> sendPhotoAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	photo,
 															const std::optional<std::string>& 	caption={},
 															const std::optional<std::string>& 	parse_mode={},
 															std::optional<bool>	disable_notification={},
@@ -286,13 +628,30 @@ std::pair<Message,opt_error> sendPhoto (
 */
 std::pair<Message,opt_error> sendAudio ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	audio,
+															const FileSource& 	audio,
+															const std::optional<std::string>& 	caption={},
+															const std::optional<std::string>& 	parse_mode={},
+															std::optional<int64_t>	duration={},
+															const std::optional<std::string>& 	performer={},
+															const std::optional<std::string>& 	title={},
+															const std::optional<FileSource>& 	thumb={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
+/**
+	@brief Asynchronous version of sendAudio, does not block the calling thread
+	@returns ApiFuture that receives result of sendAudio
+*/
+ApiFuture<std::pair<Message,opt_error>> sendAudioAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	audio,
 															const std::optional<std::string>& 	caption={},
 															const std::optional<std::string>& 	parse_mode={},
 															std::optional<int64_t>	duration={},
 															const std::optional<std::string>& 	performer={},
 															const std::optional<std::string>& 	title={},
-															const std::optional<std::string>& 	thumb={},
+															const std::optional<FileSource>& 	thumb={},
 															std::optional<bool>	disable_notification={},
 															std::optional<int64_t>	reply_to_message_id={},
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
@@ -311,8 +670,22 @@ std::pair<Message,opt_error> sendAudio (
 */
 std::pair<Message,opt_error> sendDocument ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	document,
-															const std::optional<std::string>& 	thumb={},
+															const FileSource& 	document,
+															const std::optional<FileSource>& 	thumb={},
+															const std::optional<std::string>& 	caption={},
+															const std::optional<std::string>& 	parse_mode={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
+/**
+	@brief Asynchronous version of sendDocument, does not block the calling thread
+	@returns ApiFuture that receives result of sendDocument
+*/
+ApiFuture<std::pair<Message,opt_error>> sendDocumentAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	document,
+															const std::optional<FileSource>& 	thumb={},
 															const std::optional<std::string>& 	caption={},
 															const std::optional<std::string>& 	parse_mode={},
 															std::optional<bool>	disable_notification={},
@@ -337,11 +710,29 @@ std::pair<Message,opt_error> sendDocument (
 */
 std::pair<Message,opt_error> sendVideo ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	video,
+															const FileSource& 	video,
 															std::optional<int64_t>	duration={},
 															std::optional<int64_t>	width={},
 															std::optional<int64_t>	height={},
-															const std::optional<std::string>& 	thumb={},
+															const std::optional<FileSource>& 	thumb={},
+															const std::optional<std::string>& 	caption={},
+															const std::optional<std::string>& 	parse_mode={},
+															std::optional<bool>	supports_streaming={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
+/**
+	@brief Asynchronous version of sendVideo, does not block the calling thread
+	@returns ApiFuture that receives result of sendVideo
+*/
+ApiFuture<std::pair<Message,opt_error>> sendVideoAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	video,
+															std::optional<int64_t>	duration={},
+															std::optional<int64_t>	width={},
+															std::optional<int64_t>	height={},
+															const std::optional<FileSource>& 	thumb={},
 															const std::optional<std::string>& 	caption={},
 															const std::optional<std::string>& 	parse_mode={},
 															std::optional<bool>	supports_streaming={},
@@ -366,11 +757,28 @@ std::pair<Message,opt_error> sendVideo (
 */
 std::pair<Message,opt_error> sendAnimation ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	animation,
+															const FileSource& 	animation,
+															std::optional<int64_t>	duration={},
+															std::optional<int64_t>	width={},
+															std::optional<int64_t>	height={},
+															const std::optional<FileSource>& 	thumb={},
+															const std::optional<std::string>& 	caption={},
+															const std::optional<std::string>& 	parse_mode={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
+/**
+	@brief Asynchronous version of sendAnimation, does not block the calling thread
+	@returns ApiFuture that receives result of sendAnimation
+*/
+ApiFuture<std::pair<Message,opt_error>> sendAnimationAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	animation,
 															std::optional<int64_t>	duration={},
 															std::optional<int64_t>	width={},
 															std::optional<int64_t>	height={},
-															const std::optional<std::string>& 	thumb={},
+															const std::optional<FileSource>& 	thumb={},
 															const std::optional<std::string>& 	caption={},
 															const std::optional<std::string>& 	parse_mode={},
 															std::optional<bool>	disable_notification={},
@@ -391,7 +799,21 @@ std::pair<Message,opt_error> sendAnimation (
 */
 std::pair<Message,opt_error> sendVoice ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	voice,
+															const FileSource& 	voice,
+															const std::optional<std::string>& 	caption={},
+															const std::optional<std::string>& 	parse_mode={},
+															std::optional<int64_t>	duration={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
+/**
+	@brief Asynchronous version of sendVoice, does not block the calling thread
+	@returns ApiFuture that receives result of sendVoice
+*/
+ApiFuture<std::pair<Message,opt_error>> sendVoiceAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	voice,
 															const std::optional<std::string>& 	caption={},
 															const std::optional<std::string>& 	parse_mode={},
 															std::optional<int64_t>	duration={},
@@ -413,10 +835,24 @@ std::pair<Message,opt_error> sendVoice (
 */
 std::pair<Message,opt_error> sendVideoNote ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	video_note,
+															const FileSource& 	video_note,
+															std::optional<int64_t>	duration={},
+															std::optional<int64_t>	length={},
+															const std::optional<FileSource>& 	thumb={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
+/**
+	@brief Asynchronous version of sendVideoNote, does not block the calling thread
+	@returns ApiFuture that receives result of sendVideoNote
+*/
+ApiFuture<std::pair<Message,opt_error>> sendVideoNoteAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	video_note,
 															std::optional<int64_t>	duration={},
 															std::optional<int64_t>	length={},
-															const std::optional<std::string>& 	thumb={},
+															const std::optional<FileSource>& 	thumb={},
 															std::optional<bool>	disable_notification={},
 															std::optional<int64_t>	reply_to_message_id={},
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
@@ -441,6 +877,19 @@ std::pair<Message,opt_error> sendLocation (
 															std::optional<int64_t>	reply_to_message_id={},
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of sendLocation, does not block the calling thread
+	@returns ApiFuture that receives result of sendLocation
+*/
+ApiFuture<std::pair<Message,opt_error>> sendLocationAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															float	latitude,
+															float	longitude,
+															std::optional<int64_t>	live_period={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to edit live location messages. A location can be edited until its live_period expires or editing is explicitly disabled by a call to stopMessageLiveLocation. On success, if the edited message was sent by the bot, the edited Message is returned, otherwise True is returned.
 	@param chat_id Required if inline_message_id is not specified. Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -459,6 +908,18 @@ std::pair<std::variant<bool, Message>,opt_error> editMessageLiveLocation (
 															const std::optional<std::string>& 	inline_message_id={},
 															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of editMessageLiveLocation, does not block the calling thread
+	@returns ApiFuture that receives result of editMessageLiveLocation
+*/
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> editMessageLiveLocationAsync ( 
+															float	latitude,
+															float	longitude,
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id={},
+															std::optional<int64_t>	message_id={},
+															const std::optional<std::string>& 	inline_message_id={},
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to stop updating a live location message before live_period expires. On success, if the message was sent by the bot, the sent Message is returned, otherwise True is returned.
 	@param chat_id Required if inline_message_id is not specified. Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -473,6 +934,16 @@ std::pair<std::variant<bool, Message>,opt_error> stopMessageLiveLocation (
 															const std::optional<std::string>& 	inline_message_id={},
 															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of stopMessageLiveLocation, does not block the calling thread
+	@returns ApiFuture that receives result of stopMessageLiveLocation
+*/
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> stopMessageLiveLocationAsync ( 
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id={},
+															std::optional<int64_t>	message_id={},
+															const std::optional<std::string>& 	inline_message_id={},
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to send information about a venue. On success, the sent Message is returned.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -499,6 +970,22 @@ std::pair<Message,opt_error> sendVenue (
 															std::optional<int64_t>	reply_to_message_id={},
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of sendVenue, does not block the calling thread
+	@returns ApiFuture that receives result of sendVenue
+*/
+ApiFuture<std::pair<Message,opt_error>> sendVenueAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															float	latitude,
+															float	longitude,
+															const std::string& 	title,
+															const std::string& 	address,
+															const std::optional<std::string>& 	foursquare_id={},
+															const std::optional<std::string>& 	foursquare_type={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to send phone contacts. On success, the sent Message is returned.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -521,6 +1008,20 @@ std::pair<Message,opt_error> sendContact (
 															std::optional<int64_t>	reply_to_message_id={},
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of sendContact, does not block the calling thread
+	@returns ApiFuture that receives result of sendContact
+*/
+ApiFuture<std::pair<Message,opt_error>> sendContactAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	phone_number,
+															const std::string& 	first_name,
+															const std::optional<std::string>& 	last_name={},
+															const std::optional<std::string>& 	vcard={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to send a native poll. On success, the sent Message is returned.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -557,6 +1058,27 @@ std::pair<Message,opt_error> sendPoll (
 															std::optional<int64_t>	reply_to_message_id={},
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of sendPoll, does not block the calling thread
+	@returns ApiFuture that receives result of sendPoll
+*/
+ApiFuture<std::pair<Message,opt_error>> sendPollAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	question,
+															const std::vector<std::string>& 	options,
+															std::optional<bool>	is_anonymous={},
+															const std::optional<std::string>& 	type={},
+															std::optional<bool>	allows_multiple_answers={},
+															std::optional<int64_t>	correct_option_id={},
+															const std::optional<std::string>& 	explanation={},
+															const std::optional<std::string>& 	explanation_parse_mode={},
+															std::optional<int64_t>	open_period={},
+															std::optional<int64_t>	close_date={},
+															std::optional<bool>	is_closed={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to send an animated emoji that will display a random value. On success, the sent Message is returned.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -573,6 +1095,17 @@ std::pair<Message,opt_error> sendDice (
 															std::optional<int64_t>	reply_to_message_id={},
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of sendDice, does not block the calling thread
+	@returns ApiFuture that receives result of sendDice
+*/
+ApiFuture<std::pair<Message,opt_error>> sendDiceAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::optional<std::string>& 	emoji={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method when you need to tell the user that something is happening on the bot's side. The status is set for 5 seconds or less (when a message arrives from your bot, Telegram clients clear its typing status). Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -583,6 +1116,14 @@ std::pair<bool,opt_error> sendChatAction (
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::string& 	action
 ) const;
+/**
+	@brief Asynchronous version of sendChatAction, does not block the calling thread
+	@returns ApiFuture that receives result of sendChatAction
+*/
+ApiFuture<std::pair<bool,opt_error>> sendChatActionAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	action
+) const;
 /**
 	@brief Use this method to get a list of profile pictures for a user. Returns a UserProfilePhotos object.
 	@param user_id Unique identifier of the target user
@@ -596,13 +1137,29 @@ std::pair<UserProfilePhotos,opt_error> getUserProfilePhotos (
 															std::optional<int64_t>	limit={}
 ) const;
 /**
-	@brief Use this method to get basic info about a file and prepare it for downloading. For the moment, bots can download files of up to 20MB in size. On success, a File object is returned. The file can then be downloaded via the link https://api.telegram.org/file/bot<token>/<file_path>, where <file_path> is taken from the response. It is guaranteed that the link will be valid for at least 1 hour. When the link expires, a new one can be requested by calling getFile again.
-	@param file_id File identifier to get info about
-	@returns File
+	@brief Asynchronous version of getUserProfilePhotos, does not block the calling thread
+	@returns ApiFuture that receives result of getUserProfilePhotos
+*/
+ApiFuture<std::pair<UserProfilePhotos,opt_error>> getUserProfilePhotosAsync ( 
+															int64_t	user_id,
+															std::optional<int64_t>	offset={},
+															std::optional<int64_t>	limit={}
+) const;
+/**
+	@brief Use this method to get basic info about a file and prepare it for downloading. For the moment, bots can download files of up to 20MB in size. On success, a File object is returned. The file can then be downloaded via the link https://api.telegram.org/file/bot<token>/<file_path>, where <file_path> is taken from the response. It is guaranteed that the link will be valid for at least 1 hour. When the link expires, a new one can be requested by calling getFile again.
+	@param file_id File identifier to get info about
+	@returns File
 */
 std::pair<File,opt_error> getFile ( 
 															const std::string& 	file_id
 ) const;
+/**
+	@brief Asynchronous version of getFile, does not block the calling thread
+	@returns ApiFuture that receives result of getFile
+*/
+ApiFuture<std::pair<File,opt_error>> getFileAsync ( 
+															const std::string& 	file_id
+) const;
 /**
 	@brief Use this method to kick a user from a group, a supergroup or a channel. In the case of supergroups and channels, the user will not be able to return to the group on their own using invite links, etc., unless unbanned first. The bot must be an administrator in the chat for this to work and must have the appropriate admin rights. Returns True on success.
 	@param chat_id Unique identifier for the target group or username of the target supergroup or channel (in the format @channelusername)
@@ -615,6 +1172,15 @@ std::pair<bool,opt_error> kickChatMember (
 															int64_t	user_id,
 															std::optional<int64_t>	until_date={}
 ) const;
+/**
+	@brief Asynchronous version of kickChatMember, does not block the calling thread
+	@returns ApiFuture that receives result of kickChatMember
+*/
+ApiFuture<std::pair<bool,opt_error>> kickChatMemberAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id,
+															std::optional<int64_t>	until_date={}
+) const;
 /**
 	@brief Use this method to unban a previously kicked user in a supergroup or channel. The user will not return to the group or channel automatically, but will be able to join via link, etc. The bot must be an administrator for this to work. Returns True on success.
 	@param chat_id Unique identifier for the target group or username of the target supergroup or channel (in the format @username)
@@ -625,6 +1191,14 @@ std::pair<bool,opt_error> unbanChatMember (
 															const std::variant<int64_t,std::string>& 	chat_id,
 															int64_t	user_id
 ) const;
+/**
+	@brief Asynchronous version of unbanChatMember, does not block the calling thread
+	@returns ApiFuture that receives result of unbanChatMember
+*/
+ApiFuture<std::pair<bool,opt_error>> unbanChatMemberAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id
+) const;
 /**
 	@brief Use this method to restrict a user in a supergroup. The bot must be an administrator in the supergroup for this to work and must have the appropriate admin rights. Pass True for all permissions to lift restrictions from a user. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target supergroup (in the format @supergroupusername)
@@ -639,6 +1213,16 @@ std::pair<std::variant<bool>,opt_error> restrictChatMember (
 															const ChatPermissions& 	permissions,
 															std::optional<int64_t>	until_date={}
 ) const;
+/**
+	@brief Asynchronous version of restrictChatMember, does not block the calling thread
+	@returns ApiFuture that receives result of restrictChatMember
+*/
+ApiFuture<std::pair<std::variant<bool>,opt_error>> restrictChatMemberAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id,
+															const ChatPermissions& 	permissions,
+															std::optional<int64_t>	until_date={}
+) const;
 /**
 	@brief Use this method to promote or demote a user in a supergroup or a channel. The bot must be an administrator in the chat for this to work and must have the appropriate admin rights. Pass False for all boolean parameters to demote a user. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -665,6 +1249,22 @@ std::pair<std::variant<bool>,opt_error> promoteChatMember (
 															std::optional<bool>	can_pin_messages={},
 															std::optional<bool>	can_promote_members={}
 ) const;
+/**
+	@brief Asynchronous version of promoteChatMember, does not block the calling thread
+	@returns ApiFuture that receives result of promoteChatMember
+*/
+ApiFuture<std::pair<std::variant<bool>,opt_error>> promoteChatMemberAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id,
+															std::optional<bool>	can_change_info={},
+															std::optional<bool>	can_post_messages={},
+															std::optional<bool>	can_edit_messages={},
+															std::optional<bool>	can_delete_messages={},
+															std::optional<bool>	can_invite_users={},
+															std::optional<bool>	can_restrict_members={},
+															std::optional<bool>	can_pin_messages={},
+															std::optional<bool>	can_promote_members={}
+) const;
 /**
 	@brief Use this method to set a custom title for an administrator in a supergroup promoted by the bot. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target supergroup (in the format @supergroupusername)
@@ -677,6 +1277,15 @@ std::pair<bool,opt_error> setChatAdministratorCustomTitle (
 															int64_t	user_id,
 															const std::string& 	custom_title
 ) const;
+/**
+	@brief Asynchronous version of setChatAdministratorCustomTitle, does not block the calling thread
+	@returns ApiFuture that receives result of setChatAdministratorCustomTitle
+*/
+ApiFuture<std::pair<bool,opt_error>> setChatAdministratorCustomTitleAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id,
+															const std::string& 	custom_title
+) const;
 /**
 	@brief Use this method to set default chat permissions for all members. The bot must be an administrator in the group or a supergroup for this to work and must have the can_restrict_members admin rights. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target supergroup (in the format @supergroupusername)
@@ -687,6 +1296,14 @@ std::pair<bool,opt_error> setChatPermissions (
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const ChatPermissions& 	permissions
 ) const;
+/**
+	@brief Asynchronous version of setChatPermissions, does not block the calling thread
+	@returns ApiFuture that receives result of setChatPermissions
+*/
+ApiFuture<std::pair<bool,opt_error>> setChatPermissionsAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const ChatPermissions& 	permissions
+) const;
 /**
 	@brief Use this method to generate a new invite link for a chat; any previously generated link is revoked. The bot must be an administrator in the chat for this to work and must have the appropriate admin rights. Returns the new invite link as String on success.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -695,6 +1312,13 @@ std::pair<bool,opt_error> setChatPermissions (
 std::pair<std::string,opt_error> exportChatInviteLink ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const;
+/**
+	@brief Asynchronous version of exportChatInviteLink, does not block the calling thread
+	@returns ApiFuture that receives result of exportChatInviteLink
+*/
+ApiFuture<std::pair<std::string,opt_error>> exportChatInviteLinkAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const;
 /**
 	@brief Use this method to set a new profile photo for the chat. Photos can't be changed for private chats. The bot must be an administrator in the chat for this to work and must have the appropriate admin rights. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -703,7 +1327,15 @@ std::pair<std::string,opt_error> exportChatInviteLink (
 */
 std::pair<bool,opt_error> setChatPhoto ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	photo
+															const FileSource& 	photo
+) const;
+/**
+	@brief Asynchronous version of setChatPhoto, does not block the calling thread
+	@returns ApiFuture that receives result of setChatPhoto
+*/
+ApiFuture<std::pair<bool,opt_error>> setChatPhotoAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	photo
 ) const;
 /**
 	@brief Use this method to delete a chat photo. Photos can't be changed for private chats. The bot must be an administrator in the chat for this to work and must have the appropriate admin rights. Returns True on success.
@@ -713,6 +1345,13 @@ std::pair<bool,opt_error> setChatPhoto (
 std::pair<bool,opt_error> deleteChatPhoto ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const;
+/**
+	@brief Asynchronous version of deleteChatPhoto, does not block the calling thread
+	@returns ApiFuture that receives result of deleteChatPhoto
+*/
+ApiFuture<std::pair<bool,opt_error>> deleteChatPhotoAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const;
 /**
 	@brief Use this method to change the title of a chat. Titles can't be changed for private chats. The bot must be an administrator in the chat for this to work and must have the appropriate admin rights. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -723,6 +1362,14 @@ std::pair<bool,opt_error> setChatTitle (
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::string& 	title
 ) const;
+/**
+	@brief Asynchronous version of setChatTitle, does not block the calling thread
+	@returns ApiFuture that receives result of setChatTitle
+*/
+ApiFuture<std::pair<bool,opt_error>> setChatTitleAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	title
+) const;
 /**
 	@brief Use this method to change the description of a group, a supergroup or a channel. The bot must be an administrator in the chat for this to work and must have the appropriate admin rights. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -733,6 +1380,14 @@ std::pair<bool,opt_error> setChatDescription (
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::optional<std::string>& 	description={}
 ) const;
+/**
+	@brief Asynchronous version of setChatDescription, does not block the calling thread
+	@returns ApiFuture that receives result of setChatDescription
+*/
+ApiFuture<std::pair<bool,opt_error>> setChatDescriptionAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::optional<std::string>& 	description={}
+) const;
 /**
 	@brief Use this method to pin a message in a group, a supergroup, or a channel. The bot must be an administrator in the chat for this to work and must have the 'can_pin_messages' admin right in the supergroup or 'can_edit_messages' admin right in the channel. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -745,6 +1400,15 @@ std::pair<bool,opt_error> pinChatMessage (
 															int64_t	message_id,
 															std::optional<bool>	disable_notification={}
 ) const;
+/**
+	@brief Asynchronous version of pinChatMessage, does not block the calling thread
+	@returns ApiFuture that receives result of pinChatMessage
+*/
+ApiFuture<std::pair<bool,opt_error>> pinChatMessageAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	message_id,
+															std::optional<bool>	disable_notification={}
+) const;
 /**
 	@brief Use this method to unpin a message in a group, a supergroup, or a channel. The bot must be an administrator in the chat for this to work and must have the 'can_pin_messages' admin right in the supergroup or 'can_edit_messages' admin right in the channel. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -753,6 +1417,13 @@ std::pair<bool,opt_error> pinChatMessage (
 std::pair<bool,opt_error> unpinChatMessage ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const;
+/**
+	@brief Asynchronous version of unpinChatMessage, does not block the calling thread
+	@returns ApiFuture that receives result of unpinChatMessage
+*/
+ApiFuture<std::pair<bool,opt_error>> unpinChatMessageAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const;
 /**
 	@brief Use this method for your bot to leave a group, supergroup or channel. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target supergroup or channel (in the format @channelusername)
@@ -761,6 +1432,13 @@ std::pair<bool,opt_error> unpinChatMessage (
 std::pair<bool,opt_error> leaveChat ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const;
+/**
+	@brief Asynchronous version of leaveChat, does not block the calling thread
+	@returns ApiFuture that receives result of leaveChat
+*/
+ApiFuture<std::pair<bool,opt_error>> leaveChatAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const;
 /**
 	@brief Use this method to get up to date information about the chat (current name of the user for one-on-one conversations, current username of a user, group or channel, etc.). Returns a Chat object on success.
 	@param chat_id Unique identifier for the target chat or username of the target supergroup or channel (in the format @channelusername)
@@ -769,6 +1447,13 @@ std::pair<bool,opt_error> leaveChat (
 std::pair<Chat,opt_error> getChat ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const;
+/**
+	@brief Asynchronous version of getChat, does not block the calling thread
+	@returns ApiFuture that receives result of getChat
+*/
+ApiFuture<std::pair<Chat,opt_error>> getChatAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const;
 /**
 	@brief Use this method to get a list of administrators in a chat. On success, returns an Array of ChatMember objects that contains information about all chat administrators except other bots. If the chat is a group or a supergroup and no administrators were appointed, only the creator will be returned.
 	@param chat_id Unique identifier for the target chat or username of the target supergroup or channel (in the format @channelusername)
@@ -777,6 +1462,13 @@ std::pair<Chat,opt_error> getChat (
 std::pair<std::vector<ChatMember>,opt_error> getChatAdministrators ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const;
+/**
+	@brief Asynchronous version of getChatAdministrators, does not block the calling thread
+	@returns ApiFuture that receives result of getChatAdministrators
+*/
+ApiFuture<std::pair<std::vector<ChatMember>,opt_error>> getChatAdministratorsAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const;
 /**
 	@brief Use this method to get the number of members in a chat. Returns Int on success.
 	@param chat_id Unique identifier for the target chat or username of the target supergroup or channel (in the format @channelusername)
@@ -785,6 +1477,13 @@ std::pair<std::vector<ChatMember>,opt_error> getChatAdministrators (
 std::pair<int64_t,opt_error> getChatMembersCount ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const;
+/**
+	@brief Asynchronous version of getChatMembersCount, does not block the calling thread
+	@returns ApiFuture that receives result of getChatMembersCount
+*/
+ApiFuture<std::pair<int64_t,opt_error>> getChatMembersCountAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const;
 /**
 	@brief Use this method to get information about a member of a chat. Returns a ChatMember object on success.
 	@param chat_id Unique identifier for the target chat or username of the target supergroup or channel (in the format @channelusername)
@@ -795,6 +1494,14 @@ std::pair<ChatMember,opt_error> getChatMember (
 															const std::variant<int64_t,std::string>& 	chat_id,
 															int64_t	user_id
 ) const;
+/**
+	@brief Asynchronous version of getChatMember, does not block the calling thread
+	@returns ApiFuture that receives result of getChatMember
+*/
+ApiFuture<std::pair<ChatMember,opt_error>> getChatMemberAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id
+) const;
 /**
 	@brief Use this method to set a new group sticker set for a supergroup. The bot must be an administrator in the chat for this to work and must have the appropriate admin rights. Use the field can_set_sticker_set optionally returned in getChat requests to check if the bot can use this method. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target supergroup (in the format @supergroupusername)
@@ -805,6 +1512,14 @@ std::pair<bool,opt_error> setChatStickerSet (
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::string& 	sticker_set_name
 ) const;
+/**
+	@brief Asynchronous version of setChatStickerSet, does not block the calling thread
+	@returns ApiFuture that receives result of setChatStickerSet
+*/
+ApiFuture<std::pair<bool,opt_error>> setChatStickerSetAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	sticker_set_name
+) const;
 /**
 	@brief Use this method to delete a group sticker set from a supergroup. The bot must be an administrator in the chat for this to work and must have the appropriate admin rights. Use the field can_set_sticker_set optionally returned in getChat requests to check if the bot can use this method. Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target supergroup (in the format @supergroupusername)
@@ -813,6 +1528,13 @@ std::pair<bool,opt_error> setChatStickerSet (
 std::pair<bool,opt_error> deleteChatStickerSet ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const;
+/**
+	@brief Asynchronous version of deleteChatStickerSet, does not block the calling thread
+	@returns ApiFuture that receives result of deleteChatStickerSet
+*/
+ApiFuture<std::pair<bool,opt_error>> deleteChatStickerSetAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const;
 /**
 	@brief Use this method to send answers to callback queries sent from inline keyboards. The answer will be displayed to the user as a notification at the top of the chat screen or as an alert. On success, True is returned.
 	@param callback_query_id Unique identifier for the query to be answered
@@ -829,6 +1551,17 @@ std::pair<bool,opt_error> answerCallbackQuery (
 															const std::optional<std::string>& 	url={},
 															std::optional<int64_t>	cache_time={}
 ) const;
+/**
+	@brief Asynchronous version of answerCallbackQuery, does not block the calling thread
+	@returns ApiFuture that receives result of answerCallbackQuery
+*/
+ApiFuture<std::pair<bool,opt_error>> answerCallbackQueryAsync ( 
+															const std::string& 	callback_query_id,
+															const std::optional<std::string>& 	text={},
+															std::optional<bool>	show_alert={},
+															const std::optional<std::string>& 	url={},
+															std::optional<int64_t>	cache_time={}
+) const;
 /**
 	@brief Use this method to change the list of the bot's commands. Returns True on success.
 	@param commands A JSON-serialized list of bot commands to be set as the list of the bot's commands. At most 100 commands can be specified.
@@ -837,12 +1570,26 @@ std::pair<bool,opt_error> answerCallbackQuery (
 std::pair<bool,opt_error> setMyCommands ( 
 															const std::vector<BotCommand>& 	commands
 ) const;
+/**
+	@brief Asynchronous version of setMyCommands, does not block the calling thread
+	@returns ApiFuture that receives result of setMyCommands
+*/
+ApiFuture<std::pair<bool,opt_error>> setMyCommandsAsync ( 
+															const std::vector<BotCommand>& 	commands
+) const;
 /**
 	@brief Use this method to get the current list of the bot's commands. Requires no parameters. Returns Array of BotCommand on success.
 	@returns std::vector<BotCommand>
 */
 std::pair<std::vector<BotCommand>,opt_error> getMyCommands ( 
 
+) const;
+/**
+	@brief Asynchronous version of getMyCommands, does not block the calling thread
+	@returns ApiFuture that receives result of getMyCommands
+*/
+ApiFuture<std::pair<std::vector<BotCommand>,opt_error>> getMyCommandsAsync ( 
+
 ) const;
 /**
 	@brief Use this method to edit text and game messages. On success, if edited message is sent by the bot, the edited Message is returned, otherwise True is returned.
@@ -864,6 +1611,19 @@ std::pair<std::variant<bool, Message>,opt_error> editMessageText (
 															std::optional<bool>	disable_web_page_preview={},
 															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of editMessageText, does not block the calling thread
+	@returns ApiFuture that receives result of editMessageText
+*/
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> editMessageTextAsync ( 
+															const std::string& 	text,
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id={},
+															std::optional<int64_t>	message_id={},
+															const std::optional<std::string>& 	inline_message_id={},
+															const std::optional<std::string>& 	parse_mode={},
+															std::optional<bool>	disable_web_page_preview={},
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to edit captions of messages. On success, if edited message is sent by the bot, the edited Message is returned, otherwise True is returned.
 	@param chat_id Required if inline_message_id is not specified. Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -882,6 +1642,18 @@ std::pair<std::variant<bool, Message>,opt_error> editMessageCaption (
 															const std::optional<std::string>& 	parse_mode={},
 															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of editMessageCaption, does not block the calling thread
+	@returns ApiFuture that receives result of editMessageCaption
+*/
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> editMessageCaptionAsync ( 
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id={},
+															std::optional<int64_t>	message_id={},
+															const std::optional<std::string>& 	inline_message_id={},
+															const std::optional<std::string>& 	caption={},
+															const std::optional<std::string>& 	parse_mode={},
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to edit animation, audio, document, photo, or video messages. If a message is a part of a message album, then it can be edited only to a photo or a video. Otherwise, message type can be changed arbitrarily. When inline message is edited, new file can't be uploaded. Use previously uploaded file via its file_id or specify a URL. On success, if the edited message was sent by the bot, the edited Message is returned, otherwise True is returned.
 	@param chat_id Required if inline_message_id is not specified. Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -898,6 +1670,17 @@ std::pair<std::variant<bool, Message>,opt_error> editMessageMedia (
 															const std::optional<std::string>& 	inline_message_id={},
 															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of editMessageMedia, does not block the calling thread
+	@returns ApiFuture that receives result of editMessageMedia
+*/
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> editMessageMediaAsync ( 
+															const InputMedia& 	media,
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id={},
+															std::optional<int64_t>	message_id={},
+															const std::optional<std::string>& 	inline_message_id={},
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to edit only the reply markup of messages. On success, if edited message is sent by the bot, the edited Message is returned, otherwise True is returned.
 	@param chat_id Required if inline_message_id is not specified. Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -912,6 +1695,16 @@ std::pair<std::variant<bool, Message>,opt_error> editMessageReplyMarkup (
 															const std::optional<std::string>& 	inline_message_id={},
 															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of editMessageReplyMarkup, does not block the calling thread
+	@returns ApiFuture that receives result of editMessageReplyMarkup
+*/
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> editMessageReplyMarkupAsync ( 
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id={},
+															std::optional<int64_t>	message_id={},
+															const std::optional<std::string>& 	inline_message_id={},
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to stop a poll which was sent by the bot. On success, the stopped Poll with the final results is returned.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -924,6 +1717,15 @@ std::pair<Poll,opt_error> stopPoll (
 															int64_t	message_id,
 															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of stopPoll, does not block the calling thread
+	@returns ApiFuture that receives result of stopPoll
+*/
+ApiFuture<std::pair<Poll,opt_error>> stopPollAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	message_id,
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to delete a message, including service messages, with the following limitations:- A message can only be deleted if it was sent less than 48 hours ago.- A dice message in a private chat can only be deleted if it was sent more than 24 hours ago.- Bots can delete outgoing messages in private chats, groups, and supergroups.- Bots can delete incoming messages in private chats.- Bots granted can_post_messages permissions can delete outgoing messages in channels.- If the bot is an administrator of a group, it can delete any message there.- If the bot has can_delete_messages permission in a supergroup or a channel, it can delete any message there.Returns True on success.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -934,6 +1736,14 @@ std::pair<bool,opt_error> deleteMessage (
 															const std::variant<int64_t,std::string>& 	chat_id,
 															int64_t	message_id
 ) const;
+/**
+	@brief Asynchronous version of deleteMessage, does not block the calling thread
+	@returns ApiFuture that receives result of deleteMessage
+*/
+ApiFuture<std::pair<bool,opt_error>> deleteMessageAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	message_id
+) const;
 /**
 	@brief Use this method to send static .WEBP or animated .TGS stickers. On success, the sent Message is returned.
 	@param chat_id Unique identifier for the target chat or username of the target channel (in the format @channelusername)
@@ -945,7 +1755,18 @@ std::pair<bool,opt_error> deleteMessage (
 */
 std::pair<Message,opt_error> sendSticker ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	sticker,
+															const FileSource& 	sticker,
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
+) const;
+/**
+	@brief Asynchronous version of sendSticker, does not block the calling thread
+	@returns ApiFuture that receives result of sendSticker
+*/
+ApiFuture<std::pair<Message,opt_error>> sendStickerAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	sticker,
 															std::optional<bool>	disable_notification={},
 															std::optional<int64_t>	reply_to_message_id={},
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup={}
@@ -958,6 +1779,13 @@ std::pair<Message,opt_error> sendSticker (
 std::pair<StickerSet,opt_error> getStickerSet ( 
 															const std::string& 	name
 ) const;
+/**
+	@brief Asynchronous version of getStickerSet, does not block the calling thread
+	@returns ApiFuture that receives result of getStickerSet
+*/
+ApiFuture<std::pair<StickerSet,opt_error>> getStickerSetAsync ( 
+															const std::string& 	name
+) const;
 /**
 	@brief Use this method to upload a .PNG file with a sticker for later use in createNewStickerSet and addStickerToSet methods (can be used multiple times). Returns the uploaded File on success.
 	@param user_id User identifier of sticker file owner
@@ -966,7 +1794,15 @@ std::pair<StickerSet,opt_error> getStickerSet (
 */
 std::pair<File,opt_error> uploadStickerFile ( 
 															int64_t	user_id,
-															const std::string& 	png_sticker
+															const FileSource& 	png_sticker
+) const;
+/**
+	@brief Asynchronous version of uploadStickerFile, does not block the calling thread
+	@returns ApiFuture that receives result of uploadStickerFile
+*/
+ApiFuture<std::pair<File,opt_error>> uploadStickerFileAsync ( 
+															int64_t	user_id,
+															const FileSource& 	png_sticker
 ) const;
 /**
 	@brief Use this method to create a new sticker set owned by a user. The bot will be able to edit the sticker set thus created. You must use exactly one of the fields png_sticker or tgs_sticker. Returns True on success.
@@ -985,8 +1821,22 @@ std::pair<bool,opt_error> createNewStickerSet (
 															const std::string& 	name,
 															const std::string& 	title,
 															const std::string& 	emojis,
-															const std::optional<std::string>& 	png_sticker={},
-															const std::optional<std::string>& 	tgs_sticker={},
+															const std::optional<FileSource>& 	png_sticker={},
+															const std::optional<FileSource>& 	tgs_sticker={},
+															std::optional<bool>	contains_masks={},
+															const std::optional<MaskPosition>& 	mask_position={}
+) const;
+/**
+	@brief Asynchronous version of createNewStickerSet, does not block the calling thread
+	@returns ApiFuture that receives result of createNewStickerSet
+*/
+ApiFuture<std::pair<bool,opt_error>> createNewStickerSetAsync ( 
+															int64_t	user_id,
+															const std::string& 	name,
+															const std::string& 	title,
+															const std::string& 	emojis,
+															const std::optional<FileSource>& 	png_sticker={},
+															const std::optional<FileSource>& 	tgs_sticker={},
 															std::optional<bool>	contains_masks={},
 															const std::optional<MaskPosition>& 	mask_position={}
 ) const;
@@ -1004,8 +1854,20 @@ std::pair<bool,opt_error> addStickerToSet (
 															int64_t	user_id,
 															const std::string& 	name,
 															const std::string& 	emojis,
-															const std::optional<std::string>& 	png_sticker={},
-															const std::optional<std::string>& 	tgs_sticker={},
+															const std::optional<FileSource>& 	png_sticker={},
+															const std::optional<FileSource>& 	tgs_sticker={},
+															const std::optional<MaskPosition>& 	mask_position={}
+) const;
+/**
+	@brief Asynchronous version of addStickerToSet, does not block the calling thread
+	@returns ApiFuture that receives result of addStickerToSet
+*/
+ApiFuture<std::pair<bool,opt_error>> addStickerToSetAsync ( 
+															int64_t	user_id,
+															const std::string& 	name,
+															const std::string& 	emojis,
+															const std::optional<FileSource>& 	png_sticker={},
+															const std::optional<FileSource>& 	tgs_sticker={},
 															const std::optional<MaskPosition>& 	mask_position={}
 ) const;
 /**
@@ -1018,6 +1880,14 @@ std::pair<bool,opt_error> setStickerPositionInSet (
 															const std::string& 	sticker,
 															int64_t	position
 ) const;
+/**
+	@brief Asynchronous version of setStickerPositionInSet, does not block the calling thread
+	@returns ApiFuture that receives result of setStickerPositionInSet
+*/
+ApiFuture<std::pair<bool,opt_error>> setStickerPositionInSetAsync ( 
+															const std::string& 	sticker,
+															int64_t	position
+) const;
 /**
 	@brief Use this method to delete a sticker from a set created by the bot. Returns True on success.
 	@param sticker File identifier of the sticker
@@ -1026,6 +1896,13 @@ std::pair<bool,opt_error> setStickerPositionInSet (
 std::pair<bool,opt_error> deleteStickerFromSet ( 
 															const std::string& 	sticker
 ) const;
+/**
+	@brief Asynchronous version of deleteStickerFromSet, does not block the calling thread
+	@returns ApiFuture that receives result of deleteStickerFromSet
+*/
+ApiFuture<std::pair<bool,opt_error>> deleteStickerFromSetAsync ( 
+															const std::string& 	sticker
+) const;
 /**
 	@brief Use this method to set the thumbnail of a sticker set. Animated thumbnails can be set for animated sticker sets only. Returns True on success.
 	@param name Sticker set name
@@ -1036,7 +1913,16 @@ std::pair<bool,opt_error> deleteStickerFromSet (
 std::pair<bool,opt_error> setStickerSetThumb ( 
 															const std::string& 	name,
 															int64_t	user_id,
-															const std::optional<std::string>& 	thumb={}
+															const std::optional<FileSource>& 	thumb={}
+) const;
+/**
+	@brief Asynchronous version of setStickerSetThumb, does not block the calling thread
+	@returns ApiFuture that receives result of setStickerSetThumb
+*/
+ApiFuture<std::pair<bool,opt_error>> setStickerSetThumbAsync ( 
+															const std::string& 	name,
+															int64_t	user_id,
+															const std::optional<FileSource>& 	thumb={}
 ) const;
 /**
 	@brief Use this method to send answers to an inline query. On success, True is returned.No more than 50 results per query are allowed.
@@ -1058,6 +1944,19 @@ std::pair<bool,opt_error> answerInlineQuery (
 															const std::optional<std::string>& 	switch_pm_text={},
 															const std::optional<std::string>& 	switch_pm_parameter={}
 ) const;
+/**
+	@brief Asynchronous version of answerInlineQuery, does not block the calling thread
+	@returns ApiFuture that receives result of answerInlineQuery
+*/
+ApiFuture<std::pair<bool,opt_error>> answerInlineQueryAsync ( 
+															const std::string& 	inline_query_id,
+															const std::vector<InlineQueryResult>& 	results,
+															std::optional<int64_t>	cache_time={},
+															std::optional<bool>	is_personal={},
+															const std::optional<std::string>& 	next_offset={},
+															const std::optional<std::string>& 	switch_pm_text={},
+															const std::optional<std::string>& 	switch_pm_parameter={}
+) const;
 /**
 	@brief Use this method to send invoices. On success, the sent Message is returned.
 	@param chat_id Unique identifier for the target private chat
@@ -1110,6 +2009,35 @@ std::pair<Message,opt_error> sendInvoice (
 															std::optional<int64_t>	reply_to_message_id={},
 															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of sendInvoice, does not block the calling thread
+	@returns ApiFuture that receives result of sendInvoice
+*/
+ApiFuture<std::pair<Message,opt_error>> sendInvoiceAsync ( 
+															int64_t	chat_id,
+															const std::string& 	title,
+															const std::string& 	description,
+															const std::string& 	payload,
+															const std::string& 	provider_token,
+															const std::string& 	start_parameter,
+															const std::string& 	currency,
+															const std::vector<LabeledPrice>& 	prices,
+															const std::optional<std::string>& 	provider_data={},
+															const std::optional<std::string>& 	photo_url={},
+															std::optional<int64_t>	photo_size={},
+															std::optional<int64_t>	photo_width={},
+															std::optional<int64_t>	photo_height={},
+															std::optional<bool>	need_name={},
+															std::optional<bool>	need_phone_number={},
+															std::optional<bool>	need_email={},
+															std::optional<bool>	need_shipping_address={},
+															std::optional<bool>	send_phone_number_to_provider={},
+															std::optional<bool>	send_email_to_provider={},
+															std::optional<bool>	is_flexible={},
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
+) const;
 /**
 	@brief If you sent an invoice requesting a shipping address and the parameter is_flexible was specified, the Bot API will send an Update with a shipping_query field to the bot. Use this method to reply to shipping queries. On success, True is returned.
 	@param shipping_query_id Unique identifier for the query to be answered
@@ -1124,6 +2052,16 @@ std::pair<bool,opt_error> answerShippingQuery (
 															const std::optional<std::vector<ShippingOption>>& 	shipping_options={},
 															const std::optional<std::string>& 	error_message={}
 ) const;
+/**
+	@brief Asynchronous version of answerShippingQuery, does not block the calling thread
+	@returns ApiFuture that receives result of answerShippingQuery
+*/
+ApiFuture<std::pair<bool,opt_error>> answerShippingQueryAsync ( 
+															const std::string& 	shipping_query_id,
+															bool	ok,
+															const std::optional<std::vector<ShippingOption>>& 	shipping_options={},
+															const std::optional<std::string>& 	error_message={}
+) const;
 /**
 	@brief Once the user has confirmed their payment and shipping details, the Bot API sends the final confirmation in the form of an Update with the field pre_checkout_query. Use this method to respond to such pre-checkout queries. On success, True is returned. Note: The Bot API must receive an answer within 10 seconds after the pre-checkout query was sent.
 	@param pre_checkout_query_id Unique identifier for the query to be answered
@@ -1136,6 +2074,15 @@ std::pair<bool,opt_error> answerPreCheckoutQuery (
 															bool	ok,
 															const std::optional<std::string>& 	error_message={}
 ) const;
+/**
+	@brief Asynchronous version of answerPreCheckoutQuery, does not block the calling thread
+	@returns ApiFuture that receives result of answerPreCheckoutQuery
+*/
+ApiFuture<std::pair<bool,opt_error>> answerPreCheckoutQueryAsync ( 
+															const std::string& 	pre_checkout_query_id,
+															bool	ok,
+															const std::optional<std::string>& 	error_message={}
+) const;
 /**
 	@brief Informs a user that some of the Telegram Passport elements they provided contains errors. The user will not be able to re-submit their Passport to you until the errors are fixed (the contents of the field for which you returned the error must change). Returns True on success.
 	@param user_id User identifier
@@ -1146,6 +2093,14 @@ std::pair<bool,opt_error> setPassportDataErrors (
 															int64_t	user_id,
 															const std::vector<PassportElementError>& 	errors
 ) const;
+/**
+	@brief Asynchronous version of setPassportDataErrors, does not block the calling thread
+	@returns ApiFuture that receives result of setPassportDataErrors
+*/
+ApiFuture<std::pair<bool,opt_error>> setPassportDataErrorsAsync ( 
+															int64_t	user_id,
+															const std::vector<PassportElementError>& 	errors
+) const;
 /**
 	@brief Use this method to send a game. On success, the sent Message is returned.
 	@param chat_id Unique identifier for the target chat
@@ -1162,6 +2117,17 @@ std::pair<Message,opt_error> sendGame (
 															std::optional<int64_t>	reply_to_message_id={},
 															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
 ) const;
+/**
+	@brief Asynchronous version of sendGame, does not block the calling thread
+	@returns ApiFuture that receives result of sendGame
+*/
+ApiFuture<std::pair<Message,opt_error>> sendGameAsync ( 
+															int64_t	chat_id,
+															const std::string& 	game_short_name,
+															std::optional<bool>	disable_notification={},
+															std::optional<int64_t>	reply_to_message_id={},
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup={}
+) const;
 /**
 	@brief Use this method to set the score of the specified user in a game. On success, if the message was sent by the bot, returns the edited Message, otherwise returns True. Returns an error, if the new score is not greater than the user's current score in the chat and force is False.
 	@param user_id User identifier
@@ -1182,6 +2148,19 @@ std::pair<std::variant<bool, Message>,opt_error> setGameScore (
 															std::optional<int64_t>	message_id={},
 															const std::optional<std::string>& 	inline_message_id={}
 ) const;
+/**
+	@brief Asynchronous version of setGameScore, does not block the calling thread
+	@returns ApiFuture that receives result of setGameScore
+*/
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> setGameScoreAsync ( 
+															int64_t	user_id,
+															int64_t	score,
+															std::optional<bool>	force={},
+															std::optional<bool>	disable_edit_message={},
+															std::optional<int64_t>	chat_id={},
+															std::optional<int64_t>	message_id={},
+															const std::optional<std::string>& 	inline_message_id={}
+) const;
 /**
 	@brief Use this method to get data for high score tables. Will return the score of the specified user and several of their neighbors in a game. On success, returns an Array of GameHighScore objects.
 	@param user_id Target user id
@@ -1196,5 +2175,15 @@ std::pair<std::vector<GameHighScore>,opt_error> getGameHighScores (
 															std::optional<int64_t>	message_id={},
 															const std::optional<std::string>& 	inline_message_id={}
 ) const;
+/**
+	@brief Asynchronous version of getGameHighScores, does not block the calling thread
+	@returns ApiFuture that receives result of getGameHighScores
+*/
+ApiFuture<std::pair<std::vector<GameHighScore>,opt_error>> getGameHighScoresAsync ( 
+															int64_t	user_id,
+															std::optional<int64_t>	chat_id={},
+															std::optional<int64_t>	message_id={},
+															const std::optional<std::string>& 	inline_message_id={}
+) const;
 };
 }
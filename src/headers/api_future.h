@@ -0,0 +1,228 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace telegram {
+
+template <class T> class ApiPromise;
+
+/**
+ * @brief Result of an asynchronous API call (see Bot::sendMessageAsync and other *Async methods)
+ *
+ * Unlike std::future the result can be consumed without blocking: a continuation set with \n
+ * ApiFuture::then is called by the thread that completes the call (or immediately if the \n
+ * result is ready). The result is consumed once, either by 'get' or by 'then'. \n
+ * Several futures can be combined with telegram::when_all. \n
+ * With C++20 the future can be awaited in a coroutine (co_await bot.sendMessageAsync(...)), \n
+ * the coroutine is suspended while the call is in flight and resumed on the I/O executor.
+ */
+template <class T>
+class ApiFuture {
+  struct State {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::optional<T> value;
+    std::function<void(T &&)> continuation;
+  };
+  std::shared_ptr<State> state;
+
+  explicit ApiFuture(std::shared_ptr<State> state) : state{std::move(state)} {}
+  friend class ApiPromise<T>;
+
+public:
+  using value_type = T;
+
+  ApiFuture() = default;
+  /// check if the future refers to a call, false after the result was consumed
+  bool valid() const noexcept {
+    return state != nullptr;
+  }
+  /// check if the result is available
+  bool ready() const {
+    std::unique_lock lock(state->mutex);
+    return state->value.has_value();
+  }
+  /// block until the result is available
+  void wait() const {
+    std::unique_lock lock(state->mutex);
+    state->condition.wait(lock, [this] { return state->value.has_value(); });
+  }
+  /**
+   * @brief Block until the result is available or 'timeout' expires
+   * @return true if the result is available
+   */
+  template <class Rep, class Period>
+  bool wait_for(const std::chrono::duration<Rep, Period> &timeout) const {
+    std::unique_lock lock(state->mutex);
+    return state->condition.wait_for(lock, timeout, [this] { return state->value.has_value(); });
+  }
+  /**
+   * @brief Block until the result is available and take it
+   * \warning the future is not valid afterwards
+   */
+  T get() {
+    wait();
+    auto current = std::move(state);
+    std::unique_lock lock(current->mutex);
+    return std::move(*current->value);
+  }
+  /**
+   * @brief Set callback that receives the result
+   * \description The callback is called on the thread that completes the call, or on the
+   * calling thread if the result is already available. It runs on the I/O executor, so it may
+   * call blocking API methods, but long work should be moved elsewhere
+   * \warning the future is not valid afterwards
+   * @param f - callable that accepts T&&
+   */
+  template <class F>
+  void then(F &&f) {
+    auto current = std::move(state);
+    std::unique_lock lock(current->mutex);
+    if (current->value) {
+      T value = std::move(*current->value);
+      lock.unlock();
+      std::invoke(std::forward<F>(f), std::move(value));
+    } else {
+      current->continuation = std::forward<F>(f);
+    }
+  }
+
+  // Awaitable interface, used by co_await (see headers/conversation.h).
+  // Handle is a template parameter, so the header does not require <coroutine>
+
+  bool await_ready() const {
+    return ready();
+  }
+  /// resume 'handle' when the result is available, false if it is already available
+  template <class Handle>
+  bool await_suspend(Handle handle) {
+    std::unique_lock lock(state->mutex);
+    if (state->value)
+      return false;
+    // the result is put back, so await_resume can take it
+    state->continuation = [current = state.get(), handle](T &&value) mutable {
+      {
+        std::unique_lock lock(current->mutex);
+        current->value = std::move(value);
+      }
+      handle.resume();
+    };
+    return true;
+  }
+  T await_resume() {
+    return get();
+  }
+};
+
+/// Producer side of ApiFuture, the value must be set exactly once
+template <class T>
+class ApiPromise {
+  std::shared_ptr<typename ApiFuture<T>::State> state =
+      std::make_shared<typename ApiFuture<T>::State>();
+
+public:
+  ApiFuture<T> getFuture() const {
+    return ApiFuture<T>(state);
+  }
+  /// make the result available, calls continuation if it is set
+  void setValue(T value) const {
+    std::unique_lock lock(state->mutex);
+    if (state->continuation) {
+      auto continuation = std::move(state->continuation);
+      lock.unlock();
+      continuation(std::move(value));
+      return;
+    }
+    state->value = std::move(value);
+    lock.unlock();
+    state->condition.notify_all();
+  }
+};
+
+namespace detail {
+template <class... T>
+struct WhenAllState {
+  ApiPromise<std::tuple<T...>> promise;
+  std::tuple<std::optional<T>...> results;
+  std::atomic<std::size_t> remaining{sizeof...(T)};
+
+  void complete() {
+    std::apply([this](auto &... result) { promise.setValue({std::move(*result)...}); }, results);
+  }
+};
+
+template <class... T, std::size_t... I>
+void attachAll(const std::shared_ptr<WhenAllState<T...>> &shared,
+               std::tuple<ApiFuture<T>...> &futures, std::index_sequence<I...>) {
+  (std::get<I>(futures).then([shared](auto &&value) {
+     std::get<I>(shared->results) = std::move(value);
+     if (--shared->remaining == 0)
+       shared->complete();
+   }),
+   ...);
+}
+} // namespace detail
+
+/**
+ * @brief Combine several futures into one, that is ready when all of them are ready
+ * \description Does not block, e.g
+ * when_all(bot.sendMessageAsync(a,"text"), bot.sendMessageAsync(b,"text")).get();
+ * sends both messages concurrently and waits for both replies
+ * @return future of tuple of results in the order of arguments
+ */
+template <class... T>
+ApiFuture<std::tuple<T...>> when_all(ApiFuture<T>... futures) {
+  auto shared = std::make_shared<detail::WhenAllState<T...>>();
+  auto future = shared->promise.getFuture();
+  if constexpr (sizeof...(T) == 0) {
+    shared->promise.setValue({});
+  } else {
+    std::tuple<ApiFuture<T>...> all{std::move(futures)...};
+    detail::attachAll(shared, all, std::index_sequence_for<T...>{});
+  }
+  return future;
+}
+
+/**
+ * @brief Combine futures of the same type into one, that is ready when all of them are ready
+ * @return future of results in the order of 'futures'
+ */
+template <class T>
+ApiFuture<std::vector<T>> when_all(std::vector<ApiFuture<T>> futures) {
+  struct Shared {
+    ApiPromise<std::vector<T>> promise;
+    std::vector<std::optional<T>> results;
+    std::atomic<std::size_t> remaining;
+  };
+  auto shared = std::make_shared<Shared>();
+  shared->results.resize(futures.size());
+  shared->remaining = futures.size();
+  auto future = shared->promise.getFuture();
+  if (futures.empty()) {
+    shared->promise.setValue({});
+    return future;
+  }
+  for (std::size_t i = 0; i < futures.size(); ++i) {
+    futures[i].then([shared, i](T &&value) {
+      shared->results[i] = std::move(value);
+      if (--shared->remaining == 0) {
+        std::vector<T> results;
+        results.reserve(shared->results.size());
+        for (auto &result : shared->results)
+          results.push_back(std::move(*result));
+        shared->promise.setValue(std::move(results));
+      }
+    });
+  }
+  return future;
+}
+
+} // namespace telegram
@@ -1,9 +1,22 @@
 #pragma once
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
 #include <fmt/format.h>
 
+#include "api_future.h"
+#include "file_id_cache.h"
+#include "file_source.h"
 #include "networkmanager.h"
 #include "querybuilder.h"
+#include "rate_limiter.h"
+#include "retry_controller.h"
 #include "utility/utility.h"
+#include "utility/threadpool.h"
 
 // RapidJSON conflicts with WinAPI
 // so it`s a temporal workaround for Win platforms
@@ -30,25 +43,6 @@ namespace utility {
                               return tolower(a) == tolower(b);
                           });
     }
-    /**
-     * Read file in binary format and returns std::string object
-     * which represent content of the file
-     * @param path to file
-     * \warning empty string is returned if path is not valid
-     * \return byte representation of file
-     */
-    std::string fileBytes(const std::string &filePath) {
-        std::ifstream ifs(filePath, std::ios::in | std::ios::binary);
-        if (!ifs.is_open()) {
-            utility::Logger::info("File ",filePath, "is empty");
-            return {};
-        }
-        size_t fileSize = fs::file_size(filePath);
-        std::vector<char> bytes(fileSize);
-        ifs.read(bytes.data(), fileSize);
-
-        return std::string(bytes.data(), fileSize);
-    }
     /**
      * @brief Struct represents error
      * Struct that contain error code to indicate the problem
@@ -60,6 +54,8 @@ namespace utility {
         int32_t error_code;
         /// description of error if available
         std::string description;
+        /// number of seconds to wait before the call can be repeated (when flood control is exceeded)
+        std::optional<int32_t> retry_after{};
         template<typename IStream>
         friend std::ostream& operator<<(IStream& os,const Error & e) {
             os << e.toString();
@@ -74,31 +70,73 @@ namespace utility {
 
 }
 using utility::Error;
+template <class T, class TrueOrType> class PreparedCall;
 /**
  * @brief Class that implements request to telegram api
  */
 class ApiManager {
+  template <class T, class TrueOrType> friend class PreparedCall;
+
   /// url that will be prepended to each request
   std::string base_url;
+  /// urls of called methods (base_url + method), each is built once, urls of a previous
+  /// server are kept, so calls in flight can refer to them
+  std::deque<std::string> method_urls;
+  /// urls by method name, names refer to the end of the urls
+  std::unordered_map<std::string_view, const std::string *> url_index;
+  std::shared_mutex urls_mutex;
   NetworkManager m_manager{"api.telegram.org"};
+  /// connection for long polling, its read timeout follows the polling timeout
+  NetworkManager m_poll_manager{"api.telegram.org"};
+  std::chrono::seconds poll_read_timeout{0};
+  /// every call except long polling waits for its turn here
+  RateLimiter limiter;
+  RetryController retries{limiter};
+  /// local files that were uploaded before are sent by file_id
+  FileIdCache file_ids;
+  /// the server runs with '--local', local files are sent by path
+  bool local_server = false;
+  /// executor for outbound calls, so handlers are not parked on network latency
+  utility::ThreadPool io_pool;
 
 private:
+  using Body = QueryBuilder::Body;
+  /**
+   * Url of a method, it is built on the first call of the method only
+   * @param api - Telegram Bot Api method name
+   * @return reference that stays valid for the lifetime of the manager
+   */
+  const std::string &methodUrl(const char *api) {
+    const std::string_view name = api;
+    {
+      std::shared_lock lock(urls_mutex);
+      if (auto it = url_index.find(name); it != url_index.end())
+        return *it->second;
+    }
+    std::unique_lock lock(urls_mutex);
+    if (auto it = url_index.find(name); it != url_index.end())
+      return *it->second;
+    const auto &url = method_urls.emplace_back(base_url + api);
+    url_index.emplace(std::string_view(url).substr(base_url.size()), &url);
+    return url;
+  }
   /**
-   * Function assigns value from string (not only JSON) based on value type
+   * Function assigns value from parsed JSON based on value type
    * @param value - Value to be assigned
-   * @param data - JSON string containing data
+   * @param data - 'result' part of the reply, its values are moved from
    */
-  template <class T> void assignValue(T &value, const std::string &data) const {
+  template <class T> void assignValue(T &value, rapidjson::Document &data) const {
     if constexpr (traits::is_string_type<T>)
-      value = data;
+      value = data.IsString() ? std::string(data.GetString(), data.GetStringLength())
+                              : JsonParser::i().rapidObjectToJson(data);
     else if constexpr (traits::is_parsable_v<T> || traits::is_container_v<T>)
-      value = std::move(JsonParser::i().fromJson<T>(data));
+      value = JsonParser::i().fromJson<T>(data);
     else if constexpr (std::is_same_v<bool, std::decay_t<T>>)
-      value = (utility::lowercase_compare(data, "true") ? true : false);
+      value = data.IsTrue();
     else if constexpr (std::is_integral_v<T>)
-      value = std::stoi(data);
+      value = data.IsInt64() ? static_cast<T>(data.GetInt64()) : T{};
     else if constexpr (std::is_floating_point_v<T>)
-      value = std::stof(data);
+      value = data.IsNumber() ? static_cast<T>(data.GetDouble()) : T{};
   }
   /**
    * Function assigns value of type AssignType
@@ -106,51 +144,646 @@ private:
    * It is when value in reply is not equal to object value (like assinging to std::variant)
    */
   template <class T, class AssignType>
-  void assignValue(T &value, const std::string &data) const {
+  void assignValue(T &value, rapidjson::Document &data) const {
     AssignType temp_val{};
     assignValue<AssignType>(temp_val, data);
     value = std::move(temp_val);
   }
   /**
-    This function parses telegram reply (see telegram documentation)
-    end returns pair of error flag and json string that contains data (e.g 'result' part)
-    @param view Teleram Bot Api reply
-    @return pair of boolean indicating error and JSON value from 'description' response part
+   * Parse reply into the document of the calling thread
+   * Values of the document are taken from a buffer of the thread that is reused by the
+   * next replies, so they do not allocate unless the reply is larger than the buffer.
+   * rapidjson still allocates its parsing stacks for every reply
+   * @param view - Telegram Bot Api reply
+   * @return document that is valid until the next reply is parsed on this thread
+   */
+  static rapidjson::Document &parseReply(std::string_view view) {
+    // chunks taken above the buffer are released before the next reply
+    alignas(std::max_align_t) thread_local char buffer[16 * 1024];
+    thread_local jsonAllocator allocator(buffer, sizeof(buffer));
+    thread_local rapidjson::Document doc(&allocator);
+    doc.SetNull();
+    allocator.Clear();
+    doc.Parse(view.data(), view.length());
+    return doc;
+  }
+  /**
+   * Build result of a call from HTTP response
+   * If TrueOrType is not void, reply can be either True or value of TrueOrType
+   * @param reply - response, nullptr if request failed
+   * @return Pair of Error (if available) and value
+   */
+  template <class T, class TrueOrType = void>
+  std::pair<T, std::optional<Error>> readReply(const std::shared_ptr<httplib::Response> &reply) {
+    if (!reply) {
+      return {T{}, Error{static_cast<uint32_t>(ErrorCodes::UnableToMakeRequest),
+                      "Unable to make a request"}};
+    }
+    std::pair<T, std::optional<Error>> result;
+
+    auto &doc = parseReply(reply->body);
+    if (auto error = parseWithError(doc)) {
+      result.second = Error{static_cast<int32_t>(reply->status), std::move(*error), retryAfter(doc)};
+    } else if constexpr (std::is_void_v<TrueOrType>) {
+      assignValue<T>(result.first, doc);
+    } else if (doc.IsBool()) {
+      result.first = doc.GetBool();
+    } else {
+      assignValue<T, TrueOrType>(result.first, doc);
+    }
+    return result;
+  }
+  /**
+   * Send request without blocking the calling thread and pass the response to 'done'
+   * With event loop transport the request is multiplexed by the loop thread, otherwise
+   * it is made on the I/O executor. 'done' is always called on the I/O executor
+   * @param body - shared by attempts of the call, the I/O executor takes a reference
+   * to it instead of a copy
+   */
+  template <class F>
+  void send(const std::string &url, std::shared_ptr<const std::string> body, F &&done) {
+    if (m_manager.usesEventLoop()) {
+      m_manager.postAsync(url, {}, *body, utility::toString(ContentTypes::application_json),
+                          [this, done = std::forward<F>(done)](auto reply) mutable {
+                            io_pool.enqueue([done = std::move(done), reply = std::move(reply)]() mutable {
+                              done(std::move(reply));
+                            });
+                          });
+    } else {
+      // the url is one of method_urls, it outlives the request
+      io_pool.enqueue([this, &url, body = std::move(body),
+                       done = std::forward<F>(done)]() mutable {
+        utility::ThreadPool::BlockingScope blocking;
+        done(m_manager.post(url, {}, *body));
+      });
+    }
+  }
+  /**
+   * Receiver of the call for rate limiting: value of 'chat_id' argument if it is set
+   * Ids of groups and channels are negative, channels can also be set by username
+   */
+  static RateLimiter::Destination destination(const QueryBuilder &builder) {
+    const auto &doc = builder.getDocument();
+    if (!doc.IsObject())
+      return {};
+    auto chat = doc.FindMember("chat_id");
+    if (chat == doc.MemberEnd())
+      return {};
+    if (chat->value.IsInt64())
+      return {std::to_string(chat->value.GetInt64()), chat->value.GetInt64() < 0};
+    if (chat->value.IsString())
+      return {chat->value.GetString(), true};
+    return {};
+  }
+  /// receiver of a prepared call, it can be set by either prepared or call arguments
+  static RateLimiter::Destination destination(const QueryBuilder &builder,
+                                              const RateLimiter::Destination &prepared) {
+    auto result = destination(builder);
+    return result.chat.empty() ? prepared : result;
+  }
+  /**
+   * Make call with serialized arguments without blocking the calling thread
+   * @param body - JSON object with arguments of the call
+   */
+  template <class T, class TrueOrType>
+  ApiFuture<std::pair<T, std::optional<Error>>>
+  postAsync(const char *api, const RateLimiter::Destination &receiver, std::string body) {
+    using Result = std::pair<T, std::optional<Error>>;
+    ApiPromise<Result> promise;
+    // attempts copy the request, they share one body
+    withRetriesAsync(api, receiver,
+                     [this, url = &methodUrl(api),
+                      body = std::make_shared<const std::string>(std::move(body))](std::function<void(Result)> done) {
+                       send(*url, body, [this, done](std::shared_ptr<httplib::Response> reply) {
+                         done(readReply<T, TrueOrType>(reply));
+                       });
+                     },
+                     promise);
+    return promise.getFuture();
+  }
+  /// local file of a call, examined before the request is made
+  struct Upload {
+    /// file_id of the file if it was uploaded before
+    std::optional<std::string> file_id;
+    /// absolute path of the file
+    fs::path path;
+    /// size of the file, not obtained for files sent by file_id
+    std::optional<std::uintmax_t> size;
+  };
+  /**
+   * Look up cached file_id and size of local files in 'params'
+   * The lookups take microseconds, so they are made on the calling thread, result is
+   * indexed like 'params'
+   */
+  std::vector<Upload> prepareUploads(const std::vector<name_file_pair> &params) {
+    std::vector<Upload> uploads(params.size());
+    for (std::size_t i = 0; i < params.size(); ++i) {
+      if (params[i].second.kind() != FileSource::Kind::Path)
+        continue;
+      const auto path = params[i].second.path();
+      auto &upload = uploads[i];
+      std::error_code error;
+      upload.path = fs::absolute(path, error);
+      if (error)
+        upload.path = path;
+      // thumbnails can not be sent by file_id
+      if (params[i].first.substr(0, 5) != "thumb")
+        upload.file_id = file_ids.find(path);
+      if (upload.file_id)
+        continue;
+      const auto size = fs::file_size(upload.path, error);
+      if (!error)
+        upload.size = size;
+    }
+    return uploads;
+  }
+  /**
+   * Send local files in 'params' by file_id if they were uploaded before, upload them otherwise
+   * \warning is not rate limited, see ApiManager::ApiCall
+   */
+  template <class T>
+  std::pair<T, std::optional<Error>>
+  sendFiles(const char *api, QueryBuilder &builder, const std::vector<name_file_pair> &params) {
+    if (local_server)
+      return sendLocalFiles<T>(api, builder, params);
+    const auto uploads = prepareUploads(params);
+    auto values = params;
+    std::vector<fs::path> cached;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      if (!uploads[i].file_id)
+        continue;
+      cached.push_back(values[i].second.path());
+      values[i].second = FileSource::fromId(*uploads[i].file_id);
+    }
+    if (cached.empty())
+      return postFiles<T>(api, builder, params, uploads);
+    auto result = postFiles<T>(api, builder, values, uploads);
+    if (!result.second || result.second->error_code != 400 ||
+        result.second->description.find("file") == std::string::npos)
+      return result;
+    // file_id was rejected (e.g the index belongs to another bot), so the files are uploaded
+    utility::Logger::warn(fmt::format("{}: cached file_id was rejected ({}), uploading files",
+                                      api, result.second->description));
+    for (const auto &path : cached)
+      file_ids.erase(path);
+    limiter.acquire(destination(builder));
+    return postFiles<T>(api, builder, params, uploads);
+  }
+  /// file:// URI of absolute 'path'
+  static std::string fileUri(const fs::path &path) {
+    std::string uri = "file://";
+    const auto generic = path.generic_string();
+    if (generic.empty() || generic.front() != '/')
+      uri += '/';
+    for (unsigned char c : generic) {
+      if (std::isalnum(c) || std::strchr("-_.~/:", c))
+        uri += static_cast<char>(c);
+      else
+        uri += fmt::format("%{:02X}", c);
+    }
+    return uri;
+  }
+  /**
+   * Send files in 'params' to a server in local mode: the server reads local files by path,
+   * bytes in memory are written to temporary files for the time of the call
+   * \warning is not rate limited, see ApiManager::ApiCall
+   */
+  template <class T>
+  std::pair<T, std::optional<Error>>
+  sendLocalFiles(const char *api, QueryBuilder &builder, const std::vector<name_file_pair> &params) {
+    auto values = params;
+    std::vector<fs::path> temporary;
+    auto removeTemporary = [&temporary] {
+      std::error_code error;
+      for (const auto &path : temporary)
+        fs::remove(path, error);
+    };
+    for (auto &value : values) {
+      std::error_code error;
+      if (value.second.kind() == FileSource::Kind::Path) {
+        auto path = fs::absolute(value.second.path(), error);
+        value.second = FileSource::fromId(fileUri(error ? value.second.path() : path));
+      } else if (value.second.kind() == FileSource::Kind::Memory) {
+        // unique name, the extension is kept because it matters for documents
+        const auto name = fmt::format("tgbot-{}-{}{}",
+                                      std::hash<std::thread::id>{}(std::this_thread::get_id()),
+                                      std::chrono::steady_clock::now().time_since_epoch().count(),
+                                      fs::path(value.second.filename()).extension().string());
+        const auto path = fs::temp_directory_path(error) / name;
+        std::ofstream file;
+        if (!error)
+          file.open(path, std::ios::binary);
+        if (file.is_open())
+          temporary.push_back(path);
+        if (!file.write(value.second.data(), static_cast<std::streamsize>(value.second.size())) ||
+            !file.flush()) {
+          removeTemporary();
+          return {T{}, Error{static_cast<int32_t>(ErrorCodes::NotValid),
+                             "Unable to write temporary file " + path.string()}};
+        }
+        value.second = FileSource::fromId(fileUri(path));
+      }
+    }
+    auto result = postFiles<T>(api, builder, values, std::vector<Upload>(values.size()));
+    removeTemporary();
+    return result;
+  }
+  /// JSON string that refers to a file uploaded as 'name' (e.g 'media' of InputMediaPhoto)
+  static std::string attachReference(std::string_view name) {
+    return "\"attach://" + std::string(name) + '"';
+  }
+  /**
+   * Replace references to files in 'params' that are sent by file_id or URL with the value
+   * @param json - serialized parameter (e.g 'media' of sendMediaGroup)
+   */
+  static void resolveAttachments(std::string &json, const std::vector<name_file_pair> &params) {
+    for (auto &&[name, file] : params) {
+      if (file.kind() != FileSource::Kind::Remote)
+        continue;
+      const auto reference = attachReference(name);
+      std::string value = "\"";
+      for (char c : file.id()) {
+        if (c == '"' || c == '\\')
+          value += '\\';
+        value += c;
+      }
+      value += '"';
+      for (auto pos = json.find(reference); pos != std::string::npos;
+           pos = json.find(reference, pos + value.size()))
+        json.replace(pos, reference.size(), value);
+    }
+  }
+  /**
+   * Index of an item of an array parameter that refers to the file uploaded as 'name'
+   * (e.g index of the media of sendMediaGroup, it matches index of the sent message)
+   */
+  static std::optional<std::size_t> attachmentIndex(const rapidjson::Value &request,
+                                                    std::string_view name) {
+    if (!request.IsObject())
+      return {};
+    const auto reference = "attach://" + std::string(name);
+    for (auto it = request.MemberBegin(); it != request.MemberEnd(); ++it) {
+      if (!it->value.IsArray())
+        continue;
+      for (rapidjson::SizeType i = 0; i < it->value.Size(); ++i) {
+        const auto &item = it->value[i];
+        if (item.IsObject() && item.HasMember("media") && item["media"].IsString() &&
+            reference == item["media"].GetString())
+          return i;
+      }
+    }
+    return {};
+  }
+  /**
+   * Remember file_id of files uploaded by a successful call
+   * @param reply - Telegram Bot Api reply
+   * @param uploaded - names of parameters and paths of files that were uploaded
+   * @param request - parameters of the call
+   */
+  void rememberFileIds(std::string_view reply,
+                       const std::vector<std::pair<std::string_view, fs::path>> &uploaded,
+                       const rapidjson::Value &request) {
+    rapidjson::Document doc;
+    doc.Parse(reply.data(), reply.length());
+    if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("result"))
+      return;
+    const auto &result = doc["result"];
+    auto remember = [this](const rapidjson::Value &message, std::string_view name,
+                           const fs::path &path) {
+      auto field = message.FindMember(std::string(name).data());
+      if (field == message.MemberEnd())
+        return false;
+      // the largest size of a photo is the last
+      const auto *file = &field->value;
+      if (file->IsArray() && !file->Empty())
+        file = &(*file)[file->Size() - 1];
+      if (!file->IsObject() || !file->HasMember("file_id") || !(*file)["file_id"].IsString())
+        return false;
+      file_ids.insert(path, (*file)["file_id"].GetString());
+      return true;
+    };
+    for (const auto &[name, path] : uploaded) {
+      // e.g 'photo' parameter of sendPhoto is 'photo' field of the sent Message
+      if (result.IsObject()) {
+        remember(result, name, path);
+        continue;
+      }
+      // sendMediaGroup replies with a message per item
+      const auto index = attachmentIndex(request, name);
+      if (!result.IsArray() || !index || *index >= result.Size())
+        continue;
+      const auto &message = result[static_cast<rapidjson::SizeType>(*index)];
+      if (!message.IsObject())
+        continue;
+      for (auto field : {"photo", "video", "document", "audio", "animation"}) {
+        if (remember(message, field, path))
+          break;
+      }
+    }
+  }
+  /**
+   * Make multipart request if there are files to upload in 'params', usual request otherwise
+   * @param uploads - local files in 'params', see ApiManager::prepareUploads
+   * \warning is not rate limited, see ApiManager::ApiCall
+   */
+  template <class T>
+  std::pair<T, std::optional<Error>>
+  postFiles(const char *api, QueryBuilder &builder, const std::vector<name_file_pair> &params,
+            const std::vector<Upload> &uploads) {
+    utility::Logger::info(fmt::format("Calling {} with args: {} and files",api,builder.getQuery()));
+
+    if (std::any_of(params.begin(), params.end(),
+                    [](const name_file_pair &value) { return value.second.uploaded(); })) {
+      // the request would fail every attempt, so it is not made
+      if (!m_manager.blockingSupported())
+        return {T{}, Error{static_cast<int32_t>(ErrorCodes::NotValid),
+                           "Files can not be uploaded over unix socket, run the server in "
+                           "local mode or send files by file_id or URL"}};
+      /// rewrite the doc to multipart fields, files are streamed when the request is sent
+      MultipartBody body;
+      /// objects and arrays that can refer to files (e.g 'media' of sendMediaGroup)
+      std::string attachments;
+      const auto &build_doc = builder.getDocument().GetObject();
+      for (auto it = build_doc.begin(); it != build_doc.end(); ++it) {
+        // written by a previous attempt that sent file_id
+        if (std::any_of(params.begin(), params.end(), [&](const name_file_pair &value) {
+              return value.first == it->name.GetString();
+            }))
+          continue;
+        if (it->value.IsInt() || it->value.IsInt64())
+          body.addField(it->name.GetString(), std::to_string(it->value.GetInt64()));
+        else if (it->value.IsBool())
+          body.addField(it->name.GetString(), it->value.GetBool() ? utility::true_literal
+                                                                  : utility::false_literal);
+        else if (it->value.IsString())
+          body.addField(it->name.GetString(), it->value.GetString());
+        else if (it->value.IsObject() || it->value.IsArray()) {
+          rapidjson::StringBuffer buffer;
+          rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+          it->value.Accept(writer);
+          std::string json = buffer.GetString();
+          attachments += json;
+          resolveAttachments(json, params);
+          body.addField(it->name.GetString(), json);
+        }
+      }
+
+      std::vector<std::pair<std::string_view, fs::path>> uploaded;
+      for (std::size_t i = 0; i < params.size(); ++i) {
+        const auto &[name, file] = params[i];
+        if (file.kind() == FileSource::Kind::Remote) {
+          // the value is written where the file is referenced
+          if (attachments.find(attachReference(name)) == std::string::npos)
+            body.addField(name, file.id());
+        } else if (file.kind() == FileSource::Kind::Memory) {
+          body.addMemory(name, file.data(), file.size(), file.filename());
+        } else {
+          auto path = file.path();
+          const auto &upload = uploads[i];
+            /// check if value is certificate or key file
+            /// telegram has additional requirements in that case (prepend '@' to filename)
+          const bool certificate = path.filename().string().find(".pem") != std::string::npos;
+          const auto field = certificate ? std::string_view("certificate") : name;
+          const auto filename = certificate ? '@' + path.string() : path.filename().string();
+          bool added = true;
+          if (upload.size)
+            body.addFile(field, upload.path, *upload.size, filename);
+          else
+            added = body.addFile(field, upload.path, filename);
+          if (!added)
+            return {T{}, Error{static_cast<int32_t>(ErrorCodes::NotValid),
+                               "File " + path.string() + " can not be read"}};
+          if (!certificate)
+            uploaded.emplace_back(name, path);
+        }
+      }
+      auto reply = m_manager.post(methodUrl(api), body);
+      if (reply && !uploaded.empty())
+        rememberFileIds(reply->body, uploaded, builder.getDocument());
+      return readReply<T>(reply);
+    } else if (params.size()) {
+      const auto attachments = builder.getQuery();
+      for (auto &&[name, file] : params) {
+        // builder is reused when the call is retried
+        if (attachments.find(attachReference(name)) == std::string::npos &&
+            (!builder.getDocument().IsObject() || !builder.getDocument().HasMember(name.data())))
+          builder << name_value_pair{name, file.id()};
+      }
+      auto query = builder.getQuery();
+      resolveAttachments(query, params);
+      return readReply<T>(m_manager.post(methodUrl(api), {}, query));
+    } else {
+      return {T{}, Error{static_cast<int32_t>(ErrorCodes::NotValid),
+                         std::string("Id or filepath is not valid for at least one file at ") +
+                             __func__}};
+    }
+  }
+  /**
+   * Get 'retry_after' from 'parameters' of an error reply (see ResponseParameters)
+   * @param doc - parsed Telegram Bot Api reply
+   */
+  static std::optional<int32_t> retryAfter(const rapidjson::Value &doc) {
+    if (!doc.IsObject())
+      return {};
+    auto parameters = doc.FindMember("parameters");
+    if (parameters == doc.MemberEnd() || !parameters->value.IsObject())
+      return {};
+    auto retry_after = parameters->value.FindMember("retry_after");
+    if (retry_after == parameters->value.MemberEnd() || !retry_after->value.IsInt())
+      return {};
+    return retry_after->value.GetInt();
+  }
+  /// delay before the next attempt of the call, empty if it must not be retried
+  template <class Result>
+  std::optional<std::chrono::milliseconds> retryDelay(const char *api,
+                                                      const RateLimiter::Destination &destination,
+                                                      const Result &result, std::size_t attempt) {
+    const auto &error = result.second;
+    auto delay = retries.onResult(api, destination, error ? error->error_code : 0,
+                                  error ? error->retry_after : std::nullopt, attempt);
+    if (delay)
+      utility::Logger::warn(fmt::format("{} failed ({}), retrying in {} ms", api,
+                                        error->toString(), delay->count()));
+    return delay;
+  }
+  /**
+   * Make call and repeat it while RetryController allows
+   * @param request - callable that makes one attempt and returns pair of value and error
+   */
+  template <class Request>
+  auto withRetries(const char *api, const RateLimiter::Destination &destination,
+                   Request &&request) -> std::invoke_result_t<Request> {
+    std::chrono::milliseconds delay{0};
+    for (std::size_t attempt = 1;; ++attempt) {
+      limiter.acquire(destination, delay);
+      auto result = request();
+      auto retry = retryDelay(api, destination, result, attempt);
+      if (!retry)
+        return result;
+      delay = *retry;
+    }
+  }
+  /**
+   * Asynchronous version of ApiManager::withRetries
+   * @param request - callable that starts one attempt and passes pair of value and error
+   * to its argument, std::function<void(Result)> (on the I/O executor)
+   * @param promise - receives the result of the last attempt
+   */
+  template <class Result, class Request>
+  void withRetriesAsync(const char *api, const RateLimiter::Destination &destination,
+                        Request request, ApiPromise<Result> promise, std::size_t attempt = 1,
+                        std::chrono::milliseconds delay = std::chrono::milliseconds(0)) {
+    limiter.submit(destination, [this, api, destination, request, promise, attempt] {
+      request([this, api, destination, request, promise, attempt](Result result) {
+        if (auto retry = retryDelay(api, destination, result, attempt))
+          withRetriesAsync(api, destination, request, promise, attempt + 1, *retry);
+        else
+          promise.setValue(std::move(result));
+      });
+    }, delay);
+  }
+  /**
+    This function checks telegram reply (see telegram documentation)
+    and replaces the reply in 'doc' with its 'result' part, so it is converted in place
+    @param doc Teleram Bot Api reply parsed with parseReply, left unchanged on error
+    @return value of 'description' response part, empty optional if the reply is ok
    */
-  std::pair<bool,std::string> parseWithError(std::string_view view) {
-      rapidjson::Document doc;
-      if (!view.size()) {
-          return {false,{"Empty or not valid json"}};
+  std::optional<std::string> parseWithError(rapidjson::Document &doc) {
+      if (doc.GetParseError() == rapidjson::kParseErrorDocumentEmpty) {
+          return {"Empty or not valid json"};
       }
-      doc.Parse(view.data(),view.length());
-      if (doc["ok"].GetBool()) {
-          if (auto& val = doc["result"];val.IsArray())
-              return {true,JsonParser::i().rapidArrayToJson(val.GetArray())};
-          else if (val.IsObject())
-              return {true,JsonParser::i().rapidObjectToJson(val.GetObject())};
-          else if (val.IsNumber()) {
-              return {true,std::to_string(val.GetInt())};
-          } else if (val.IsString()) {
-              return {true,val.GetString()};
-          } else if (val.IsFloat()) {
-              return {true,std::to_string(val.GetFloat())};
-          } else if (val.IsTrue()) {
-              return {true,"true"};
-          } else if (val.IsFalse()) {
-              return {true,"false"};
-          } else {
-              assert("Undefined value");
-          }
-      } else {
-          return {false,doc["description"].GetString()};
+      // e.g HTML page of a proxy that answers 5xx
+      if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("ok") || !doc["ok"].IsBool()) {
+          return {"Not valid reply"};
       }
-      // to supress warning
+      if (!doc["ok"].GetBool()) {
+          auto description = doc.FindMember("description");
+          if (description == doc.MemberEnd() || !description->value.IsString())
+              return {"Not valid reply"};
+          return std::string(description->value.GetString(), description->value.GetStringLength());
+      }
+      rapidjson::Value result;
+      if (auto value = doc.FindMember("result"); value != doc.MemberEnd())
+          result.Swap(value->value);
+      // values stay in the allocator of the document, the rest of the reply is dropped
+      static_cast<rapidjson::Value &>(doc).Swap(result);
       return {};
   }
 
 public:
-  ApiManager() {}
-  ApiManager(std::string &&url) noexcept : base_url{std::move(url)} {}
+  ApiManager(std::size_t io_threads = 2) : io_pool(1, io_threads) {
+    m_poll_manager.setPoolSize(1);
+  }
+  ApiManager(std::string &&url, std::size_t io_threads = 2)
+      : base_url{std::move(url)}, io_pool(1, io_threads) {
+    m_poll_manager.setPoolSize(1);
+  }
+  ~ApiManager() {
+    // queued calls are dropped and dispatched ones finish before the transport is stopped
+    limiter.stop();
+    // requests in flight complete on the I/O executor, so the loop is stopped while it is alive
+    m_manager.setEventLoopBackend(false);
+  }
+
+  /**
+   * Set limits of outbound calls (see RateLimiter)
+   */
+  void setRateLimits(RateLimits limits) {
+    limiter.setLimits(limits);
+  }
+  /**
+   * Set policy of retries and circuit breaker (see RetryController)
+   */
+  void setRetryPolicy(RetryPolicy policy) {
+    retries.setPolicy(policy);
+  }
+  /// totals of retried and failed calls
+  ApiCounters counters() const {
+    return retries.counters();
+  }
+  /**
+   * Configure cache of file_id of uploaded files (see FileIdCache)
+   * @param index - file that keeps the cache across restarts, empty to keep it in memory only
+   * @param capacity - maximal number of files, 0 disables the cache
+   * @return false if the index can not be written
+   */
+  bool setFileIdCache(const std::string &index, std::size_t capacity) {
+    file_ids.setCapacity(capacity);
+    if (index.empty())
+      return true;
+    // file_id is issued to a bot, so the index is bound to id of the bot (token is not stored)
+    auto bot = base_url.rfind("/bot");
+    auto bot_id = bot == std::string::npos
+                      ? std::string{}
+                      : base_url.substr(bot + 4, base_url.find(':', bot) - bot - 4);
+    return file_ids.setIndex(index, bot_id);
+  }
+  /**
+   * Make calls to 'server' instead of the public Bot API server
+   * \warning must not be changed while calls are in flight
+   * @return false if the server can not be used
+   */
+  bool setServer(const ApiServer &server) {
+    // both managers accept the server or neither is changed
+    if (!NetworkManager::supports(server) || !m_manager.setServer(server) ||
+        !m_poll_manager.setServer(server))
+      return false;
+    std::string_view url = server.url;
+    // 'http://localhost:8081/' must not make '//bot' urls
+    while (!url.empty() && url.back() == '/')
+      url.remove_suffix(1);
+    base_url = std::string(url) + base_url.substr(base_url.rfind("/bot"));
+    local_server = server.local;
+    std::unique_lock lock(urls_mutex);
+    url_index.clear();
+    return true;
+  }
+  /// prefix of urls of files, https://api.telegram.org/file/bot<token>/ for the public server
+  std::string fileUrl() const {
+    const auto bot = base_url.rfind("/bot");
+    return base_url.substr(0, bot) + "/file" + base_url.substr(bot);
+  }
+
+  /**
+   * Use non-blocking event loop transport for API calls (see AsyncHttpClient)
+   * It is used by default where available
+   * @return true if transport is available on this platform
+   */
+  bool setEventLoopTransport(bool enable) {
+    return m_manager.setEventLoopBackend(enable);
+  }
+  /**
+   * Configure the pool of connections used for API calls
+   * @param size - maximal number of connections, calls wait for a free one above it
+   * @param idle_timeout - kept alive connections that were not used for this time are closed
+   * @param max_requests - kept alive connection is closed after serving this number of requests
+   */
+  void setConnectionPool(std::size_t size, std::chrono::seconds idle_timeout,
+                         std::size_t max_requests) {
+    m_manager.setPoolSize(size);
+    m_manager.setIdleTimeout(idle_timeout);
+    m_manager.setMaxRequestsPerConnection(max_requests);
+  }
+
+  /**
+   * Change bounds of the I/O thread pool
+   * @param min_threads - number of workers that are always kept alive
+   * @param max_threads - maximal number of workers
+   */
+  void setThreadPoolBounds(std::size_t min_threads, std::size_t max_threads) {
+    io_pool.setBounds(min_threads, max_threads);
+  }
+
+  /**
+   * Run a callable on the I/O executor
+   * Use it to hand blocking API calls off the calling (handler) thread
+   * @param f - callable without arguments
+   * @return std::future with the result of the callable
+   */
+  template <class F>
+  auto execute(F &&f) -> std::future<std::invoke_result_t<F>> {
+    return io_pool.enqueue(std::forward<F>(f));
+  }
 
   /**
    * Overloaded function that accepts name of API method and QueryBuilder
@@ -162,24 +795,13 @@ public:
   template <class T>
   std::pair<T, std::optional<Error>> ApiCall(const char *api,
                                              const QueryBuilder &builder) {
-    utility::Logger::info(fmt::format("Calling {} with args: {}",api,builder.getQuery()));
-
-    std::shared_ptr<httplib::Response> reply =
-        m_manager.post(base_url + api, {}, builder.getQuery());
-
-    if (!reply) {
-      return {T{}, Error{static_cast<uint32_t>(ErrorCodes::UnableToMakeRequest),
-                      "Unable to make a request"}};
-    }
-    std::pair<T, std::optional<Error>> result;
+    const auto &url = methodUrl(api);
+    const Body body(builder);
+    utility::Logger::info("Calling ", api, " with args: ", body.view());
 
-    auto &&[is_valid, value] = parseWithError(reply->body);
-    if (is_valid) {
-      assignValue<T>(result.first, value);
-    } else {
-      result.second = Error{static_cast<int32_t>(reply->status), value};
-    }
-    return result;
+    return withRetries(api, destination(builder), [&] {
+      return readReply<T>(m_manager.post(url, {}, body.view()));
+    });
   }
   /**
    * Overloaded function that accepts name of API method and QueryBuilder
@@ -194,29 +816,13 @@ public:
   template <class T, class TrueOrType>
   std::pair<T, std::optional<Error>> ApiCall(const char *api,
                                              const QueryBuilder &builder) {
-      utility::Logger::info(fmt::format("Calling {} with args: {}",api,builder.getQuery()));
+      const auto &url = methodUrl(api);
+      const Body body(builder);
+      utility::Logger::info("Calling ", api, " with args: ", body.view());
 
-      auto reply = m_manager.post(base_url + api, {}, builder.getQuery());
-    if (!reply) {
-      return {T{}, Error{static_cast<uint32_t>(ErrorCodes::UnableToMakeRequest),
-                      "Unable to make a request"}};
-    }
-
-    std::pair<T, std::optional<Error>> result;
-
-    auto &&[is_valid, value] = parseWithError(reply->body);
-    if (is_valid) {
-      if (utility::lowercase_compare(value, utility::true_literal.data())) {
-        result.first = true;
-      } else if (utility::lowercase_compare(value, utility::false_literal.data())) {
-        result.first = false;
-      } else {
-        assignValue<T, TrueOrType>(result.first, value);
-      }
-    } else {
-      result.second = Error{static_cast<int32_t>(reply->status), value};
-    }
-    return result;
+      return withRetries(api, destination(builder), [&] {
+        return readReply<T, TrueOrType>(m_manager.post(url, {}, body.view()));
+      });
   }
   /**
    * @brief Call to Telegram bot API without arguments
@@ -226,105 +832,107 @@ public:
    */
   template <class T>
   std::pair<T, std::optional<Error>> ApiCall(const char *api) {
-    utility::Logger::info(fmt::format("Calling {} with no args",api));
-    auto reply = m_manager.post(base_url + api);
-
-    std::pair<T, std::optional<Error>> result;
-    if (!reply) {
-      return {T{}, Error{static_cast<uint32_t>(ErrorCodes::UnableToMakeRequest),
-                      "Unable to make a request"}};
-    }
-
-    auto &&[is_valid, value] = parseWithError(reply->body);
-    if (is_valid) {
-      assignValue<T>(result.first, value);
-    } else {
-      result.second = Error{static_cast<uint32_t>(ErrorCodes::InvalidReply),
-                        value};
-    }
-    return result;
+    utility::Logger::info("Calling ", api, " with no args");
+    const auto &url = methodUrl(api);
+    return withRetries(api, {}, [&] { return readReply<T>(m_manager.post(url)); });
   }
   /**
    * This overload is used to send multipart requests (e.g when it is neccessary to send some files)
    * @param api - Telegram Bot API method name
    * @param builder - QueryBuilder that contains data
-   * @param params - Container of paths to files (either absolute or relative)
+   * @param params - files to send (local files, bytes in memory or file_id/URL)
    * @return Pair of Error (if available) and value
    */
   template <class T>
   std::pair<T, std::optional<Error>>
   ApiCall(const char *api, QueryBuilder &builder,
-          const std::vector<name_value_pair> &params) {
-    utility::Logger::info(fmt::format("Calling {} with args: {} and files",api,builder.getQuery()));
-    std::pair<T, std::optional<Error>> result;
-    std::string reply;
-    int status_code = 0;
-
-    /// check if there is a valid path to local file
-    if (std::any_of(params.begin(), params.end(),
-                    [](const name_value_pair &value) {
-                      return fs::exists(fs::path(value.second));
-                    })) {
-      /// rewrite the doc to httplib multipart object type
-      std::vector<httplib::MultipartFormData> items;
-      const auto &build_doc = builder.getDocument().GetObject();
-      items.reserve(static_cast<size_t>(
-          std::distance(build_doc.begin(), build_doc.end())));
-
-      for (auto it = build_doc.begin(); it != build_doc.end(); ++it) {
-        if (it->value.IsInt() || it->value.IsInt64())
-          items.push_back(
-              {it->name.GetString(), std::to_string(it->value.GetInt64()), {}});
-        else if (it->value.IsBool())
-          items.push_back({it->name.GetString(),
-                           it->value.GetBool() ? utility::true_literal.data() :
-                                                 utility::false_literal.data(),
-                           {}});
-        else if (it->value.IsString())
-          items.push_back({it->name.GetString(), it->value.GetString()});
-      }
-
-      for (auto &&[name, path_or_id] : params) {
-        if (auto path = fs::path(path_or_id); fs::exists(path)) {
-            /// check if value is certificate or key file
-            /// telegram has additional requirements in that case (prepend '@' to filename)
-          if (path.filename().string().find(".pem") != std::string::npos)
-            items.push_back({"certificate",
-                             utility::fileBytes(fs::absolute(path).string()),
-                             '@' + path.string()});
-          else
-            items.push_back({name.data(),
-                             utility::fileBytes(fs::absolute(path).string()),
-                             path.filename().string()});
-        } else {
-          items.push_back({{name.data(), name.size()}, path_or_id});
-        }
-      }
-      auto response = m_manager.post(base_url + api, items);
-      reply = response->body;
-      status_code = response->status;
-    } else if (params.size()) {
-      for (auto &&it : params) {
-        builder << it;
-      }
-      auto response = m_manager.post(base_url + api, {}, builder.getQuery());
-      reply = response->body;
-      status_code = response->status;
-    } else {
-      result.second = Error{
-              static_cast<int32_t>(ErrorCodes::NotValid),
-          std::string("Id or filepath is not valid for at least one file at ") +
-              __func__};
-      return result;
-    }
+          const std::vector<name_file_pair> &params) {
+    return withRetries(api, destination(builder),
+                       [&] { return sendFiles<T>(api, builder, params); });
+  }
+  /**
+   * @brief Asynchronous version of ApiCall that does not block the calling thread
+   * If TrueOrType is not void, reply can be either True or value of TrueOrType
+   * @param api - Telegram Bot Api method name
+   * @param builder - QueryBuilder that contains data
+   * @return ApiFuture that receives pair of Error (if available) and value
+   */
+  template <class T, class TrueOrType = void>
+  ApiFuture<std::pair<T, std::optional<Error>>> ApiCallAsync(const char *api,
+                                                             const QueryBuilder &builder) {
+    auto query = builder.getQuery();
+    utility::Logger::info("Calling ", api, " asynchronously with args: ", query);
+    return postAsync<T, TrueOrType>(api, destination(builder), std::move(query));
+  }
+  /**
+   * @brief Call with arguments that are partially serialized beforehand (see PreparedCall)
+   * @param api - Telegram Bot Api method name
+   * @param members - serialized arguments that are the same for each call
+   * @param prepared - receiver of the call if it is set by 'members'
+   * @param builder - the rest of the arguments
+   * @return Pair of Error (if available) and value
+   */
+  template <class T, class TrueOrType = void>
+  std::pair<T, std::optional<Error>> ApiCall(const char *api, std::string_view members,
+                                             const RateLimiter::Destination &prepared,
+                                             const QueryBuilder &builder) {
+    const auto &url = methodUrl(api);
+    const Body body(builder, members);
+    utility::Logger::info("Calling ", api, " with args: ", body.view());
 
-    auto &&[is_valid, value] = parseWithError(reply);
-    if (is_valid) {
-      assignValue<T>(result.first, value);
-    } else {
-      result.second = Error{static_cast<int32_t>(status_code), value};
-    }
-    return result;
+    return withRetries(api, destination(builder, prepared), [&] {
+      return readReply<T, TrueOrType>(m_manager.post(url, {}, body.view()));
+    });
+  }
+  /**
+   * @brief Asynchronous version of ApiCall with prepared arguments
+   * @return ApiFuture that receives pair of Error (if available) and value
+   */
+  template <class T, class TrueOrType = void>
+  ApiFuture<std::pair<T, std::optional<Error>>>
+  ApiCallAsync(const char *api, std::string_view members, const RateLimiter::Destination &prepared,
+               const QueryBuilder &builder) {
+    std::string query;
+    builder.getQuery(query, members);
+    utility::Logger::info("Calling ", api, " asynchronously with args: ", query);
+    return postAsync<T, TrueOrType>(api, destination(builder, prepared), std::move(query));
+  }
+  /**
+   * @brief Asynchronous version of ApiCall without arguments
+   * @param api - Telegram Bot Api method name
+   * @return ApiFuture that receives pair of Error (if available) and value
+   */
+  template <class T>
+  ApiFuture<std::pair<T, std::optional<Error>>> ApiCallAsync(const char *api) {
+    utility::Logger::info("Calling ", api, " asynchronously with no args");
+    return postAsync<T, void>(api, {}, "{}");
+  }
+  /**
+   * @brief Asynchronous version of ApiCall that sends files
+   * Multipart requests are made with blocking connections, so the call runs on the I/O executor
+   * @param api - Telegram Bot API method name
+   * @param builder - QueryBuilder that contains data
+   * @param params - files to send (local files, bytes in memory or file_id/URL)
+   * @return ApiFuture that receives pair of Error (if available) and value
+   */
+  template <class T>
+  ApiFuture<std::pair<T, std::optional<Error>>>
+  ApiCallAsync(const char *api, QueryBuilder &&builder, std::vector<name_file_pair> &&params) {
+    using Result = std::pair<T, std::optional<Error>>;
+    ApiPromise<Result> promise;
+    auto call_destination = destination(builder);
+    // the request must be copyable, builder is not
+    auto data = std::make_shared<std::pair<QueryBuilder, std::vector<name_file_pair>>>(
+        std::move(builder), std::move(params));
+    withRetriesAsync(api, call_destination,
+                     [this, api, data](std::function<void(Result)> done) {
+                       io_pool.enqueue([this, api, data, done] {
+                         utility::ThreadPool::BlockingScope blocking;
+                         done(sendFiles<T>(api, data->first, data->second));
+                       });
+                     },
+                     promise);
+    return promise.getFuture();
   }
   /**
    * This function calls Telegram Bot Api and returns result with no processing made
@@ -333,7 +941,29 @@ public:
    * @return std::string containing HTTP response body
    */
   std::string ApiCallRaw(const char *api, const QueryBuilder &builder) {
-    return m_manager.post(base_url + api, {}, builder.getQuery())->body;
+    limiter.acquire(destination(builder));
+    const Body body(builder);
+    auto reply = m_manager.post(methodUrl(api), {}, body.view());
+    return reply ? reply->body : std::string{};
+  }
+  /**
+   * This function makes long polling request and returns result with no processing made
+   * Request is made with a dedicated connection, so its read timeout does not affect other calls
+   * \warning must not be called concurrently
+   * @param api - Telegram Bot API method name
+   * @param builder - QueryBuilder that contains data
+   * @param read_timeout - timeout of waiting for response, must be longer than polling timeout
+   * @return std::string containing HTTP response body, empty if request failed
+   */
+  std::string ApiCallRaw(const char *api, const QueryBuilder &builder,
+                         std::chrono::seconds read_timeout) {
+    if (read_timeout != poll_read_timeout) {
+      m_poll_manager.setReadTimeout(read_timeout);
+      poll_read_timeout = read_timeout;
+    }
+    const Body body(builder);
+    auto reply = m_poll_manager.post(methodUrl(api), {}, body.view());
+    return reply ? reply->body : std::string{};
   }
 };
 } // namespace telegram
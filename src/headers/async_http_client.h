@@ -0,0 +1,66 @@
+#pragma once
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "httplib/httplib.h"
+
+namespace telegram {
+/**
+ * @brief Non-blocking HTTP/1.1 client driven by an event loop (epoll)
+ *
+ * All requests are multiplexed by one loop thread, so the number of requests in flight \n
+ * does not depend on the number of threads. Connections are kept alive and reused per host, \n
+ * HTTPS is supported when the library is built with OpenSSL (CPPHTTPLIB_OPENSSL_SUPPORT), \n
+ * plain HTTP can be sent over unix domain sockets. \n
+ * Completion callbacks are called on the loop thread and must not block. \n
+ * Available on Linux only, see AsyncHttpClient::supported
+ */
+class AsyncHttpClient {
+public:
+    /// receives response, or nullptr if the request failed
+    using Callback = std::function<void(std::shared_ptr<httplib::Response>)>;
+
+    /// \throws std::runtime_error if event loop can not be created
+    AsyncHttpClient();
+    ~AsyncHttpClient();
+    AsyncHttpClient(const AsyncHttpClient &) = delete;
+    AsyncHttpClient &operator=(const AsyncHttpClient &) = delete;
+
+    /// check if the client is available on this platform
+    static bool supported() noexcept;
+    /**
+     * @brief Send POST request
+     * @param url - absolute url (e.g https://api.telegram.org/bot<token>/getMe), servers on
+     * unix domain sockets are addressed as http+unix://<percent-encoded socket path>/<path>
+     * @param headers - additional headers
+     * @param body - body of the request, it is copied into the request before returning
+     * @param content_type - 'Content-Type' header of the request
+     * @param callback - called with the response on the loop thread
+     */
+    void post(const std::string &url, const httplib::Headers &headers, std::string_view body,
+              std::string_view content_type, Callback callback);
+    /**
+     * @brief Send POST request
+     * @return future that receives response, or nullptr if the request failed
+     */
+    std::future<std::shared_ptr<httplib::Response>>
+    post(const std::string &url, const httplib::Headers &headers, std::string_view body,
+         std::string_view content_type);
+    /// set maximal number of connections to one host, requests above it are queued
+    void setMaxConnectionsPerHost(std::size_t count);
+    /// set time limit of one request (from sending to receiving the whole response)
+    void setTimeout(std::chrono::seconds timeout);
+    /// close kept alive connections that were not used for 'timeout' (60 seconds by default)
+    void setIdleTimeout(std::chrono::seconds timeout);
+    /// close connection after it served 'count' requests (not limited by default)
+    void setMaxRequestsPerConnection(std::size_t count);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+} // namespace telegram
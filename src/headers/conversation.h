@@ -0,0 +1,117 @@
+#pragma once
+/**
+ * Coroutine conversations (requires C++20)
+ *
+ * Conversation is a coroutine that can suspend until the next update from the same user:
+ *
+ * Conversation registration(Bot& bot, int64_t user_id) {
+ *     bot.sendMessage(user_id, "Send your username");
+ *     Message name = co_await nextUpdate<MessageCallback>(bot, user_id);
+ *     bot.sendMessage(user_id, "Send your password");
+ *     Message password = co_await nextUpdate<MessageCallback>(bot, user_id);
+ *     ...
+ * }
+ *
+ * bot.onMessage("/register", [&](const Message& m){ registration(bot, m.from->id); });
+ *
+ * The frame is resumed on the handler thread pool when a matching update arrives,
+ * so only the suspended frame is kept per user.
+ *
+ * API calls can be awaited as well, so a conversation does not hold a thread while
+ * a request is in flight:
+ *
+ * auto [sent, error] = co_await bot.sendMessageAsync(user_id, "Send your username");
+ *
+ * The frame is resumed on the I/O executor when the reply is parsed (see ApiFuture).
+ */
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <memory>
+#include <optional>
+
+#include "telegram_bot.h"
+
+namespace telegram {
+
+/**
+ * @brief Return type of conversation coroutines
+ * Conversation starts immediately and destroys itself when finished
+ */
+class Conversation {
+public:
+    struct promise_type {
+        Conversation get_return_object() noexcept {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+        void return_void() noexcept {
+        }
+        void unhandled_exception() noexcept {
+            utility::Logger::critical("Unhandled exception in conversation");
+        }
+    };
+};
+
+/**
+ * @brief Awaitable that suspends a coroutine until the next update of CallbackType kind
+ * from the user. If the wait is cancelled (Bot::cancelNextUpdate or another
+ * awaiter for the same user) the suspended frame is destroyed.
+ * Router is Bot or other type with the same onNextUpdate member
+ */
+template <class CallbackType, class Router = Bot>
+class NextUpdate {
+    using Arg = typename traits::func_signature<CallbackType>::args_type;
+
+    /// destroys the frame if it was never resumed
+    struct FrameGuard {
+        std::coroutine_handle<> handle;
+        bool resumed = false;
+        ~FrameGuard() {
+            if (!resumed)
+                handle.destroy();
+        }
+    };
+
+    Router &bot;
+    int64_t id;
+    std::optional<Arg> value;
+
+public:
+    NextUpdate(Router &bot, int64_t id) : bot{bot}, id{id} {
+    }
+    bool await_ready() const noexcept {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+        auto guard = std::make_shared<FrameGuard>();
+        guard->handle = handle;
+        // the awaiter must not be touched after registration,
+        // the frame may already be resumed on another thread
+        bot.template onNextUpdate<CallbackType>(id, [this, guard](Arg &&arg) {
+            value.emplace(std::move(arg));
+            guard->resumed = true;
+            guard->handle.resume();
+        });
+    }
+    Arg await_resume() {
+        return std::move(value.value());
+    }
+};
+
+/**
+ * @brief Suspend conversation until the next update of CallbackType kind from 'id'
+ * @param bot - bot that routes updates
+ * @param id - user id
+ */
+template <class CallbackType, class Router>
+NextUpdate<CallbackType, Router> nextUpdate(Router &bot, int64_t id) {
+    return {bot, id};
+}
+
+} // namespace telegram
+#endif
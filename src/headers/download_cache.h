@@ -0,0 +1,135 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "utility/utility.h"
+
+namespace telegram {
+/**
+ * @brief Size bounded directory of downloaded files
+ *
+ * Files are stored by a key that identifies their contents (file_unique_id), so a file \n
+ * is downloaded once however many file_ids refer to it. Incomplete downloads are kept \n
+ * next to complete files with '.part' extension, so they can be resumed (even after a \n
+ * restart). When the total size exceeds the capacity the least recently used files are \n
+ * removed, except the files that are in use (see DownloadCache::Lease).
+ */
+class DownloadCache {
+public:
+    /// keeps a complete file in the cache while it is alive
+    using Lease = std::shared_ptr<const fs::path>;
+    static constexpr std::uintmax_t default_capacity = 256 * 1024 * 1024;
+
+    /**
+     * @param directory - directory of files, it is created when the first file is stored
+     * ('tgbot_files-<user id>' in the temporary directory if empty, it is created accessible
+     * by the user only and is not used if it belongs to someone else)
+     * @param capacity - maximal total size of files in bytes
+     */
+    explicit DownloadCache(fs::path directory = {}, std::uintmax_t capacity = default_capacity);
+    DownloadCache(const DownloadCache &) = delete;
+    DownloadCache &operator=(const DownloadCache &) = delete;
+
+    /**
+     * @brief Change the directory and the capacity
+     * Files stored in the previous directory are left there, 0 capacity keeps files only
+     * while they are in use
+     */
+    void configure(fs::path directory, std::uintmax_t capacity);
+    /// get a complete file
+    Lease find(const std::string &key);
+    /// path of an incomplete file, its size is the number of downloaded bytes, empty if
+    /// the directory can not be used
+    fs::path partial(const std::string &key);
+    /**
+     * @brief Move complete file from 'partial' path to the cache
+     * @return the file, nullptr if it can not be moved
+     */
+    Lease commit(const std::string &key);
+    /// total size of complete files
+    std::uintmax_t size() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+    struct Entry {
+        std::uintmax_t size = 0;
+        clock::time_point used;
+        /// number of leases
+        std::size_t readers = 0;
+    };
+
+    // require 'mutex' to be locked
+    void load();
+    Lease lease(const std::string &key, Entry &entry);
+    void evict();
+    fs::path location(const std::string &key) const;
+    static fs::path defaultDirectory();
+    /// create the default directory, check that nobody else can access it
+    static bool makePrivateDirectory(const fs::path &path);
+    void release(const std::string &key, std::size_t generation);
+
+    fs::path directory;
+    std::uintmax_t capacity;
+    std::unordered_map<std::string, Entry> entries;
+    std::uintmax_t total = 0;
+    bool loaded = false;
+    /// the default directory is shared by users of the system, it is checked when loaded
+    bool private_directory = false;
+    /// false if the default directory belongs to someone else
+    bool usable = true;
+    /// changed by configure, so leases of the previous directory are not counted
+    std::size_t generation = 0;
+    mutable std::mutex mutex;
+    /// leases outliving the cache do not release entries
+    std::shared_ptr<DownloadCache *> self = std::make_shared<DownloadCache *>(this);
+};
+
+/**
+ * @brief Read-only view of a file mapped into memory
+ * Platforms without mmap read the file into memory instead
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    /// map 'file', the lease is kept so the file is not evicted from the cache
+    explicit MappedFile(DownloadCache::Lease file);
+    ~MappedFile();
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /// check if the file is mapped
+    bool valid() const noexcept {
+        return lease != nullptr;
+    }
+    const char *data() const noexcept {
+        return bytes;
+    }
+    std::size_t size() const noexcept {
+        return length;
+    }
+    std::string_view view() const noexcept {
+        return {bytes, length};
+    }
+    /// path of the file in the cache
+    const fs::path &path() const {
+        return *lease;
+    }
+
+private:
+    void unmap() noexcept;
+
+    DownloadCache::Lease lease;
+    const char *bytes = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    std::string contents;
+#endif
+};
+} // namespace telegram
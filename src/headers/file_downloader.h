@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "download_cache.h"
+#include "networkmanager.h"
+
+namespace telegram {
+/**
+ * @brief Downloads files from Telegram file storage into DownloadCache
+ *
+ * A file is written to the cache by chunks as it is received, so it is never kept in \n
+ * memory. A broken download is resumed with 'Range' request from the received size. \n
+ * Concurrent requests of the same file wait for one download. \n
+ * Downloads use their own connections, so they do not hold connections of API calls. \n
+ * Files of a server in local mode are read from its disk, they are not copied to the cache.
+ */
+class FileDownloader {
+public:
+    /// the file in the cache, or error (HTTP status or ErrorCodes value) if 'file' is nullptr
+    struct Result {
+        DownloadCache::Lease file;
+        int32_t error_code = 0;
+        std::string description;
+    };
+    /// number of requests made without progress before the download fails
+    static constexpr int max_attempts = 3;
+
+    /// @param url - prefix of file urls, https://api.telegram.org/file/bot<token>/
+    explicit FileDownloader(std::string url);
+
+    /**
+     * @brief Get a file into the cache
+     * @param key - identity of file contents (file_unique_id)
+     * @param path - file_path returned by getFile
+     * @param size - size of the file if known, used to check that the file is complete
+     */
+    Result fetch(const std::string &key, const std::string &path, std::optional<int64_t> size);
+    DownloadCache &cache() noexcept {
+        return files;
+    }
+    /**
+     * @brief Download files from 'server' instead of the public server
+     * \warning must not be changed while downloads are in progress
+     * @param file_url - prefix of file urls on the server
+     * @return false if the server can not be used
+     */
+    bool setServer(const ApiServer &server, std::string file_url);
+
+private:
+    Result download(const std::string &key, const std::string &path, std::optional<int64_t> size);
+
+    std::string url;
+    NetworkManager network{"api.telegram.org"};
+    DownloadCache files;
+    /// the server runs with '--local', file paths are paths on its disk
+    bool local = false;
+    std::mutex mutex;
+    /// downloads in progress by key
+    std::unordered_map<std::string, std::shared_future<Result>> in_flight;
+};
+} // namespace telegram
@@ -0,0 +1,73 @@
+#pragma once
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "utility/utility.h"
+
+namespace telegram {
+/**
+ * @brief Cache of file_id of uploaded local files
+ *
+ * When a local file is uploaded Telegram returns file_id, that can be sent instead of \n
+ * the file afterwards. The cache maps a file (its absolute path, size and modification \n
+ * time, so a changed file is uploaded again) to the returned file_id. \n
+ * Least recently used entries are evicted above the capacity. \n
+ * With an index file the cache is kept across restarts: entries are appended to the \n
+ * index when they are added, it is compacted when it grows twice as large as the cache. \n
+ * file_id is valid only for the bot that received it, so the index belongs to one bot.
+ */
+class FileIdCache {
+public:
+    static constexpr std::size_t default_capacity = 100000;
+
+    explicit FileIdCache(std::size_t capacity = default_capacity);
+    FileIdCache(const FileIdCache &) = delete;
+    FileIdCache &operator=(const FileIdCache &) = delete;
+
+    /**
+     * @brief Keep the cache in 'index' file and load entries stored there
+     * @param index - path to the index, it is created if it does not exist
+     * @param owner - identifier of the bot, an index of another bot is discarded
+     * @return false if the index can not be written, the cache is kept in memory then
+     */
+    bool setIndex(const fs::path &index, const std::string &owner);
+    /// set maximal number of entries, 0 disables the cache
+    void setCapacity(std::size_t capacity);
+    /// get file_id of the file if it was uploaded and has not changed since
+    std::optional<std::string> find(const fs::path &file);
+    /// remember file_id of an uploaded file
+    void insert(const fs::path &file, const std::string &file_id);
+    /// forget the file (e.g its file_id was rejected)
+    void erase(const fs::path &file);
+    std::size_t size() const;
+
+private:
+    using Entry = std::pair<std::string, std::string>;
+    /// key of the file, empty if the file does not exist or can not be used as a key
+    static std::optional<std::string> key(const fs::path &file);
+
+    // require 'mutex' to be locked
+    void put(const std::string &key, const std::string &file_id);
+    void remove(const std::string &key);
+    void trim();
+    /// write a line of the index, empty file_id marks a removed entry
+    void log(const std::string &key, const std::string &file_id);
+    /// rewrite the index with current entries only
+    void compact();
+
+    std::size_t capacity;
+    /// the most recently used entries are in front
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> positions;
+    fs::path index_path;
+    std::string owner;
+    std::ofstream index;
+    /// number of lines in the index
+    std::size_t logged = 0;
+    mutable std::mutex mutex;
+};
+} // namespace telegram
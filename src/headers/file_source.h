@@ -0,0 +1,118 @@
+#pragma once
+#include <cctype>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "utility/utility.h"
+
+namespace telegram {
+/**
+ * @brief Value of a file parameter of API methods (e.g 'photo' of Bot::sendPhoto)
+ *
+ * A file is either a local file, bytes in memory or a file known to Telegram \n
+ * (file_id or HTTP URL). Local files and bytes are uploaded with multipart request, \n
+ * file_id and URL are sent as strings. The kind is known without access to the \n
+ * filesystem. \n
+ * FileSource is implicitly constructible from strings, so paths and file_ids can be \n
+ * passed directly: a string with "://" is an URL, a string of letters, digits, '-' and \n
+ * '_' is a file_id, any other string is a path. Use FileSource::fromPath for a path \n
+ * that looks like a file_id (e.g "photo" without an extension)
+ */
+class FileSource {
+public:
+    enum class Kind {
+        /// local file, uploaded
+        Path,
+        /// bytes in memory, uploaded
+        Memory,
+        /// file_id or URL, sent as is
+        Remote
+    };
+
+    FileSource(std::string value)
+        : file_kind{looksRemote(value) ? Kind::Remote : Kind::Path}, location{std::move(value)} {}
+    FileSource(const char *value) : FileSource(std::string(value)) {}
+    FileSource(const fs::path &path) : file_kind{Kind::Path}, location{path.string()} {}
+
+    static FileSource fromPath(fs::path path) {
+        return FileSource(Kind::Path, path.string());
+    }
+    /// file_id of a file stored by Telegram or HTTP URL of a file
+    static FileSource fromId(std::string id) {
+        return FileSource(Kind::Remote, std::move(id));
+    }
+    /**
+     * @brief Upload bytes from memory without copying them
+     * \warning the bytes must stay valid until the call is completed
+     * (for asynchronous calls until the future is ready)
+     * @param filename - name of the file reported to Telegram, its extension matters for documents
+     */
+    static FileSource fromMemory(const void *data, std::size_t size, std::string filename) {
+        FileSource source(Kind::Memory, std::move(filename));
+        source.bytes = static_cast<const char *>(data);
+        source.length = size;
+        return source;
+    }
+    /// Upload bytes from memory, the bytes are owned by the source (moved, not copied)
+    static FileSource fromMemory(std::string bytes, std::string filename) {
+        auto owned = std::make_shared<const std::string>(std::move(bytes));
+        auto source = fromMemory(owned->data(), owned->size(), std::move(filename));
+        source.owner = std::move(owned);
+        return source;
+    }
+
+    Kind kind() const noexcept {
+        return file_kind;
+    }
+    /// check if the file is uploaded (local file or bytes)
+    bool uploaded() const noexcept {
+        return file_kind != Kind::Remote;
+    }
+    /// path of a local file
+    fs::path path() const {
+        return location;
+    }
+    /// file_id or URL of a remote file
+    const std::string &id() const noexcept {
+        return location;
+    }
+    /// name of the uploaded file
+    std::string filename() const {
+        return file_kind == Kind::Memory ? location : fs::path(location).filename().string();
+    }
+    /// bytes of a file in memory
+    const char *data() const noexcept {
+        return bytes;
+    }
+    std::size_t size() const noexcept {
+        return length;
+    }
+
+private:
+    FileSource(Kind kind, std::string location) : file_kind{kind}, location{std::move(location)} {}
+
+    static bool looksRemote(std::string_view value) noexcept {
+        if (value.find("://") != std::string_view::npos)
+            return true;
+        if (value.empty())
+            return false;
+        for (char c : value) {
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_')
+                return false;
+        }
+        return true;
+    }
+
+    Kind file_kind;
+    /// path, file_id or URL, filename of bytes in memory
+    std::string location;
+    const char *bytes = nullptr;
+    std::size_t length = 0;
+    /// keeps owned bytes alive
+    std::shared_ptr<const std::string> owner;
+};
+
+/// name of a file parameter and its value
+using name_file_pair = std::pair<std::string_view, FileSource>;
+} // namespace telegram
@@ -63,15 +63,26 @@ public:
                                                    traits::is_parsable_v<T>>>
     T fromJson(const std::string &data) const  {
       rapidjson::Document doc;
-      rapidjson::Value val;
       rapidjson::ParseResult ok = doc.Parse(data.data());
       if (!ok) {
         utility::Logger::warn("Invalid json;");
         return T{};
       }
+      return fromJson<T>(doc);
+    }
+    /**
+     * @brief Deserialize value from parsed JSON
+     * \return object of class T, default constructed if 'doc' is not an object (array for containers)
+     * @param doc - document containing data named as T fields, its values are moved from
+     */
+    template <class T, typename = std::enable_if_t<traits::is_container_v<T> ||
+                                                   traits::is_parsable_v<T>>>
+    T fromJson(rapidjson::Document &doc) const  {
       T item{};
       // if value is array
       if constexpr (traits::is_container_v<T> && !traits::is_string_type<T>) {
+        if (!doc.IsArray())
+          return item;
         auto temp_arr = doc.GetArray();
         arrayToJson(item, temp_arr, doc.GetAllocator());
       } else if constexpr (traits::is_parsable_v<T>) {
@@ -80,6 +91,8 @@ public:
 #else
         static_assert(boost::pfr::tuple_size_v<T>> 0, "The struct has no fields");
 #endif
+        if (!doc.IsObject())
+          return item;
         launchParser(item, doc,
                     std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
       }
@@ -359,11 +372,9 @@ private:
                           allocator);
           }
           if constexpr (traits::is_optional_v<T>) {
-            array.value().emplace_back(
-                fromJson<typename type::value_type>(JsonParser::i().rapidObjectToJson(doc)));
+            array.value().emplace_back(fromJson<typename type::value_type>(doc));
           } else {
-            array.emplace_back(
-                fromJson<typename type::value_type>(JsonParser::i().rapidObjectToJson(doc)));
+            array.emplace_back(fromJson<typename type::value_type>(doc));
           }
         }
         // recursive case
@@ -410,7 +421,7 @@ private:
           subdoc.AddMember(it->name.Move(), it->value.Move(),
                            subdoc.GetAllocator());
         }
-        field = fromJson<field_type>(JsonParser::i().rapidObjectToJson(subdoc));
+        field = fromJson<field_type>(subdoc);
       } else if constexpr (traits::is_container_v<field_type>) {
         auto arr = val.GetArray();
         arrayToJson(field, arr, doc.GetAllocator());
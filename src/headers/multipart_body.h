@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utility/utility.h"
+
+namespace telegram {
+/**
+ * @brief multipart/form-data body that is streamed to the connection
+ *
+ * Only part headers are kept in memory, contents of files are read from disk in chunks \n
+ * while the request is written (see NetworkManager::post), so memory used by an upload \n
+ * does not depend on the size of files. Parts in memory are written without copying. \n
+ * The body can be written several times (e.g when the request is redirected or repeated).
+ */
+class MultipartBody {
+public:
+    /// receives a piece of the body, data is valid during the call only
+    using Writer = std::function<void(const char *data, std::size_t size)>;
+    /// maximal size of a piece passed to Writer
+    static constexpr std::size_t chunk_size = 64 * 1024;
+
+    MultipartBody();
+    MultipartBody(const MultipartBody &) = delete;
+    MultipartBody &operator=(const MultipartBody &) = delete;
+
+    /// add text field
+    void addField(std::string_view name, std::string_view value);
+    /**
+     * @brief Add file field, the file is read when the body is written
+     * @param name - name of the field
+     * @param path - path to local file
+     * @param filename - name of the file reported to the server
+     * @return false if size of the file can not be obtained
+     */
+    bool addFile(std::string_view name, const fs::path &path, std::string_view filename);
+    /// Add file field of a file whose size is already known (e.g obtained in parallel)
+    void addFile(std::string_view name, const fs::path &path, std::uintmax_t size,
+                 std::string_view filename);
+    /**
+     * @brief Add file field with contents in memory, the bytes are not copied
+     * \warning the bytes must stay valid while the body is written
+     */
+    void addMemory(std::string_view name, const char *data, std::size_t size,
+                   std::string_view filename);
+    /// value of 'Content-Type' header, includes the boundary
+    std::string contentType() const;
+    /// size of the whole body in bytes
+    std::size_t size() const;
+    /**
+     * @brief Write the next piece of the body that starts at 'offset'
+     * \description If a file can not be read (e.g it was truncated after it was added)
+     * the rest of it is written as zeros, so the body keeps its size, and the body is
+     * marked as failed
+     * @return number of written bytes, 0 if offset is out of the body
+     */
+    std::size_t read(std::size_t offset, const Writer &write);
+    /// check if a file could not be read while the body was written
+    bool failed() const noexcept {
+        return read_failed;
+    }
+
+private:
+    /// text of part headers, contents of a file or bytes in memory
+    struct Segment {
+        std::string text;
+        fs::path file;
+        /// bytes of the segment if they are not owned
+        const char *data = nullptr;
+        std::size_t size = 0;
+        /// position of the segment in the body
+        std::size_t offset = 0;
+    };
+    static constexpr std::size_t no_segment = std::numeric_limits<std::size_t>::max();
+
+    void append(std::string_view text);
+    void appendBoundary();
+    void appendFileHeader(std::string_view name, std::string_view filename);
+    std::string closing() const;
+    std::size_t readFile(std::size_t index, std::size_t position, const Writer &write);
+
+    std::string boundary;
+    std::vector<Segment> segments;
+    std::size_t total = 0;
+    /// file that is being read, it is kept open while the body is written sequentially
+    std::ifstream stream;
+    std::size_t stream_segment = no_segment;
+    std::size_t stream_position = 0;
+    std::vector<char> buffer;
+    bool read_failed = false;
+};
+} // namespace telegram
@@ -1,15 +1,96 @@
 #pragma once
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "httplib/httplib.h"
+#include "async_http_client.h"
+#include "multipart_body.h"
+#include "utility/shared_pool.h"
 #include "utility/utility.h"
 
 namespace telegram {
+/**
+ * @brief Telegram Bot API server the bot talks to (see Bot::setApiServer)
+ * The default is the public server, a self-hosted server is telegram-bot-api
+ */
+struct ApiServer {
+  /// scheme, host and port of the server, e.g 'http://localhost:8081'
+  std::string url = "https://api.telegram.org";
+  /// unix domain socket the server listens on, requests are sent to it instead of 'url'
+  std::string unix_socket;
+  /**
+   * The server runs with '--local' option: local files are sent as file:// paths
+   * instead of being uploaded and downloaded files are read from the server's disk
+   */
+  bool local = false;
+};
+
 /**
  * @brief Class for making HTTP requests
+ *
+ * Requests with a body are sent with event loop transport (AsyncHttpClient) where it is \n
+ * available, it is enabled by the constructor. Its connections are kept alive between \n
+ * requests and closed after 'idle_timeout' of inactivity or after 'max_requests' requests. \n
+ * Multipart requests, downloads and requests on other platforms are made with a pool of \n
+ * blocking clients: every call checks out a client for exclusive use and returns it \n
+ * afterwards, so concurrent calls neither race on one client nor wait for each other \n
+ * while there are free clients. \n
+ * \warning httplib 0.5.7 opens a new socket for every request of a blocking client, \n
+ * so the pool bounds concurrency but does not keep TCP/TLS sessions open
  */
 class NetworkManager {
-  httplib::Client cli;
+  struct Connection {
+    std::unique_ptr<httplib::Client> client;
+  };
+  /// returns checked out connection to the pool on destruction
+  class Lease;
+  /// server set with setServer
+  struct Origin {
+    bool tls = false;
+    std::string host;
+    int port = 80;
+    std::string unix_socket;
+    /// 'scheme://authority' part of urls of the server
+    std::string prefix;
+  };
+
+  std::string host;
+  std::optional<Origin> origin;
+  std::mutex pool_mutex;
+  std::condition_variable pool_condition;
+  /// blocking clients that are not checked out
+  std::vector<std::unique_ptr<Connection>> idle;
+  /// number of blocking clients (both idle and checked out)
+  std::size_t open = 0;
+  std::size_t max_connections = 16;
+  /// limits of kept alive connections of event loop transport
+  std::chrono::seconds idle_timeout{60};
+  std::size_t max_requests = 1000;
+  std::chrono::seconds read_timeout{0};
+  /// non-blocking transport, used instead of the pool when set
+  std::unique_ptr<AsyncHttpClient> async_client;
+  /// responses of requests made with blocking clients, see NetworkManager::post
+  utility::SharedPool<httplib::Response> responses;
+
+  Lease checkout();
+  void release(std::unique_ptr<Connection> connection);
+  std::unique_ptr<Connection> connect();
+  std::string absoluteUrl(const std::string &url) const;
+  /**
+   * Path of 'url' on the server set with setServer, requests to it are made with paths
+   * The result is a suffix of 'url', so it is null-terminated
+   */
+  std::string_view target(const std::string &url) const;
+  /// check if requests that need blocking clients can be made, logs the refused 'url'
+  bool blockingSupported(const std::string &url) const;
+  /// parse 'server', empty if it is not valid or can not be reached on this platform
+  static std::optional<Origin> parseServer(const ApiServer &server);
   /// http return code groups
   enum class http {
     informational = 100,
@@ -20,6 +101,7 @@ class NetworkManager {
   };
 public:
   NetworkManager(const char *host);
+  ~NetworkManager();
   NetworkManager(const NetworkManager &) = delete;
   NetworkManager(NetworkManager &&) = delete;
   NetworkManager &operator=(const NetworkManager &) = delete;
@@ -30,8 +112,56 @@ public:
    * \return 32-bit integet representing IP address
    */
   static uint32_t ipv4(const std::string& s);
+  /**
+   * @brief Set timeout of waiting for response data
+   * Must be longer than the timeout of long polling requests made with this manager
+   * @param timeout - read timeout
+   */
+  void setReadTimeout(std::chrono::seconds timeout);
+  /**
+   * @brief Set maximal number of connections
+   * Requests wait for a free connection when every connection is in use
+   */
+  void setPoolSize(std::size_t size);
+  /// close kept alive connections that were not used for 'timeout'
+  void setIdleTimeout(std::chrono::seconds timeout);
+  /// close kept alive connection after it served 'count' requests
+  void setMaxRequestsPerConnection(std::size_t count);
+  /**
+   * @brief Use event loop transport (AsyncHttpClient) instead of blocking clients
+   * Requests with a body are multiplexed by one loop thread over kept alive connections,
+   * multipart requests still use blocking clients. Enabled by default where available
+   * \warning must not be changed while requests are in flight
+   * @return true if the backend is available on this platform
+   */
+  bool setEventLoopBackend(bool enable);
+  /**
+   * @brief Send requests to 'server' instead of the host passed to the constructor
+   * Servers on unix domain sockets are reached with event loop transport, so only
+   * requests with a body (not multipart requests nor downloads) can be made to them
+   * \warning must not be changed while requests are in flight
+   * @return false if the server is not valid or can not be reached on this platform
+   */
+  bool setServer(const ApiServer &server);
+  /// check if setServer would accept 'server', nothing is changed
+  static bool supports(const ApiServer &server);
+  /// check if multipart requests and downloads can be made, they can not over unix socket
+  bool blockingSupported() const noexcept;
+  /// check if requests are made with event loop transport
+  bool usesEventLoop() const noexcept {
+    return async_client != nullptr;
+  }
+  /**
+   * @brief Usual POST request that does not block the calling thread
+   * With blocking backend the request is made on the calling thread
+   * @param callback - receives response, or nullptr if the request failed
+   */
+  void postAsync(const std::string &url, const httplib::Headers &headers, std::string_view body,
+                 std::string_view content_type, AsyncHttpClient::Callback callback);
   /**
     * @brief Usual POST request
+    * The request is built in memory of the calling thread and the response is taken from
+    * a pool, so both are reused by the next requests
     * @param url - url for POST request
     * @param headers - headers of POST request
     * @param body - body of POST request (empty json object by default)
@@ -39,16 +169,28 @@ public:
     */
   std::shared_ptr<httplib::Response>
   post(const std::string &url, const httplib::Headers &headers = {},
-       const std::string &body = "{}",
-       const std::string &content_type =
-           utility::toString(ContentTypes::application_json).data());
+       std::string_view body = "{}",
+       std::string_view content_type = utility::toString(ContentTypes::application_json));
   /**
     * @brief multipart/form POST requiest
+    * The body is streamed to the connection, files are not loaded into memory
     * @param url - url for POST request
-    * @param items - multipart data to be sent
+    * @param body - multipart data to be sent
+    * \return response, or nullptr if the request failed or a file could not be read
+    */
+  std::shared_ptr<httplib::Response>
+  post(const std::string &url, MultipartBody &body);
+  /**
+    * @brief GET request that passes the body to 'receiver' by chunks
+    * Used for downloads, the body is not kept in memory
+    * @param url - url for GET request
+    * @param headers - headers of GET request (e.g 'Range')
+    * @param receiver - gets chunks of the body, returns false to cancel the request
+    * \return response without the body, or nullptr if the request failed
     */
   std::shared_ptr<httplib::Response>
-  post(const std::string &url, const httplib::MultipartFormDataItems &items);
+  get(const std::string &url, const httplib::Headers &headers,
+      httplib::ContentReceiver receiver);
 };
 
 } // namespace telegram
@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "apimanager.h"
+
+namespace telegram {
+/**
+ * @brief Call of Telegram Bot Api method with arguments that are the same for every call
+ *
+ * Constant arguments (e.g a keyboard attached to most replies) are serialized once \n
+ * when the call is prepared, each call serializes only its own arguments and the \n
+ * prepared JSON is appended to them. Made with Bot::prepare
+ * \warning arguments of a call must not repeat prepared arguments, \n
+ * the call must not outlive the bot it was prepared by
+ */
+template <class T, class TrueOrType = void>
+class PreparedCall {
+public:
+  using Result = std::pair<T, std::optional<Error>>;
+
+  /**
+   * @param api - manager that makes calls
+   * @param method - Telegram Bot Api method name, must stay valid (e.g string literal)
+   * @param constant - arguments that are sent with every call
+   */
+  PreparedCall(ApiManager &api, const char *method, const QueryBuilder &constant)
+      : api{&api}, method{method}, members{constant.getMembers()},
+        destination{ApiManager::destination(constant)} {
+  }
+  /// make the call with 'arguments' and prepared arguments
+  Result operator()(const QueryBuilder &arguments) const {
+    return api->template ApiCall<T, TrueOrType>(method, members, destination, arguments);
+  }
+  /// make the call with arguments made with 'make_named_pair' and prepared arguments
+  template <class... Args>
+  Result operator()(const std::pair<std::string_view, Args> &... arguments) const {
+    QueryBuilder builder;
+    ((builder << arguments), ...);
+    return (*this)(builder);
+  }
+  /// asynchronous version of the call, see Bot::sendMessageAsync
+  ApiFuture<Result> async(const QueryBuilder &arguments) const {
+    return api->template ApiCallAsync<T, TrueOrType>(method, members, destination, arguments);
+  }
+  template <class... Args>
+  ApiFuture<Result> async(const std::pair<std::string_view, Args> &... arguments) const {
+    QueryBuilder builder;
+    ((builder << arguments), ...);
+    return async(builder);
+  }
+  /// prepared arguments as members of JSON object
+  const std::string &preparedArguments() const noexcept {
+    return members;
+  }
+
+private:
+  ApiManager *api;
+  const char *method;
+  std::string members;
+  RateLimiter::Destination destination;
+};
+} // namespace telegram
@@ -1,5 +1,8 @@
 #pragma once
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <rapidjson/document.h>
 #include "json_parser.h"
 #include "utility/utility.h"
@@ -12,13 +15,23 @@ namespace telegram {
  * 1) Create QueryBuilder instance
  * 2) Write data using 'make_named_pair' macro
  * 3) Grab data using getQuery or getDocument methods
+ *
+ * Values are stored in a buffer inside the builder first, so arguments of a usual call \n
+ * are written without heap allocations
  */
 class QueryBuilder {
-  rapidjson::Document doc{};
+  /// size of the first chunk of document memory, larger documents allocate more chunks
+  static constexpr std::size_t inline_capacity = 2048;
+  alignas(std::max_align_t) char buffer[inline_capacity];
+  rapidjson::Document::AllocatorType pool{buffer, sizeof(buffer)};
+  rapidjson::Document doc{&pool};
 
 public:
   explicit QueryBuilder() = default;
   explicit QueryBuilder(rapidjson::Document::AllocatorType &allocator);
+  /// the document refers to memory of the builder, so values are copied
+  QueryBuilder(QueryBuilder &&other);
+  QueryBuilder &operator=(QueryBuilder &&other);
 
   /**
    * Overloaded shift operator for writing data
@@ -34,6 +47,22 @@ public:
    * @brief get JSON string containg all written data
    */
   std::string getQuery() const noexcept;
+  /**
+   * @brief write JSON string containing all written data to 'out'
+   * Memory of 'out' is reused, so a buffer kept between calls is not reallocated
+   */
+  void getQuery(std::string &out) const;
+  /**
+   * @brief write JSON string containing written data and serialized 'members' to 'out'
+   * @param members - members of JSON object without braces, see QueryBuilder::getMembers
+   * \warning names of written values must not repeat names in 'members'
+   */
+  void getQuery(std::string &out, std::string_view members) const;
+  /**
+   * @brief get written data as members of JSON object without braces
+   * Used to serialize values that are the same for many queries once (see PreparedCall)
+   */
+  std::string getMembers() const;
   /**
    * Get document with written values
    * \warning if no value was sent the document will not contain any value \
@@ -42,6 +71,45 @@ public:
    * \return rapidjsonDocument containg all written data
    */
   const rapidjson::Document &getDocument() const noexcept;
+
+  class Body;
+};
+
+/**
+ * @brief Serialized arguments of a call
+ * The string is taken from buffers of the calling thread and is returned to them, so
+ * its memory is reused by the next calls
+ */
+class QueryBuilder::Body {
+  /// larger buffers are released, so a single big call does not stay in memory
+  static constexpr std::size_t max_kept = 64 * 1024;
+  std::string value;
+
+  static std::vector<std::string> &buffers() {
+    // bodies of one thread can be nested, each of them takes its own buffer
+    thread_local std::vector<std::string> free;
+    return free;
+  }
+
+public:
+  /// @param members - serialized arguments of a prepared call, see QueryBuilder::getMembers
+  explicit Body(const QueryBuilder &builder, std::string_view members = {}) {
+    auto &free = buffers();
+    if (!free.empty()) {
+      value = std::move(free.back());
+      free.pop_back();
+    }
+    builder.getQuery(value, members);
+  }
+  ~Body() {
+    if (value.capacity() <= max_kept)
+      buffers().push_back(std::move(value));
+  }
+  Body(const Body &) = delete;
+  Body &operator=(const Body &) = delete;
+  std::string_view view() const noexcept {
+    return value;
+  }
 };
 
 template <class T>
@@ -0,0 +1,132 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace telegram {
+
+/**
+ * @brief Limits of outbound API calls
+ * Defaults follow Telegram recommendations, a non-positive rate disables the limit
+ */
+struct RateLimits {
+    /// calls per second to all chats
+    double global_rate = 30;
+    /// calls per second to one private chat
+    double private_chat_rate = 1;
+    /// calls per second to one group or channel (20 per minute)
+    double group_rate = 20.0 / 60;
+    /// number of calls that can be made to one chat at once before its rate applies
+    double chat_burst = 3;
+};
+
+/**
+ * @brief Outbound scheduler that keeps API calls within RateLimits
+ *
+ * There is a token bucket for the bot and one for every chat. Calls to one chat are \n
+ * queued in FIFO order, chats with queued calls are served round-robin, so a busy \n
+ * group can not delay calls to other chats by more than one call per round. \n
+ * Calls are dispatched by one scheduler thread, so dispatched jobs must not block. \n
+ * While nothing is queued and tokens are available calls pass without a thread hop.
+ */
+class RateLimiter {
+    using clock = std::chrono::steady_clock;
+public:
+    /// Receiver of a call, empty chat means the call is limited by the global rate only
+    struct Destination {
+        std::string chat;
+        /// groups and channels have lower limits than private chats
+        bool group = false;
+    };
+    using Job = std::function<void()>;
+
+    explicit RateLimiter(RateLimits limits = {});
+    ~RateLimiter();
+    RateLimiter(const RateLimiter &) = delete;
+    RateLimiter &operator=(const RateLimiter &) = delete;
+
+    void setLimits(RateLimits limits);
+    /**
+     * @brief Run 'job' when the call is allowed
+     * The job is run on the calling thread if it is allowed immediately, on the
+     * scheduler thread otherwise
+     * @param delay - the job is not run earlier than after 'delay' (e.g retries)
+     */
+    void submit(const Destination &destination, Job job,
+                std::chrono::milliseconds delay = std::chrono::milliseconds(0));
+    /// block the calling thread until the call is allowed
+    void acquire(const Destination &destination,
+                 std::chrono::milliseconds delay = std::chrono::milliseconds(0));
+    /**
+     * @brief Hold calls to the destination for 'duration'
+     * Empty chat holds every call (e.g while the API is degraded)
+     */
+    void pause(const Destination &destination, std::chrono::milliseconds duration);
+    /**
+     * @brief Drop queued jobs and wait for dispatched ones, used on shutdown
+     * The following calls pass without limits, submitted jobs are run on the calling thread
+     */
+    void stop();
+
+private:
+    class Bucket {
+        double tokens = 0;
+        clock::time_point updated;
+    public:
+        /// add tokens accumulated since the last refill, 'rate' is per second
+        void refill(clock::time_point now, double rate, double capacity);
+        bool available() const noexcept {
+            return tokens >= 1;
+        }
+        void take() noexcept {
+            tokens -= 1;
+        }
+        bool full(double capacity) const noexcept {
+            return tokens >= capacity;
+        }
+        /// time when a token is available
+        clock::time_point next(double rate) const;
+    };
+    struct ChatQueue {
+        Bucket bucket;
+        bool group = false;
+        /// calls without a chat, only the global rate applies to them
+        bool global_only = false;
+        bool scheduled = false;
+        clock::time_point paused_until;
+        std::deque<Job> jobs;
+    };
+
+    // require 'mutex' to be locked
+    double chatRate(const ChatQueue &queue) const noexcept;
+    bool tryTake(ChatQueue &queue, clock::time_point now);
+    ChatQueue &chatQueue(const Destination &destination);
+    void purgeIdle(clock::time_point now);
+    void enqueue(const Destination &destination, Job job);
+    /// move delayed jobs that are due to their queues, returns time of the next one
+    clock::time_point releaseDelayed(clock::time_point now);
+    void run();
+
+    RateLimits limits;
+    Bucket global;
+    std::unordered_map<std::string, ChatQueue> chats;
+    /// chats with queued jobs in round-robin order
+    std::deque<std::string> ready;
+    /// jobs submitted with a delay, by time they are due
+    std::multimap<clock::time_point, std::pair<Destination, Job>> delayed;
+    /// every call is held until this time
+    clock::time_point paused_until;
+    clock::time_point last_purge = clock::now();
+    bool stopped = false;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::thread scheduler;
+};
+
+} // namespace telegram
@@ -0,0 +1,87 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string_view>
+
+#include "rate_limiter.h"
+
+namespace telegram {
+
+/// When and how failed API calls are retried, see RetryController
+struct RetryPolicy {
+    /// number of attempts of one call, including the first one
+    std::size_t max_attempts = 4;
+    /// delay after the first failed attempt, doubled for every next one
+    std::chrono::milliseconds base_delay{500};
+    std::chrono::milliseconds max_delay{std::chrono::seconds(30)};
+    /// calls are not retried if Telegram asks to wait longer than this (retry_after)
+    std::chrono::seconds max_retry_after{60};
+    /// number of failures in a row that trips the circuit breaker
+    std::size_t breaker_threshold = 5;
+    /// all calls are held for this time when the breaker trips, doubled for every trip in a row
+    std::chrono::seconds breaker_pause{5};
+    std::chrono::seconds max_breaker_pause{120};
+};
+
+/// Totals of retried and failed API calls
+struct ApiCounters {
+    uint64_t retries = 0;
+    /// replies with 429 (Too Many Requests)
+    uint64_t rate_limited = 0;
+    /// replies with 5xx and requests that got no reply
+    uint64_t failures = 0;
+    uint64_t breaker_trips = 0;
+};
+
+/**
+ * @brief Decides if a failed API call is retried and trips the circuit breaker
+ *
+ * 429 replies are retried after 'retry_after' from the reply plus jitter, calls to the same \n
+ * chat are held for that time. Other failures (5xx or no reply) are retried with \n
+ * jittered exponential backoff, only for idempotent methods (e.g getChat, editMessageText), \n
+ * because it is unknown if the call took effect. \n
+ * Failures in a row trip the breaker: every call is held (see RateLimiter::pause), \n
+ * so workers do not hammer a degraded API. Calls in flight at that moment are not counted.
+ */
+class RetryController {
+    using clock = std::chrono::steady_clock;
+public:
+    explicit RetryController(RateLimiter &limiter, RetryPolicy policy = {});
+
+    void setPolicy(RetryPolicy policy);
+    /**
+     * @brief Register result of an attempt
+     * @param api - Telegram Bot API method name
+     * @param destination - receiver of the call
+     * @param error_code - HTTP status (or ErrorCodes value) of the error, 0 if the call succeeded
+     * @param retry_after - 'retry_after' from the reply parameters
+     * @param attempt - number of the attempt, starting from 1
+     * @return delay before the next attempt, empty if the call must not be retried
+     */
+    std::optional<std::chrono::milliseconds>
+    onResult(std::string_view api, const RateLimiter::Destination &destination,
+             int32_t error_code, std::optional<int32_t> retry_after, std::size_t attempt);
+    ApiCounters counters() const;
+    /// check if repeating the method has the same effect as calling it once
+    static bool idempotent(std::string_view api) noexcept;
+
+private:
+    // require 'mutex' to be locked
+    std::chrono::milliseconds jitter(std::chrono::milliseconds max);
+    void trip(clock::time_point now);
+
+    RateLimiter &limiter;
+    RetryPolicy policy;
+    std::size_t failures_in_row = 0;
+    std::size_t trips_in_row = 0;
+    /// failures of calls made before this time are not counted
+    clock::time_point counted_since;
+    ApiCounters totals;
+    std::mt19937 random{std::random_device{}()};
+    mutable std::mutex mutex;
+};
+
+} // namespace telegram
@@ -1,8 +1,80 @@
 #pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <tuple>
 #include "utility/traits.h"
 
 namespace telegram {
 
+/**
+ * @brief Progress of one user in a shared Sequence
+ * Sequence itself is immutable and shared between users, so only this record
+ * is stored per user
+ */
+struct SequenceState {
+    /// index of the next transition
+    uint32_t step{0};
+    /// incremented on every change, used to detect concurrent modifications
+    uint32_t revision{0};
+    /// optional user data (e.g serialized form that is being filled)
+    std::string data;
+};
+
+/**
+ * @brief Interface of sequence definition that can be started with Bot::startSequence
+ * Implementations must not change their state in 'input', because one object
+ * is shared between all users
+ */
+template <class Event>
+class SequenceBase {
+public:
+    /// Type of Event
+    using EventType = Event;
+    /// Type of value passed to Events
+    using ArgType = typename traits::func_signature<Event>::args_type;
+    /// Event that is called with user id when the sequence is evicted for being idle
+    using TimeoutEvent = std::function<void(int64_t)>;
+
+    virtual ~SequenceBase() = default;
+    /**
+     * @brief Accepts a value for a user on 'step' and performs (or not performs) transition.
+     * @param step - current step of the user
+     * @param arg - Value for input
+     * @return step after the input
+     */
+    virtual std::size_t input(std::size_t step, const ArgType &arg) const = 0;
+    /// returns the total number of transition
+    virtual std::size_t size() const noexcept = 0;
+    /// check if 'step' is past the last transition
+    bool finished(std::size_t step) const noexcept {
+        return step >= size();
+    }
+    /**
+     * @brief Evict the sequence of a user that sent no updates for 'ttl'
+     * Must be set before the sequence is started
+     * @param ttl - idle time after that sequence is removed, zero disables eviction
+     * @param event - optional event called with user id after eviction
+     */
+    void setIdleTimeout(std::chrono::milliseconds ttl, TimeoutEvent event = {}) {
+        idle_timeout = ttl;
+        timeout_event = std::move(event);
+    }
+    /// idle time after that sequence is removed (zero if eviction is disabled)
+    std::chrono::milliseconds idleTimeout() const noexcept {
+        return idle_timeout;
+    }
+    /// event called after eviction
+    const TimeoutEvent &timeoutEvent() const noexcept {
+        return timeout_event;
+    }
+private:
+    std::chrono::milliseconds idle_timeout{0};
+    TimeoutEvent timeout_event;
+};
+
 template <class Event>
 using checker_signature = typename traits::checked_callback<Event>::checker;
 /**
@@ -20,9 +92,15 @@ using checker_signature = typename traits::checked_callback<Event>::checker;
  * Sequence has two special events - exitEvent and enterEvent \n
  * enterEvent happens BEFORE the first transition call \n
  * exitEvent happens AFTER the last transition call \n
+ *
+ * Sequence registered with Bot::startSequence is a shared definition: the same object \n
+ * can be started for any number of users, every user has only a SequenceState. \n
+ * Members that change the step of the object (setStep, finish, reset etc.) are only \n
+ * meaningful when the Sequence is driven manually with Sequence::input(Arg&&) \n
  */
 template <class Event, class Check = checker_signature<Event>>
-class Sequence : public std::enable_shared_from_this<Sequence<Event>> {
+class Sequence : public SequenceBase<Event>,
+                 public std::enable_shared_from_this<Sequence<Event>> {
   using TransitionPair = std::pair<Event, std::optional<Check>>;
   std::vector<TransitionPair> transitions;
   Event exitEvent;
@@ -36,6 +114,9 @@ public:
   using EventType = Event;
   /// Type of Check
   using CheckType = Check;
+  /// Type of value passed to Events
+  using ArgType = typename SequenceBase<Event>::ArgType;
+  using SequenceBase<Event>::finished;
 
   Sequence() noexcept;
   Sequence(const Sequence &) = default;
@@ -50,6 +131,14 @@ public:
    * @param arg - Value for input
    */
   template <class Arg> void input(Arg &&arg);
+  /**
+   * @brief Accepts a value for a user on 'step' and performs (or not performs) transition.
+   * Does not change the Sequence, so one object may be shared between users
+   * @param step - current step of the user
+   * @param arg - Value for input
+   * @return step after the input
+   */
+  std::size_t input(std::size_t step, const ArgType &arg) const override;
   /**
    * Add a check to last transition.
    * Check signature must repeat Transition signature except it must return boolean type.
@@ -116,7 +205,7 @@ public:
       return this->shared_from_this();
   }
   /// returns the total number of transition
-  std::size_t size() const noexcept {
+  std::size_t size() const noexcept override {
       return transitions.size();
   }
 
@@ -127,30 +216,33 @@ public:
 template <class Event, class Check>
 template <class Arg>
 void Sequence<Event, Check>::input(Arg &&arg) {
-    static_assert(std::is_invocable_v<Event, Arg>,
-                  "Not applicable function arguments");
-    if (!finished()) {
-        // invoke commonCheck if it present
-        if (commonCheck && !std::invoke(commonCheck.value(), std::forward<Arg>(arg))) {
-              return;
-        }
-        // if current transition has Check invoke it
-        if (auto step = transitions[m_currentStep].second;step &&
-              !std::invoke(step.value(),std::forward<Arg>(arg))) {
-          return;
-      }
-      // call enterEvent if it present
-      if (!m_currentStep && enterEvent)
-          enterEvent(std::forward<Arg>(arg));
-      // invoke transition event
-      std::invoke(transitions[m_currentStep++].first, std::forward<Arg>(arg));
-
-      // call exitEvent if it present
-      if (finished() && exitEvent)
-          exitEvent(std::forward<Arg>(arg));
+    m_currentStep = input(m_currentStep, std::forward<Arg>(arg));
+}
+
+template <class Event, class Check>
+std::size_t Sequence<Event, Check>::input(std::size_t step, const ArgType &arg) const {
+    if (finished(step))
+        return step;
+    // invoke commonCheck if it present
+    if (commonCheck && !std::invoke(commonCheck.value(), arg)) {
+        return step;
     }
-    return;
-  }
+    // if current transition has Check invoke it
+    if (const auto &check = transitions[step].second;check &&
+            !std::invoke(check.value(),arg)) {
+        return step;
+    }
+    // call enterEvent if it present
+    if (!step && enterEvent)
+        enterEvent(arg);
+    // invoke transition event
+    std::invoke(transitions[step++].first, arg);
+
+    // call exitEvent if it present
+    if (finished(step) && exitEvent)
+        exitEvent(arg);
+    return step;
+}
 
 // implementation of Sequence class
 
@@ -208,4 +300,65 @@ template <class Event, class Check> void Sequence<Event, Check>::reset() {
   m_currentStep = 0;
 }
 
+/**
+ * @brief Sequence with steps known at compile time \n
+ *
+ * Steps are stored in a tuple and called by index through a constexpr jump table, \n
+ * so input does not copy or call any std::function and does not allocate. \n
+ * Step is a callable that accepts the argument and returns either void \n
+ * (transition is always made) or bool (transition is made only if 'true' is returned, \n
+ * the same as Check of Sequence) \n
+ *
+ * Use makeStaticSequence to create one and Bot::startSequence to start it
+ */
+template <class Event, class... Steps>
+class StaticSequence : public SequenceBase<Event> {
+public:
+  /// Type of value passed to steps
+  using ArgType = typename SequenceBase<Event>::ArgType;
+
+private:
+  std::tuple<Steps...> steps;
+
+  using StepInvoker = bool (*)(const StaticSequence &, const ArgType &);
+
+  template <std::size_t I>
+  static bool invokeStep(const StaticSequence &self, const ArgType &arg) {
+    const auto &step = std::get<I>(self.steps);
+    if constexpr (std::is_same_v<std::invoke_result_t<decltype(step), const ArgType &>, bool>) {
+      return std::invoke(step, arg);
+    } else {
+      std::invoke(step, arg);
+      return true;
+    }
+  }
+  template <std::size_t... I>
+  static constexpr std::array<StepInvoker, sizeof...(I)> makeTable(std::index_sequence<I...>) {
+    return {&invokeStep<I>...};
+  }
+
+public:
+  constexpr explicit StaticSequence(Steps... s) : steps{std::move(s)...} {}
+
+  std::size_t input(std::size_t step, const ArgType &arg) const override {
+    static constexpr auto table = makeTable(std::index_sequence_for<Steps...>{});
+    if (this->finished(step))
+      return step;
+    return table[step](*this, arg) ? step + 1 : step;
+  }
+  std::size_t size() const noexcept override {
+    return sizeof...(Steps);
+  }
+};
+
+/**
+ * @brief Create StaticSequence from callables
+ * Example: makeStaticSequence<MessageCallback>([](const Message&){...}, [](const Message&){...});
+ */
+template <class Event, class... Steps>
+std::shared_ptr<StaticSequence<Event, std::decay_t<Steps>...>> makeStaticSequence(Steps &&... steps) {
+  return std::make_shared<StaticSequence<Event, std::decay_t<Steps>...>>(
+      std::forward<Steps>(steps)...);
+}
+
 } // namespace telegram
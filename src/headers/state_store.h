@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sequence_dispatcher.h"
+
+namespace telegram {
+
+/// Progress of a user in a named sequence, as kept by StateStore
+struct StoredState {
+    int64_t id;
+    /// name the sequence was registered with (see UpdateManager::registerSequence)
+    std::string sequence;
+    SequenceState state;
+};
+
+/**
+ * @brief Storage of sequence progress that survives restarts
+ *
+ * UpdateManager calls 'save' and 'erase' from handler threads, so implementations
+ * must be thread-safe. 'load' is called once, when the store is set.
+ */
+class StateStore {
+public:
+    virtual ~StateStore() = default;
+    /// store progress of user 'id', replacing the previous one
+    virtual void save(int64_t id, const std::string &sequence, const SequenceState &state) = 0;
+    /// remove progress of user 'id'
+    virtual void erase(int64_t id) = 0;
+    /// all stored states
+    virtual std::vector<StoredState> load() = 0;
+};
+
+/**
+ * @brief Default StateStore: append-only log in a memory-mapped local file
+ *
+ * Every change is appended as a small record, so saving never rewrites the file. \n
+ * The file is compacted (rewritten with live records only) when it grows larger \n
+ * than 'compaction_ratio' times its live size. On startup the file is mapped and \n
+ * replayed, torn records at the end of the file (e.g after a crash) are discarded. \n
+ * Records survive a crash of the process; call 'flush' to write them to disk.
+ */
+class MappedStateStore : public StateStore {
+public:
+    /**
+     * @param path - path to the file, created if it does not exist
+     * @param compaction_ratio - file is compacted when it is this many times larger than live data
+     * \throws std::runtime_error if the file can not be opened
+     */
+    explicit MappedStateStore(std::string path, std::size_t compaction_ratio = 4);
+    ~MappedStateStore() override;
+    MappedStateStore(const MappedStateStore &) = delete;
+    MappedStateStore &operator=(const MappedStateStore &) = delete;
+
+    void save(int64_t id, const std::string &sequence, const SequenceState &state) override;
+    void erase(int64_t id) override;
+    std::vector<StoredState> load() override;
+    /// rewrite the file with live records only
+    void compact();
+    /// schedule write of mapped pages to disk
+    void flush();
+
+    class File;
+private:
+    // require 'mutex' to be locked
+    void append(const std::string &record);
+    void compactLocked();
+    void compactIfNeeded();
+
+    std::string path;
+    std::size_t compaction_ratio;
+    std::unique_ptr<File> file;
+    /// live records by user id
+    std::unordered_map<int64_t, std::string> live;
+    std::size_t live_size = 0;
+    std::mutex mutex;
+};
+
+} // namespace telegram
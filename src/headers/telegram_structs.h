@@ -511,7 +511,7 @@ struct InputMediaVideo {
 declare_struct
 declare_field(std::string,type); /// Type of the result, must be video
 declare_field(std::string,media); /// File to send. Pass a file_id to send a file that exists on the Telegram servers (recommended), pass an HTTP URL for Telegram to get a file from the Internet, or pass "attach://<file_attach_name>" to upload a new one using multipart/form-data under <file_attach_name> name. 
-declare_field(std::optional<InputFile>,thumb); /// Optional. Thumbnail of the file sent; can be ignored if thumbnail generation for the file is supported server-side. The thumbnail should be in JPEG format and less than 200 kB in size. A thumbnail's width and height should not exceed 320. Ignored if the file is not uploaded using multipart/form-data. Thumbnails can't be reused and can be only uploaded as a new file, so you can pass "attach://<file_attach_name>" if the thumbnail was uploaded using multipart/form-data under <file_attach_name>. 
+declare_field(std::optional<std::string>,thumb); /// Optional. Thumbnail of the file sent; can be ignored if thumbnail generation for the file is supported server-side. The thumbnail should be in JPEG format and less than 200 kB in size. A thumbnail's width and height should not exceed 320. Ignored if the file is not uploaded using multipart/form-data. Thumbnails can't be reused and can be only uploaded as a new file, so you can pass "attach://<file_attach_name>" if the thumbnail was uploaded using multipart/form-data under <file_attach_name>. 
 declare_field(std::optional<std::string>,caption); /// Optional. Caption of the video to be sent, 0-1024 characters after entities parsing
 declare_field(std::optional<std::string>,parse_mode); /// Optional. Mode for parsing entities in the video caption. See formatting options for more details.
 declare_field(std::optional<int64_t>,width); /// Optional. Video width
@@ -524,7 +524,7 @@ struct InputMediaAnimation {
 declare_struct
 declare_field(std::string,type); /// Type of the result, must be animation
 declare_field(std::string,media); /// File to send. Pass a file_id to send a file that exists on the Telegram servers (recommended), pass an HTTP URL for Telegram to get a file from the Internet, or pass "attach://<file_attach_name>" to upload a new one using multipart/form-data under <file_attach_name> name. 
-declare_field(std::optional<InputFile>,thumb); /// Optional. Thumbnail of the file sent; can be ignored if thumbnail generation for the file is supported server-side. The thumbnail should be in JPEG format and less than 200 kB in size. A thumbnail's width and height should not exceed 320. Ignored if the file is not uploaded using multipart/form-data. Thumbnails can't be reused and can be only uploaded as a new file, so you can pass "attach://<file_attach_name>" if the thumbnail was uploaded using multipart/form-data under <file_attach_name>. 
+declare_field(std::optional<std::string>,thumb); /// Optional. Thumbnail of the file sent; can be ignored if thumbnail generation for the file is supported server-side. The thumbnail should be in JPEG format and less than 200 kB in size. A thumbnail's width and height should not exceed 320. Ignored if the file is not uploaded using multipart/form-data. Thumbnails can't be reused and can be only uploaded as a new file, so you can pass "attach://<file_attach_name>" if the thumbnail was uploaded using multipart/form-data under <file_attach_name>. 
 declare_field(std::optional<std::string>,caption); /// Optional. Caption of the animation to be sent, 0-1024 characters after entities parsing
 declare_field(std::optional<std::string>,parse_mode); /// Optional. Mode for parsing entities in the animation caption. See formatting options for more details.
 declare_field(std::optional<int64_t>,width); /// Optional. Animation width
@@ -536,7 +536,7 @@ struct InputMediaAudio {
 declare_struct
 declare_field(std::string,type); /// Type of the result, must be audio
 declare_field(std::string,media); /// File to send. Pass a file_id to send a file that exists on the Telegram servers (recommended), pass an HTTP URL for Telegram to get a file from the Internet, or pass "attach://<file_attach_name>" to upload a new one using multipart/form-data under <file_attach_name> name. 
-declare_field(std::optional<InputFile>,thumb); /// Optional. Thumbnail of the file sent; can be ignored if thumbnail generation for the file is supported server-side. The thumbnail should be in JPEG format and less than 200 kB in size. A thumbnail's width and height should not exceed 320. Ignored if the file is not uploaded using multipart/form-data. Thumbnails can't be reused and can be only uploaded as a new file, so you can pass "attach://<file_attach_name>" if the thumbnail was uploaded using multipart/form-data under <file_attach_name>. 
+declare_field(std::optional<std::string>,thumb); /// Optional. Thumbnail of the file sent; can be ignored if thumbnail generation for the file is supported server-side. The thumbnail should be in JPEG format and less than 200 kB in size. A thumbnail's width and height should not exceed 320. Ignored if the file is not uploaded using multipart/form-data. Thumbnails can't be reused and can be only uploaded as a new file, so you can pass "attach://<file_attach_name>" if the thumbnail was uploaded using multipart/form-data under <file_attach_name>. 
 declare_field(std::optional<std::string>,caption); /// Optional. Caption of the audio to be sent, 0-1024 characters after entities parsing
 declare_field(std::optional<std::string>,parse_mode); /// Optional. Mode for parsing entities in the audio caption. See formatting options for more details.
 declare_field(std::optional<int64_t>,duration); /// Optional. Duration of the audio in seconds
@@ -548,7 +548,7 @@ struct InputMediaDocument {
 declare_struct
 declare_field(std::string,type); /// Type of the result, must be document
 declare_field(std::string,media); /// File to send. Pass a file_id to send a file that exists on the Telegram servers (recommended), pass an HTTP URL for Telegram to get a file from the Internet, or pass "attach://<file_attach_name>" to upload a new one using multipart/form-data under <file_attach_name> name. 
-declare_field(std::optional<InputFile>,thumb); /// Optional. Thumbnail of the file sent; can be ignored if thumbnail generation for the file is supported server-side. The thumbnail should be in JPEG format and less than 200 kB in size. A thumbnail's width and height should not exceed 320. Ignored if the file is not uploaded using multipart/form-data. Thumbnails can't be reused and can be only uploaded as a new file, so you can pass "attach://<file_attach_name>" if the thumbnail was uploaded using multipart/form-data under <file_attach_name>. 
+declare_field(std::optional<std::string>,thumb); /// Optional. Thumbnail of the file sent; can be ignored if thumbnail generation for the file is supported server-side. The thumbnail should be in JPEG format and less than 200 kB in size. A thumbnail's width and height should not exceed 320. Ignored if the file is not uploaded using multipart/form-data. Thumbnails can't be reused and can be only uploaded as a new file, so you can pass "attach://<file_attach_name>" if the thumbnail was uploaded using multipart/form-data under <file_attach_name>. 
 declare_field(std::optional<std::string>,caption); /// Optional. Caption of the document to be sent, 0-1024 characters after entities parsing
 declare_field(std::optional<std::string>,parse_mode); /// Optional. Mode for parsing entities in the document caption. See formatting options for more details.
 };
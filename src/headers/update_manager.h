@@ -1,14 +1,26 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 #include <regex>
 #include <fmt/format.h>
 
 #include "telegram_structs.h"
 #include "sequence_dispatcher.h"
+#include "state_store.h"
 #include "json_parser.h"
 #include "utility/trie.h"
 #include "utility/threadpool.h"
+#include "utility/concurrent_map.h"
+#include "utility/timer_wheel.h"
 
 namespace telegram {
 
@@ -23,12 +35,52 @@ using ChosenInlineResultCallback = std::function<void(const ChosenInlineResult &
 using Callbacks = std::variant<MessageCallback, QueryCallback, InlineQueryCallback,
 ChosenInlineResultCallback,ShippingQueryCallback,PreCheckoutQueryCallback>;
 
-using Sequences = std::variant<std::shared_ptr<Sequence<MessageCallback>>,
-                               std::shared_ptr<Sequence<QueryCallback>>,
-                               std::shared_ptr<Sequence<InlineQueryCallback>>,
-                               std::shared_ptr<Sequence<ChosenInlineResultCallback>>,
-                               std::shared_ptr<Sequence<ShippingQueryCallback>>,
-                               std::shared_ptr<Sequence<PreCheckoutQueryCallback>>>;
+using Sequences = std::variant<std::shared_ptr<SequenceBase<MessageCallback>>,
+                               std::shared_ptr<SequenceBase<QueryCallback>>,
+                               std::shared_ptr<SequenceBase<InlineQueryCallback>>,
+                               std::shared_ptr<SequenceBase<ChosenInlineResultCallback>>,
+                               std::shared_ptr<SequenceBase<ShippingQueryCallback>>,
+                               std::shared_ptr<SequenceBase<PreCheckoutQueryCallback>>>;
+
+/// One-shot handler for the next update of one kind from a user
+struct Waiter {
+    /// index of callback type in Callbacks
+    std::size_t kind;
+    /// receives JSON of the update object
+    std::function<void(const std::string &)> resume;
+};
+
+/// Shared Sequence started for a user together with user`s progress in it
+struct SequenceEntry {
+    Sequences sequence;
+    SequenceState state;
+    /// time of the last update routed to the entry, the idle timer expires
+    /// no later than this time plus idle timeout of the sequence
+    std::chrono::steady_clock::time_point last_activity{std::chrono::steady_clock::now()};
+    /// id of the idle timer of the entry (0 if it has none), expired timers with other ids are ignored
+    uint32_t idle_timer{0};
+    /// JSON of inputs that wait for the running transition, handled in order of arrival.
+    /// Allocated only while a transition of the user is running, so idle entries stay small
+    std::unique_ptr<std::deque<std::string>> pending;
+};
+
+/**
+ * @brief Policies applied while the bot is catching up with a backlog of updates
+ * (e.g after an outage). Catch-up mode starts when the first update of a batch is
+ * older than 'max_lag' and ends with the first batch that is not
+ */
+struct CatchUpPolicy {
+    /// lag of updates that switches routing to catch-up mode
+    std::chrono::seconds max_lag{10};
+    /// messages older than this are not routed in catch-up mode (zero disables the check)
+    std::chrono::seconds max_age{0};
+    /// called for messages older than 'max_age' instead of routing, if empty they are dropped
+    UpdateCallback on_stale;
+    /// route only the last edit of every message in a batch
+    bool collapse_edits = true;
+    /// keep a worker per core in the handler pool while catching up
+    bool use_all_cores = true;
+};
 
 /**
  * @brief This class performs routing on updates \n
@@ -49,17 +101,74 @@ private:
     /// Regexes
     std::vector<std::pair<std::regex,Callbacks>> m_regex;
 
-    /// Container of sequences
-    std::unordered_map<int64_t, Sequences>
-    dispatcher;
+    /// Container of sequences, accessed both by router and by handlers
+    utility::ShardedMap<int64_t, SequenceEntry> dispatcher;
+    /// One-shot handlers (e.g suspended conversations) waiting for next update from user
+    utility::ShardedMap<int64_t, Waiter> waiters;
+
+    /// Sequences registered by name, so their progress can be persisted
+    std::unordered_map<std::string, Sequences> named_sequences;
+    std::unordered_map<const void *, std::string> sequence_names;
+    /// Persistent storage of sequence progress (optional)
+    std::unique_ptr<StateStore> state_store;
+    /// change of progress waiting to be written to 'state_store', erase if 'state' is empty
+    struct StateChange {
+        int64_t id;
+        std::string sequence;
+        std::optional<SequenceState> state;
+    };
+    /// changes are queued under the shard lock and written after it is released, in order
+    std::deque<StateChange> state_changes;
+    std::mutex state_mutex;
+    bool writing_states = false;
+
+    /// Idle timers of sequences, one per entry. Updates only refresh the activity time
+    /// of the entry, expired timer is rescheduled if the entry was active meanwhile
+    utility::TimerWheel<int64_t> idle_timers;
+    /// source of idle timer ids, so timers of removed entries are outdated for new ones
+    std::atomic<uint32_t> idle_timer_ids{0};
+    std::mutex timers_mutex;
+    std::condition_variable timers_condition;
+    /// started with the first sequence that has idle timeout
+    std::thread timers_thread;
+    bool timers_stop = false;
 
     // ThreadPool for controlling  number of threads
     utility::ThreadPool pool;
     // for making requests to Telegram Bot Api
-    size_t lastUpdate = 0;
+    std::atomic<size_t> lastUpdate{0};
+    /// bit mask of Callbacks kinds that have handlers (sequences, callbacks or waiters)
+    std::atomic<uint32_t> handled_kinds{0};
+    std::atomic<bool> handles_all{false};
+
+    CatchUpPolicy catch_up_policy;
+    std::atomic<bool> catching_up{false};
+    /// bounds of the handler pool outside of catch-up mode
+    std::size_t min_pool_threads;
+    std::size_t max_pool_threads;
+    /// guards the bounds, so they are changed and applied to the pool in the same order
+    /// as catch-up mode is switched
+    mutable std::mutex bounds_mutex;
+
+    /// mark kind with 'index' in Callbacks as handled
+    void addHandledKind(std::size_t index) {
+        handled_kinds.fetch_or(uint32_t{1} << index, std::memory_order_relaxed);
+    }
 public:
-    explicit UpdateManager(std::size_t thread_num) : pool(thread_num) {
+    UpdateManager(std::size_t min_threads, std::size_t max_threads)
+        : pool(min_threads, max_threads),
+          min_pool_threads{min_threads}, max_pool_threads{max_threads} {
     }
+    ~UpdateManager();
+    /**
+     * @brief Change bounds of the handler thread pool
+     * Pool grows when updates wait in queue for too long and shrinks when workers are idle
+     * @param min_threads - number of workers that are always kept alive
+     * @param max_threads - maximal number of workers
+     */
+    void setThreadPoolBounds(std::size_t min_threads, std::size_t max_threads);
+    /// bounds of the handler thread pool outside of catch-up mode
+    std::pair<std::size_t, std::size_t> threadPoolBounds() const;
     /**
      * @brief set callback for Update object
      * @param cb callback
@@ -79,9 +188,64 @@ public:
      * @param id Sequence id that was specified in 'addSequence'
      */
     void removeSequence(int64_t id);
+    /**
+     * Get progress of the sequence with 'id' number
+     * @return state if sequence exists, empty optional otherwise
+     */
+    std::optional<SequenceState> getSequenceState(int64_t id) const;
+    /**
+     * Replace progress of the sequence with 'id' number
+     * @return true if sequence exists
+     */
+    bool setSequenceState(int64_t id, SequenceState state);
+    /**
+     * Register sequence under 'name'. Progress of users in registered sequences
+     * is saved to the StateStore and restored when the store is set
+     * \warning must be called before updates are routed
+     * @param name - unique name that identifies the sequence between restarts
+     * @param sequence - sequence definition
+     */
+    void registerSequence(const std::string &name, const Sequences &sequence);
+    /**
+     * Set storage of sequence progress and restore states saved in it
+     * States of sequences that are not registered yet are ignored, but kept in the store
+     * \warning must be called before updates are routed
+     * @param store - storage (e.g MappedStateStore)
+     */
+    void setStateStore(std::unique_ptr<StateStore> store);
+
+    /**
+     * Run 'callback' once for the next update of CallbackType kind from 'id',
+     * instead of routing the update. Waiters have the highest priority in routing
+     * \warning previous waiter for 'id' is removed
+     * @param id - user id
+     * @param callback - callback that accepts object of the update
+     */
+    template <class CallbackType>
+    void addWaiter(int64_t id,
+                   std::function<void(typename traits::func_signature<CallbackType>::args_type &&)> callback);
+    /**
+     * Remove waiter for 'id'
+     */
+    void removeWaiter(int64_t id);
 
     /// get current offset that is used for long polling
     size_t getOffset() const noexcept;
+    /**
+     * @brief Set policies used while catching up with a backlog of updates
+     * \warning must be called before updates are routed
+     */
+    void setCatchUpPolicy(CatchUpPolicy policy);
+    /// check if the last routed batch was handled in catch-up mode
+    bool catchingUp() const noexcept;
+    /**
+     * @brief Update types that have handlers, to be used as 'allowed_updates' in getUpdates
+     * \warning Telegram treats an empty 'allowed_updates' as every update type, so the empty
+     * result must not be sent: Bot::start does not poll until a handler is registered
+     * @return list of update types, every type if UpdateCallback is set,
+     * empty list if nothing is registered
+     */
+    std::vector<std::string_view> allowedUpdates() const;
     /// set offset for long polling
     void setOffset(size_t offset);
     /**
@@ -150,8 +314,51 @@ public:
      */
     template<class CallbackType,class Value>
     bool runIfSequence(int64_t id,const Value& val);
+    /**
+     * Look for waiter and run it if it exists for current id
+     * @param id - id to look for
+     * @param val - json value representing the object
+     * @return true if waiter was invoked, false otherwise
+     */
+    template<class CallbackType,class Value>
+    bool runIfWaiter(int64_t id,const Value& val);
+private:
+    /// mark 'entry' as active and start its idle timer for 'ttl' unless it has a timer
+    /// that expires before, must be called before the sequence of 'entry' is replaced
+    /// @return id of the timer to be scheduled
+    std::optional<uint32_t> armIdleTimeout(SequenceEntry &entry, std::chrono::milliseconds ttl);
+    /// schedule idle timer with 'timer' id of the sequence for 'id'
+    void scheduleIdleTimeout(int64_t id, uint32_t timer, std::chrono::milliseconds ttl);
+    /// remove the sequence for 'id' if it was idle for its timeout, reschedule the timer otherwise
+    void expireSequence(int64_t id, uint32_t timer);
+    /// body of 'timers_thread'
+    void runIdleTimers();
+    /// run transitions for pending inputs of 'id' one by one, until none is left
+    void runSequence(int64_t id);
+    /// queue progress of 'id' to be saved if the sequence is registered,
+    /// called under the shard lock to keep the order of records
+    void persistState(int64_t id, const Sequences &sequence, const SequenceState &state);
+    /// queue removal of progress of 'id' from the store
+    void forgetState(int64_t id);
+    /// write queued changes to the store, must be called after the shard is unlocked
+    void writeStates();
+    /// enter or leave catch-up mode depending on the age of the first update in batch
+    void updateCatchUpMode(int64_t first_date);
 };
 
+template <class CallbackType>
+void UpdateManager::addWaiter(int64_t id,
+                              std::function<void(typename traits::func_signature<CallbackType>::args_type &&)> callback) {
+    using callback_arg_type = typename traits::func_signature<CallbackType>::args_type;
+    addHandledKind(traits::variant_index_v<CallbackType, Callbacks>);
+    // the previous waiter (e.g suspended conversation) is destroyed after the shard is
+    // unlocked, its destructor may access the waiters again
+    waiters.exchange(id, Waiter{traits::variant_index_v<CallbackType, Callbacks>,
+                                [callback = std::move(callback)](const std::string &data) {
+                                    callback(JsonParser::i().fromJson<callback_arg_type>(data));
+                                }});
+}
+
 template <class CallbackType>
 bool UpdateManager::runCallback(std::string_view cmd, const std::string &data) {
     telegram::Callbacks value = m_callbacks.find(cmd).value();
@@ -198,8 +405,15 @@ bool UpdateManager::runIfExist(std::string_view callback_name,std::string_view c
     // check if json contain callback data for current type
     if (!doc.HasMember(callback_name.data()))
         return false;
+    // check if there is a waiter for the user
+    if (!waiters.empty()
+            && doc[callback_name.data()].HasMember("from")
+            && runIfWaiter<CallbackType>(doc[callback_name.data()]["from"]["id"].GetInt64(),
+                                         doc[callback_name.data()].GetObject())) {
+        return true;
+    }
     // check if there is a sequence for the user
-    if (dispatcher.size()
+    if (!dispatcher.empty()
             && doc[callback_name.data()].HasMember("from")
             && runIfSequence<CallbackType>(doc[callback_name.data()]["from"]["id"].GetInt64(),
                                            doc[callback_name.data()].GetObject())) {
@@ -235,30 +449,64 @@ void UpdateManager::removeCallback(std::string_view cmd) {
 }
 template<class CallbackType,class Value>
 bool UpdateManager::runIfSequence(int64_t id,const Value& val) {
-    bool call_successfull = false;
-
-    if (auto result = dispatcher.find(id);result != dispatcher.end()) {
-        // if sequence present for current user
-            std::visit([&](auto&& value){
-                using variant_type = std::decay_t<decltype (value)>;
-                using sequence_type = typename variant_type::element_type;
-                using value_type = typename sequence_type::EventType;
-                if constexpr (std::is_same_v<value_type, CallbackType>) {
-                    if (!value || value->finished()) {
-                        // if sequence has finished erase it and return not triggering the callback
-                        dispatcher.erase(result);
-                    } else {
-                        call_successfull = true;
-                        pool.enqueue([&,object = JsonParser::i().rapidObjectToJson(val)](){
-                            // get real argument type anr run detached
-                            using callbackArgType = typename traits::func_signature<value_type>::args_type;
-                            value->input(JsonParser::i().fromJson<callbackArgType>(object));
-                        });
-                    }
-                }
-            },result->second);
+    using sequence_type = std::shared_ptr<SequenceBase<CallbackType>>;
+    std::optional<Sequences> sequence;
+    uint32_t step = 0;
+    dispatcher.cvisit(id,[&](const SequenceEntry& entry){
+        sequence = entry.sequence;
+        step = entry.state.step;
+    });
+    if (!sequence || !std::holds_alternative<sequence_type>(*sequence))
+        return false;
+    const auto &value = std::get<sequence_type>(*sequence);
+    if (!value || value->finished(step)) {
+        // if sequence has finished erase it (unless it was replaced meanwhile)
+        // and return not triggering the callback
+        dispatcher.erase_if(id,[&](const SequenceEntry& current){
+            if (current.sequence != *sequence)
+                return false;
+            forgetState(id);
+            return true;
+        });
+        writeStates();
+        return false;
     }
-    return call_successfull;
+    // inputs of a user are queued and handled one by one, so every transition
+    // starts from the step left by the previous one
+    std::string object = JsonParser::i().rapidObjectToJson(val);
+    bool queued = false;
+    bool start = false;
+    dispatcher.visit(id,[&](SequenceEntry& entry){
+        if (entry.sequence != *sequence)
+            return;
+        // the queue exists while a transition is running, the first input starts one
+        start = !entry.pending;
+        if (start)
+            entry.pending = std::make_unique<std::deque<std::string>>();
+        entry.pending->push_back(std::move(object));
+        queued = true;
+        // every update counts as activity, even if it does not pass the checks
+        entry.last_activity = std::chrono::steady_clock::now();
+    });
+    if (!queued)
+        return false;
+    if (start)
+        pool.enqueue([this,id](){ runSequence(id); });
+    return true;
+}
+
+template<class CallbackType,class Value>
+bool UpdateManager::runIfWaiter(int64_t id,const Value& val) {
+    auto waiter = waiters.extract_if(id,[](const Waiter& value){
+        return value.kind == traits::variant_index_v<CallbackType, Callbacks>;
+    });
+    if (!waiter)
+        return false;
+    pool.enqueue([resume = std::move(waiter->resume),
+                  object = JsonParser::i().rapidObjectToJson(val)](){
+        resume(object);
+    });
+    return true;
 }
 
 } // namespace telegram
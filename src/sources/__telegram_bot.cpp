@@ -1,3 +1,10 @@
+#include <array>
+#include <cctype>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <queue>
+#include <thread>
 #include <spdlog/spdlog.h>
 
 #include "include/telegram_bot.h"
@@ -7,11 +14,111 @@
 
 namespace telegram {
 
-Bot::Bot(const std::string &token, std::size_t thread_number) noexcept
+namespace {
+/// long polling timeout used when it is not specified, seconds
+constexpr int64_t default_polling_timeout = 30;
+/// read timeout of polling requests is longer than polling timeout by this value
+constexpr std::chrono::seconds polling_read_margin{10};
+/// delay before the next request after a failed one
+constexpr std::chrono::seconds polling_retry_delay{1};
+/// number of replies that may be received ahead of routing
+constexpr std::size_t max_pending_batches = 4;
+
+/**
+ * @brief Limit of updates in one getUpdates reply
+ * Grows while replies are full (there is a backlog) and shrinks when replies are
+ * mostly empty, so small batches are routed without waiting for big ones
+ */
+class AdaptiveLimit {
+  static constexpr uint8_t min_limit = 10;
+  static constexpr uint8_t max_limit = 100;
+  uint8_t value = min_limit;
+public:
+  uint8_t get() const noexcept {
+    return value;
+  }
+  void update(std::size_t received, bool catching_up) noexcept {
+    if (catching_up)
+      value = max_limit;
+    else if (received >= value)
+      value = static_cast<uint8_t>(std::min<std::size_t>(value * 2u, max_limit));
+    else if (received < value / 4u)
+      value = static_cast<uint8_t>(std::max<std::size_t>(value / 2u, min_limit));
+  }
+};
+
+/// number of updates in getUpdates reply, counted without parsing it
+std::size_t countUpdates(std::string_view reply) {
+  constexpr std::string_view key = R"("update_id":)";
+  std::size_t count = 0;
+  for (auto pos = reply.find(key); pos != std::string_view::npos;
+       pos = reply.find(key, pos + key.size()))
+    ++count;
+  return count;
+}
+
+/**
+ * Get id of the last update in getUpdates reply without parsing it
+ * Updates are ordered by id and 'update_id' key is used only at the top level of updates
+ */
+std::optional<uint64_t> lastUpdateId(std::string_view reply) {
+  constexpr std::string_view key = R"("update_id":)";
+  auto pos = reply.rfind(key);
+  if (pos == std::string_view::npos)
+    return {};
+  pos = reply.find_first_not_of(' ', pos + key.size());
+  if (pos == std::string_view::npos || !std::isdigit(static_cast<unsigned char>(reply[pos])))
+    return {};
+  uint64_t id = 0;
+  for (; pos < reply.size() && std::isdigit(static_cast<unsigned char>(reply[pos])); ++pos)
+    id = id * 10 + static_cast<uint64_t>(reply[pos] - '0');
+  return id;
+}
+
+/// names of files uploaded by sendMediaGroup, a group has at most 10 items
+constexpr std::array<std::string_view, 10> media_names = {
+    "file0", "file1", "file2", "file3", "file4", "file5", "file6", "file7", "file8", "file9"};
+/// names of thumbnails of videos uploaded by sendMediaGroup
+constexpr std::array<std::string_view, 10> thumb_names = {
+    "thumb0", "thumb1", "thumb2", "thumb3", "thumb4", "thumb5", "thumb6", "thumb7", "thumb8", "thumb9"};
+
+/// refer to local files of 'media' with "attach://<name>" and return them as file parameters
+std::vector<name_file_pair>
+attachMedia(std::vector<std::variant<InputMediaPhoto, InputMediaVideo>> &media) {
+  std::vector<name_file_pair> files;
+  for (std::size_t i = 0; i < media.size(); ++i) {
+    std::visit([&](auto &item) {
+      constexpr bool photo = std::is_same_v<std::decay_t<decltype(item)>, InputMediaPhoto>;
+      if (item.type.empty())
+        item.type = photo ? "photo" : "video";
+      if (i >= media_names.size())
+        return;
+      if constexpr (!photo) {
+        // a thumbnail can only be uploaded with the video
+        if (item.thumb && FileSource(*item.thumb).kind() == FileSource::Kind::Path) {
+          files.push_back(name_file_pair{thumb_names[i], FileSource(*item.thumb)});
+          item.thumb = "attach://" + std::string(thumb_names[i]);
+        }
+      }
+      FileSource file(item.media);
+      if (file.kind() != FileSource::Kind::Path)
+        return;
+      item.media = "attach://" + std::string(media_names[i]);
+      files.push_back(name_file_pair{media_names[i], std::move(file)});
+    }, media[i]);
+  }
+  return files;
+}
+} // namespace
+
+Bot::Bot(const std::string &token, std::size_t thread_number,
+         std::size_t io_thread_number) noexcept
     : api{std::make_unique<ApiManager>("https://api.telegram.org/bot" + token +
-                                       '/')},
-      updater(std::max(thread_number,std::size_t{2})) {
-    utility::Logger::info(fmt::format("Threadpool capacity set to {}",std::max(thread_number,std::size_t{2})));
+                                       '/', std::max(io_thread_number,std::size_t{2}))},
+      downloader{std::make_unique<FileDownloader>("https://api.telegram.org/file/bot" + token + '/')},
+      updater(2, std::max(thread_number,std::size_t{2})) {
+    utility::Logger::info(fmt::format("Threadpool capacity set to [2, {}]",std::max(thread_number,std::size_t{2})));
+    utility::Logger::info(fmt::format("I/O threadpool capacity set to [1, {}]",std::max(io_thread_number,std::size_t{2})));
 }
 
 void Bot::onUpdate(UpdateCallback &&cb) {
@@ -42,11 +149,140 @@ void Bot::onInlineQuery(std::string_view cmd, InlineQueryCallback&& cb) {
 void Bot::onShippingQuery(std::string_view cmd,ShippingQueryCallback&& cb) {
     updater.addCallback(cmd, std::move(cb));
 }
+void Bot::setThreadPoolBounds(std::size_t min_threads, std::size_t max_threads) {
+    updater.setThreadPoolBounds(min_threads, max_threads);
+}
+
+void Bot::setIoThreadPoolBounds(std::size_t min_threads, std::size_t max_threads) {
+    utility::Logger::info(fmt::format("I/O threadpool bounds set to [{}, {}]",min_threads,max_threads));
+    api->setThreadPoolBounds(min_threads, max_threads);
+}
+bool Bot::setEventLoopTransport(bool enable) {
+    utility::Logger::info(fmt::format("Event loop transport {}",enable ? "enabled" : "disabled"));
+    return api->setEventLoopTransport(enable);
+}
+
+void Bot::setRateLimits(RateLimits limits) {
+    utility::Logger::info(fmt::format("Rate limits set to {}/s in total, {}/s per private chat, {}/s per group",
+                                      limits.global_rate, limits.private_chat_rate, limits.group_rate));
+    api->setRateLimits(limits);
+}
+
+void Bot::setRetryPolicy(RetryPolicy policy) {
+    api->setRetryPolicy(policy);
+}
+
+ApiCounters Bot::apiCounters() const {
+    return api->counters();
+}
+
+bool Bot::setFileIdCache(const std::string &index_path, std::size_t capacity) {
+    utility::Logger::info(fmt::format("File id cache capacity set to {}", capacity));
+    return api->setFileIdCache(index_path, capacity);
+}
+
+std::pair<DownloadCache::Lease, opt_error> Bot::fetchFile(const std::string &file_id) {
+    auto [file, error] = getFile(file_id);
+    if (error)
+        return {nullptr, error};
+    if (!file.file_path)
+        return {nullptr, Error{static_cast<int32_t>(ErrorCodes::InvalidReply),
+                               "File " + file_id + " can not be downloaded"}};
+    // different file_ids of one file share the download
+    auto result = downloader->fetch(file.file_unique_id.empty() ? file_id : file.file_unique_id,
+                                    *file.file_path, file.file_size);
+    if (!result.file)
+        return {nullptr, Error{result.error_code, result.description}};
+    return {std::move(result.file), {}};
+}
+
+opt_error Bot::downloadFile(const std::string &file_id, const std::string &destination) {
+    auto [file, error] = fetchFile(file_id);
+    if (error)
+        return error;
+    std::error_code copy_error;
+    // a copy, so changes of the destination do not change the cache
+    fs::copy_file(*file, destination, fs::copy_options::overwrite_existing, copy_error);
+    if (copy_error)
+        return Error{static_cast<int32_t>(ErrorCodes::NotValid),
+                     "Unable to copy file to " + destination + ": " + copy_error.message()};
+    return {};
+}
+
+opt_error Bot::downloadFile(const std::string &file_id,
+                            const std::function<bool(const char *, std::size_t)> &sink) {
+    auto [file, error] = fetchFile(file_id);
+    if (error)
+        return error;
+    std::ifstream in(*file, std::ios::binary);
+    std::vector<char> chunk(MultipartBody::chunk_size);
+    while (in) {
+        in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        const auto size = static_cast<std::size_t>(in.gcount());
+        if (size && !sink(chunk.data(), size))
+            break;
+    }
+    if (in.bad())
+        return Error{static_cast<int32_t>(ErrorCodes::NotValid), "Unable to read " + file->string()};
+    return {};
+}
+
+std::pair<MappedFile, opt_error> Bot::openFile(const std::string &file_id) {
+    auto [file, error] = fetchFile(file_id);
+    if (error)
+        return {MappedFile{}, error};
+    MappedFile mapped(file);
+    if (!mapped.valid())
+        return {MappedFile{}, Error{static_cast<int32_t>(ErrorCodes::NotValid),
+                                    "Unable to map " + file->string()}};
+    return {std::move(mapped), {}};
+}
+
+void Bot::setDownloadCache(const std::string &directory, std::uintmax_t capacity) {
+    utility::Logger::info(fmt::format("Download cache capacity set to {} bytes", capacity));
+    downloader->cache().configure(directory, capacity);
+}
+
+bool Bot::setApiServer(const ApiServer &server) {
+    utility::Logger::info(fmt::format("Bot API server set to {}{}{}", server.url,
+                                      server.unix_socket.empty() ? "" : " on " + server.unix_socket,
+                                      server.local ? " in local mode" : ""));
+    // nothing is changed unless every part accepts the server
+    if (!NetworkManager::supports(server) || !api->setServer(server))
+        return false;
+    return downloader->setServer(server, api->fileUrl());
+}
+
+void Bot::setConnectionPool(std::size_t size, std::chrono::seconds idle_timeout,
+                            std::size_t max_requests) {
+    utility::Logger::info(fmt::format("Connection pool size set to {}",size));
+    api->setConnectionPool(size, idle_timeout, max_requests);
+}
 void Bot::stopSequence(int64_t user_id) {
     utility::Logger::info(fmt::format("Removed sequence for user #{}",user_id));
     updater.removeSequence(user_id);
 }
 
+void Bot::setStateStore(std::unique_ptr<StateStore> store) {
+    updater.setStateStore(std::move(store));
+}
+
+void Bot::setCatchUpPolicy(CatchUpPolicy policy) {
+    updater.setCatchUpPolicy(std::move(policy));
+}
+
+void Bot::cancelNextUpdate(int64_t user_id) {
+    updater.removeWaiter(user_id);
+}
+
+std::optional<SequenceState> Bot::getSequenceState(int64_t user_id) const {
+    return updater.getSequenceState(user_id);
+}
+
+bool Bot::setSequenceState(int64_t user_id, SequenceState state) {
+    return updater.setSequenceState(user_id, std::move(state));
+}
+
 void Bot::start(std::optional<int64_t> timeout, std::optional<int64_t> offset, std::optional<int8_t> limit,
                 std::optional<std::vector<std::string_view>> allowed_updates) {
   if (auto &&[webhook, Error] = getWebhookInfo();
@@ -60,11 +296,82 @@ void Bot::start(std::optional<int64_t> timeout, std::optional<int64_t> offset, s
   stopPolling = false;
   updater.setOffset(offset.value_or(0));
   utility::Logger::info("Bot started");
-  while (!stopPolling) {
-    updater.routeCallback(getUpdatesRawJson(updater.getOffset(), limit, timeout,
-                                            allowed_updates));
-    std::this_thread::sleep_for(std::chrono::milliseconds(timeout.value_or(1)));
+
+  const auto poll_timeout = static_cast<uint32_t>(timeout.value_or(default_polling_timeout));
+  // replies that are received but not routed yet
+  std::queue<std::string> batches;
+  std::mutex batches_mutex;
+  std::condition_variable batches_condition;
+  bool polling_finished = false;
+
+  // the next request is sent as soon as the offset of the previous reply is known,
+  // the reply is parsed and routed on the calling thread meanwhile
+  std::thread poller([&] {
+    std::size_t next_offset = updater.getOffset();
+    AdaptiveLimit adaptive_limit;
+    while (!stopPolling) {
+      // without explicit values the limit follows the load and update types follow
+      // registered handlers (handlers may be added while the bot is running)
+      auto types = allowed_updates ? *allowed_updates : updater.allowedUpdates();
+      // Telegram treats an empty list as every update type, so nothing is requested
+      // until a handler is registered
+      if (!allowed_updates && types.empty()) {
+        std::this_thread::sleep_for(polling_retry_delay);
+        continue;
+      }
+      std::string batch = pollUpdates(static_cast<uint32_t>(next_offset),
+                                      limit ? std::optional<uint8_t>(*limit)
+                                            : std::optional<uint8_t>(adaptive_limit.get()),
+                                      poll_timeout, std::move(types));
+      const bool failed = batch.find(R"("ok":true)") == std::string::npos;
+      if (!failed)
+        adaptive_limit.update(countUpdates(batch), updater.catchingUp());
+      if (auto last = lastUpdateId(batch))
+        next_offset = *last + 1;
+      if (!batch.empty()) {
+        std::unique_lock lock(batches_mutex);
+        batches_condition.wait(lock, [&] {
+          return batches.size() < max_pending_batches || stopPolling;
+        });
+        batches.push(std::move(batch));
+      }
+      batches_condition.notify_all();
+      // back off only if the request failed, so errors do not turn into a busy loop
+      if (failed && !stopPolling) {
+        utility::Logger::warn("getUpdates request failed, retrying");
+        std::this_thread::sleep_for(polling_retry_delay);
+      }
+    }
+    {
+      std::unique_lock lock(batches_mutex);
+      polling_finished = true;
+    }
+    batches_condition.notify_all();
+  });
+
+  for (;;) {
+    std::string batch;
+    {
+      std::unique_lock lock(batches_mutex);
+      batches_condition.wait(lock, [&] { return !batches.empty() || polling_finished; });
+      if (batches.empty())
+        break;
+      batch = std::move(batches.front());
+      batches.pop();
+    }
+    batches_condition.notify_all();
+    updater.routeCallback(batch);
   }
+  poller.join();
+}
+std::string Bot::pollUpdates(std::optional<uint32_t> offset, std::optional<uint8_t> limit,
+                             uint32_t timeout,
+                             const std::optional<std::vector<std::string_view>> &allowed_updates) {
+  QueryBuilder builder;
+  builder << make_named_pair(offset) << make_named_pair(limit)
+          << make_named_pair(timeout) << make_named_pair(allowed_updates);
+  return api->ApiCallRaw("getUpdates", builder,
+                         std::chrono::seconds(timeout) + polling_read_margin);
 }
 std::string Bot::getUpdatesRawJson(
     std::optional<uint32_t> offset, std::optional<uint8_t> limit,
@@ -134,5 +441,34 @@ bool Bot::setWebhookServer(const std::string &url, uint16_t port,
   return server.listen("0.0.0.0", port);
 }
 
+std::pair<std::vector<Message>, opt_error>
+Bot::sendMediaGroup(const std::variant<int64_t, std::string> &chat_id,
+                    std::vector<std::variant<InputMediaPhoto, InputMediaVideo>> media,
+                    std::optional<bool> disable_notification,
+                    std::optional<int64_t> reply_to_message_id) const {
+  auto params = attachMedia(media);
+  QueryBuilder builder;
+  builder << make_named_pair(chat_id) << make_named_pair(media)
+          << make_named_pair(disable_notification) << make_named_pair(reply_to_message_id);
+  if (params.empty())
+    return api->ApiCall<std::vector<Message>>(__func__, builder);
+  return api->ApiCall<std::vector<Message>>(__func__, builder, params);
+}
+
+ApiFuture<std::pair<std::vector<Message>, opt_error>>
+Bot::sendMediaGroupAsync(const std::variant<int64_t, std::string> &chat_id,
+                         std::vector<std::variant<InputMediaPhoto, InputMediaVideo>> media,
+                         std::optional<bool> disable_notification,
+                         std::optional<int64_t> reply_to_message_id) const {
+  auto params = attachMedia(media);
+  QueryBuilder builder;
+  builder << make_named_pair(chat_id) << make_named_pair(media)
+          << make_named_pair(disable_notification) << make_named_pair(reply_to_message_id);
+  if (params.empty())
+    return api->ApiCallAsync<std::vector<Message>>("sendMediaGroup", builder);
+  return api->ApiCallAsync<std::vector<Message>>("sendMediaGroup", std::move(builder),
+                                                 std::move(params));
+}
+
 // --------------------------- AUTOGENERAGED CODE ------------------------------
 
@@ -0,0 +1,817 @@
+#include <stdexcept>
+#include <fmt/format.h>
+
+#include "headers/async_http_client.h"
+#include "utility/logger.h"
+#include "utility/http_response_parser.h"
+#include "utility/shared_pool.h"
+
+#ifdef __linux__
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#endif
+
+using namespace telegram;
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::chrono::milliseconds tick{100};
+constexpr std::size_t read_chunk_size = 16 * 1024;
+
+struct Url {
+    bool tls = false;
+    std::string host;
+    uint16_t port = 80;
+    std::string target;
+    /// path of unix domain socket, empty for TCP
+    std::string socket;
+
+    std::string key() const {
+        if (!socket.empty())
+            return "http+unix://" + socket;
+        return fmt::format("{}://{}:{}", tls ? "https" : "http", host, port);
+    }
+};
+
+/// decode %XX sequences of socket path in http+unix url
+std::string percentDecode(std::string_view value) {
+    std::string result;
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '%' && i + 2 < value.size() &&
+            std::isxdigit(static_cast<unsigned char>(value[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(value[i + 2]))) {
+            result += static_cast<char>(std::stoi(std::string(value.substr(i + 1, 2)), nullptr, 16));
+            i += 2;
+        } else {
+            result += value[i];
+        }
+    }
+    return result;
+}
+
+std::optional<Url> parseUrl(std::string_view url) {
+    Url result;
+    if (url.substr(0, 12) == "http+unix://") {
+        url.remove_prefix(12);
+        const auto slash = url.find('/');
+        result.socket = percentDecode(url.substr(0, slash));
+        result.target = slash == std::string_view::npos ? "/" : std::string(url.substr(slash));
+        result.host = "localhost";
+        if (result.socket.empty())
+            return {};
+        return result;
+    }
+    if (url.substr(0, 8) == "https://") {
+        result.tls = true;
+        result.port = 443;
+        url.remove_prefix(8);
+    } else if (url.substr(0, 7) == "http://") {
+        url.remove_prefix(7);
+    } else {
+        return {};
+    }
+    const auto slash = url.find('/');
+    std::string_view authority = url.substr(0, slash);
+    result.target = slash == std::string_view::npos ? "/" : std::string(url.substr(slash));
+    if (auto colon = authority.rfind(':'); colon != std::string_view::npos) {
+        result.port = static_cast<uint16_t>(std::stoi(std::string(authority.substr(colon + 1))));
+        authority = authority.substr(0, colon);
+    }
+    result.host = std::string(authority);
+    if (result.host.empty())
+        return {};
+    return result;
+}
+
+struct Request {
+    Url url;
+    std::string data;
+    AsyncHttpClient::Callback callback;
+    clock_type::time_point deadline;
+    /// request is retried once if reused connection was closed before the response
+    bool retried = false;
+};
+
+struct Host;
+
+struct Connection {
+    enum class State { connecting, handshaking, writing, reading, idle };
+    int fd = -1;
+    Host *host = nullptr;
+    State state = State::connecting;
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+    SSL *ssl = nullptr;
+#endif
+    std::optional<Request> request;
+    std::size_t written = 0;
+    std::optional<utility::HttpResponseParser> parser;
+    bool reused = false;
+    /// number of requests completed on the connection
+    std::size_t requests = 0;
+    clock_type::time_point idle_since;
+    /// index of the host address the connection is made to
+    std::size_t address = 0;
+};
+
+struct Address {
+    sockaddr_storage storage{};
+    socklen_t size = 0;
+};
+
+/// resolve addresses of the host, blocks (getaddrinfo)
+std::vector<Address> lookup(const Url &url) {
+    std::vector<Address> addresses;
+    if (!url.socket.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (url.socket.size() >= sizeof(address.sun_path)) {
+            utility::Logger::warn(fmt::format("Socket path is too long: {}", url.socket));
+            return addresses;
+        }
+        std::memcpy(address.sun_path, url.socket.data(), url.socket.size());
+        addresses.emplace_back();
+        std::memcpy(&addresses.back().storage, &address, sizeof(address));
+        addresses.back().size = sizeof(address);
+        return addresses;
+    }
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = nullptr;
+    if (getaddrinfo(url.host.data(), std::to_string(url.port).data(), &hints, &result) != 0)
+        return addresses;
+    for (auto *it = result; it; it = it->ai_next) {
+        if (it->ai_addrlen > sizeof(sockaddr_storage))
+            continue;
+        addresses.emplace_back();
+        std::memcpy(&addresses.back().storage, it->ai_addr, it->ai_addrlen);
+        addresses.back().size = static_cast<socklen_t>(it->ai_addrlen);
+    }
+    freeaddrinfo(result);
+    return addresses;
+}
+
+struct Host {
+    Url url;
+    /// the address that accepted the last connection is the first one
+    std::vector<Address> addresses;
+    /// addresses are being resolved on the resolver thread
+    bool resolving = false;
+    std::deque<Request> pending;
+    std::vector<Connection *> idle;
+    std::size_t active = 0;
+};
+} // namespace
+
+struct AsyncHttpClient::Impl {
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    std::thread loop_thread;
+    std::atomic<bool> stop{false};
+
+    std::mutex submit_mutex;
+    std::vector<Request> submitted;
+    /// host names are resolved on a separate thread, so a slow DNS does not stall the loop
+    std::thread resolver_thread;
+    std::condition_variable resolver_condition;
+    std::deque<Url> unresolved;
+    std::vector<std::pair<std::string, std::vector<Address>>> resolved;
+    std::atomic<std::size_t> max_connections{64};
+    std::atomic<int64_t> timeout_seconds{60};
+    std::atomic<int64_t> idle_timeout_seconds{60};
+    std::atomic<std::size_t> max_requests{std::numeric_limits<std::size_t>::max()};
+
+    // accessed by loop thread only
+    std::unordered_map<std::string, std::unique_ptr<Host>> hosts;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    /// responses are reused once callbacks released them
+    utility::SharedPool<httplib::Response> responses;
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+    SSL_CTX *ssl_context = nullptr;
+#endif
+
+    Impl() {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epoll_fd < 0 || wake_fd < 0)
+            throw std::runtime_error("Unable to create event loop");
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = wake_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+        ssl_context = SSL_CTX_new(TLS_client_method());
+        SSL_CTX_set_default_verify_paths(ssl_context);
+        SSL_CTX_set_verify(ssl_context, SSL_VERIFY_PEER, nullptr);
+#endif
+        loop_thread = std::thread([this] { loop(); });
+        resolver_thread = std::thread([this] { resolve(); });
+    }
+    ~Impl() {
+        {
+            std::unique_lock lock(submit_mutex);
+            stop = true;
+        }
+        resolver_condition.notify_all();
+        wake();
+        loop_thread.join();
+        resolver_thread.join();
+        // fail requests that were not completed
+        for (auto &[fd, connection] : connections)
+            if (connection->request)
+                fail(*connection->request);
+        for (auto &[key, host] : hosts)
+            for (auto &request : host->pending)
+                fail(request);
+        for (auto &request : submitted)
+            fail(request);
+        for (auto &[fd, connection] : connections)
+            destroy(*connection);
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+        SSL_CTX_free(ssl_context);
+#endif
+        ::close(wake_fd);
+        ::close(epoll_fd);
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        if (::write(wake_fd, &one, sizeof(one)) < 0)
+            utility::Logger::warn("Unable to wake up event loop");
+    }
+
+    void submit(Request &&request) {
+        {
+            std::unique_lock lock(submit_mutex);
+            submitted.push_back(std::move(request));
+        }
+        wake();
+    }
+
+    static void fail(Request &request) {
+        if (request.callback)
+            request.callback(nullptr);
+        request.callback = nullptr;
+    }
+
+    Host *findHost(const Url &url) {
+        auto &host = hosts[url.key()];
+        if (!host) {
+            host = std::make_unique<Host>();
+            host->url = url;
+        }
+        return host.get();
+    }
+
+    /// body of the resolver thread
+    void resolve() {
+        std::unique_lock lock(submit_mutex);
+        for (;;) {
+            resolver_condition.wait(lock, [this] { return stop || !unresolved.empty(); });
+            if (stop)
+                return;
+            Url url = std::move(unresolved.front());
+            unresolved.pop_front();
+            lock.unlock();
+            auto addresses = lookup(url);
+            lock.lock();
+            resolved.emplace_back(url.key(), std::move(addresses));
+            wake();
+        }
+    }
+
+    /// pass addresses of resolved hosts to them and send their requests
+    void takeResolved(std::vector<std::pair<std::string, std::vector<Address>>> &results) {
+        for (auto &[key, addresses] : results) {
+            auto it = hosts.find(key);
+            if (it == hosts.end())
+                continue;
+            Host &host = *it->second;
+            host.resolving = false;
+            host.addresses = std::move(addresses);
+            if (host.addresses.empty()) {
+                utility::Logger::warn(fmt::format("Unable to resolve {}", host.url.host));
+                auto pending = std::move(host.pending);
+                host.pending.clear();
+                for (auto &request : pending)
+                    fail(request);
+                continue;
+            }
+            dispatch(host);
+        }
+    }
+
+    void watch(Connection &connection, uint32_t events, int op = EPOLL_CTL_MOD) {
+        epoll_event event{};
+        event.events = events | EPOLLRDHUP;
+        event.data.fd = connection.fd;
+        epoll_ctl(epoll_fd, op, connection.fd, &event);
+    }
+
+    void destroy(Connection &connection) {
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+        if (connection.ssl)
+            SSL_free(connection.ssl);
+        connection.ssl = nullptr;
+#endif
+        if (connection.fd >= 0)
+            ::close(connection.fd);
+        connection.fd = -1;
+    }
+
+    /// close connection and retry or fail its request
+    void close(Connection &connection) {
+        Host *host = connection.host;
+        const int fd = connection.fd;
+        if (connection.state == Connection::State::idle) {
+            host->idle.erase(std::remove(host->idle.begin(), host->idle.end(), &connection),
+                             host->idle.end());
+        } else {
+            --host->active;
+        }
+        if (connection.request) {
+            // server may close kept alive connection right before we reuse it
+            if (connection.reused && !connection.request->retried
+                    && !(connection.parser && connection.parser->started())) {
+                connection.request->retried = true;
+                host->pending.push_front(std::move(*connection.request));
+            } else {
+                fail(*connection.request);
+            }
+        }
+        destroy(connection);
+        connections.erase(fd);
+        dispatch(*host);
+    }
+
+    void dispatch(Host &host) {
+        while (!host.pending.empty()) {
+            if (!host.idle.empty()) {
+                Connection *connection = host.idle.back();
+                host.idle.pop_back();
+                ++host.active;
+                connection->reused = true;
+                // the request leaves the queue first, 'start' may close the connection
+                // and queue the request again
+                Request request = std::move(host.pending.front());
+                host.pending.pop_front();
+                start(*connection, std::move(request));
+            } else if (host.active < max_connections) {
+                if (host.addresses.empty()) {
+                    requestResolve(host);
+                    return;
+                }
+                Request request = std::move(host.pending.front());
+                host.pending.pop_front();
+                open(host, std::move(request), 0);
+            } else {
+                return;
+            }
+        }
+    }
+
+    /// queue the host to the resolver thread, its requests wait meanwhile
+    void requestResolve(Host &host) {
+        if (host.resolving)
+            return;
+        host.resolving = true;
+        {
+            std::unique_lock lock(submit_mutex);
+            unresolved.push_back(host.url);
+        }
+        resolver_condition.notify_one();
+    }
+
+    /// connect to the host for 'request', trying addresses from 'index' one by one
+    void open(Host &host, Request &&request, std::size_t index) {
+        for (; index < host.addresses.size(); ++index) {
+            auto &address = host.addresses[index];
+            int fd = ::socket(address.storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0)
+                continue;
+            int one = 1;
+            if (address.storage.ss_family != AF_UNIX)
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            if (::connect(fd, reinterpret_cast<sockaddr *>(&address.storage), address.size) < 0
+                    && errno != EINPROGRESS) {
+                ::close(fd);
+                continue;
+            }
+            auto connection = std::make_unique<Connection>();
+            connection->fd = fd;
+            connection->host = &host;
+            connection->address = index;
+            connection->state = Connection::State::connecting;
+            // the request is attached when the connection is established
+            connection->request.emplace(std::move(request));
+            ++host.active;
+            watch(*connection, EPOLLOUT, EPOLL_CTL_ADD);
+            connections.emplace(fd, std::move(connection));
+            return;
+        }
+        // no address accepts connections, they are resolved again for the next request
+        host.addresses.clear();
+        fail(request);
+    }
+
+    /// connection was refused, connect to the next address of the host with the same request
+    void reconnect(Connection &connection) {
+        Host &host = *connection.host;
+        Request request = std::move(*connection.request);
+        const std::size_t next = connection.address + 1;
+        const int fd = connection.fd;
+        --host.active;
+        destroy(connection);
+        connections.erase(fd);
+        open(host, std::move(request), next);
+    }
+
+    void start(Connection &connection, Request &&request) {
+        connection.request.emplace(std::move(request));
+        connection.written = 0;
+        connection.parser.reset();
+        connection.state = Connection::State::writing;
+        watch(connection, EPOLLOUT);
+        write(connection);
+    }
+
+    void connected(Connection &connection) {
+        int error = 0;
+        socklen_t size = sizeof(error);
+        getsockopt(connection.fd, SOL_SOCKET, SO_ERROR, &error, &size);
+        if (error)
+            return reconnect(connection);
+        // the next connections try the address that works first
+        Host &host = *connection.host;
+        if (connection.address && connection.address < host.addresses.size()) {
+            std::swap(host.addresses[0], host.addresses[connection.address]);
+            connection.address = 0;
+        }
+        if (connection.host->url.tls) {
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+            connection.ssl = SSL_new(ssl_context);
+            SSL_set_fd(connection.ssl, connection.fd);
+            SSL_set_tlsext_host_name(connection.ssl, connection.host->url.host.data());
+            SSL_set1_host(connection.ssl, connection.host->url.host.data());
+            connection.state = Connection::State::handshaking;
+            return handshake(connection);
+#else
+            utility::Logger::warn("HTTPS requires the library to be built with OpenSSL");
+            return close(connection);
+#endif
+        }
+        connection.state = Connection::State::writing;
+        write(connection);
+    }
+
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+    /// handle result of non-blocking SSL call, returns false if connection was closed
+    bool sslWait(Connection &connection, int result) {
+        switch (SSL_get_error(connection.ssl, result)) {
+        case SSL_ERROR_WANT_READ:
+            watch(connection, EPOLLIN);
+            return true;
+        case SSL_ERROR_WANT_WRITE:
+            watch(connection, EPOLLOUT);
+            return true;
+        default:
+            close(connection);
+            return false;
+        }
+    }
+    void handshake(Connection &connection) {
+        int result = SSL_connect(connection.ssl);
+        if (result == 1) {
+            connection.state = Connection::State::writing;
+            return write(connection);
+        }
+        sslWait(connection, result);
+    }
+#endif
+
+    void write(Connection &connection) {
+        const std::string &data = connection.request->data;
+        while (connection.written < data.size()) {
+            const char *begin = data.data() + connection.written;
+            const std::size_t size = data.size() - connection.written;
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+            if (connection.ssl) {
+                int result = SSL_write(connection.ssl, begin, static_cast<int>(size));
+                if (result <= 0) {
+                    sslWait(connection, result);
+                    return;
+                }
+                connection.written += static_cast<std::size_t>(result);
+                continue;
+            }
+#endif
+            ssize_t result = ::send(connection.fd, begin, size, MSG_NOSIGNAL);
+            if (result < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    watch(connection, EPOLLOUT);
+                    return;
+                }
+                return close(connection);
+            }
+            connection.written += static_cast<std::size_t>(result);
+        }
+        connection.state = Connection::State::reading;
+        connection.parser.emplace(responses.acquire([](httplib::Response &response) {
+            response.status = -1;
+            response.headers.clear();
+            // the body keeps its memory unless it was large (e.g long polling reply)
+            if (response.body.capacity() > 64 * 1024)
+                std::string().swap(response.body);
+            else
+                response.body.clear();
+        }));
+        watch(connection, EPOLLIN);
+    }
+
+    void read(Connection &connection) {
+        char buffer[read_chunk_size];
+        for (;;) {
+            ssize_t result;
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+            if (connection.ssl) {
+                result = SSL_read(connection.ssl, buffer, sizeof(buffer));
+                if (result <= 0) {
+                    const int error = SSL_get_error(connection.ssl, static_cast<int>(result));
+                    if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+                        watch(connection, error == SSL_ERROR_WANT_READ ? EPOLLIN : EPOLLOUT);
+                        return;
+                    }
+                    return closed(connection);
+                }
+            } else
+#endif
+            {
+                result = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+                if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    return;
+                if (result <= 0)
+                    return closed(connection);
+            }
+            if (!connection.parser->feed(buffer, static_cast<std::size_t>(result)))
+                return close(connection);
+            if (connection.parser->done())
+                return complete(connection);
+        }
+    }
+
+    /// server closed connection while response was read
+    void closed(Connection &connection) {
+        if (connection.parser && connection.parser->finishOnClose()) {
+            connection.parser->close = true;
+            return complete(connection);
+        }
+        close(connection);
+    }
+
+    void complete(Connection &connection) {
+        auto request = std::move(*connection.request);
+        connection.request.reset();
+        auto response = connection.parser->response;
+        const bool keep_alive = !connection.parser->close && ++connection.requests < max_requests;
+        connection.parser.reset();
+        if (request.callback)
+            request.callback(std::move(response));
+
+        Host &host = *connection.host;
+        if (keep_alive) {
+            --host.active;
+            connection.state = Connection::State::idle;
+            connection.idle_since = clock_type::now();
+            host.idle.push_back(&connection);
+            // an idle connection becomes readable only when the server closes it
+            watch(connection, EPOLLIN);
+            dispatch(host);
+        } else {
+            close(connection);
+        }
+    }
+
+    void handle(Connection &connection, uint32_t events) {
+        if (connection.state == Connection::State::idle) {
+            return close(connection);
+        }
+        // socket is writable when connection is established or reports an error if it failed
+        if (connection.state == Connection::State::connecting) {
+            if (events & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+                connected(connection);
+            return;
+        }
+        if (events & EPOLLERR)
+            return close(connection);
+        switch (connection.state) {
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+        case Connection::State::handshaking:
+            return handshake(connection);
+#endif
+        case Connection::State::writing:
+            return write(connection);
+        case Connection::State::reading:
+            return read(connection);
+        default:
+            return close(connection);
+        }
+    }
+
+    void takeSubmitted() {
+        uint64_t value = 0;
+        while (::read(wake_fd, &value, sizeof(value)) > 0) {
+        }
+        std::vector<Request> requests;
+        std::vector<std::pair<std::string, std::vector<Address>>> results;
+        {
+            std::unique_lock lock(submit_mutex);
+            requests.swap(submitted);
+            results.swap(resolved);
+        }
+        takeResolved(results);
+        for (auto &request : requests) {
+            Host *host = findHost(request.url);
+            host->pending.push_back(std::move(request));
+            dispatch(*host);
+        }
+    }
+
+    void checkTimeouts() {
+        const auto now = clock_type::now();
+        const std::chrono::seconds idle_timeout{idle_timeout_seconds.load()};
+        std::vector<int> expired;
+        for (auto &[fd, connection] : connections) {
+            if (connection->state == Connection::State::idle) {
+                if (now - connection->idle_since > idle_timeout)
+                    expired.push_back(fd);
+            } else if (connection->request && connection->request->deadline < now) {
+                // timed out request is not retried
+                connection->request->retried = true;
+                expired.push_back(fd);
+            }
+        }
+        for (int fd : expired)
+            if (auto it = connections.find(fd); it != connections.end())
+                close(*it->second);
+        // requests waiting for a connection
+        for (auto &[key, host] : hosts) {
+            auto &pending = host->pending;
+            while (!pending.empty() && pending.front().deadline < now) {
+                fail(pending.front());
+                pending.pop_front();
+            }
+        }
+    }
+
+    void loop() {
+        std::vector<epoll_event> events(256);
+        auto next_check = clock_type::now() + tick;
+        while (!stop) {
+            const int count = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()),
+                                         static_cast<int>(tick.count()));
+            for (int i = 0; i < count; ++i) {
+                if (events[i].data.fd == wake_fd) {
+                    takeSubmitted();
+                    continue;
+                }
+                // connection may be closed while handling previous events
+                if (auto it = connections.find(events[i].data.fd); it != connections.end())
+                    handle(*it->second, events[i].events);
+            }
+            if (clock_type::now() >= next_check) {
+                checkTimeouts();
+                next_check = clock_type::now() + tick;
+            }
+        }
+    }
+};
+
+AsyncHttpClient::AsyncHttpClient() : impl{std::make_unique<Impl>()} {
+}
+
+AsyncHttpClient::~AsyncHttpClient() = default;
+
+bool AsyncHttpClient::supported() noexcept {
+    return true;
+}
+
+void AsyncHttpClient::post(const std::string &url, const httplib::Headers &headers,
+                           std::string_view body, std::string_view content_type,
+                           Callback callback) {
+    auto parsed = parseUrl(url);
+    if (!parsed) {
+        utility::Logger::warn(fmt::format("Not valid url: {}", url));
+        return callback(nullptr);
+    }
+    Request request;
+    const bool default_port = !parsed->socket.empty() || parsed->port == (parsed->tls ? 443 : 80);
+    request.data = fmt::format("POST {} HTTP/1.1\r\nHost: {}{}\r\nContent-Type: {}\r\n"
+                               "Content-Length: {}\r\nConnection: keep-alive\r\n",
+                               parsed->target, parsed->host,
+                               default_port ? std::string{} : ':' + std::to_string(parsed->port),
+                               content_type, body.size());
+    for (const auto &[name, value] : headers)
+        request.data += fmt::format("{}: {}\r\n", name, value);
+    request.data += "\r\n";
+    request.data += body;
+    request.url = std::move(*parsed);
+    request.callback = std::move(callback);
+    request.deadline = clock_type::now() + std::chrono::seconds(impl->timeout_seconds.load());
+    impl->submit(std::move(request));
+}
+
+std::future<std::shared_ptr<httplib::Response>>
+AsyncHttpClient::post(const std::string &url, const httplib::Headers &headers,
+                      std::string_view body, std::string_view content_type) {
+    auto promise = std::make_shared<std::promise<std::shared_ptr<httplib::Response>>>();
+    auto future = promise->get_future();
+    post(url, headers, body, content_type,
+         [promise](std::shared_ptr<httplib::Response> response) {
+             promise->set_value(std::move(response));
+         });
+    return future;
+}
+
+void AsyncHttpClient::setMaxConnectionsPerHost(std::size_t count) {
+    impl->max_connections = std::max<std::size_t>(count, 1);
+}
+
+void AsyncHttpClient::setTimeout(std::chrono::seconds timeout) {
+    impl->timeout_seconds = timeout.count();
+}
+
+void AsyncHttpClient::setIdleTimeout(std::chrono::seconds timeout) {
+    impl->idle_timeout_seconds = timeout.count();
+}
+
+void AsyncHttpClient::setMaxRequestsPerConnection(std::size_t count) {
+    impl->max_requests = std::max<std::size_t>(count, 1);
+}
+
+#else
+
+using namespace telegram;
+
+struct AsyncHttpClient::Impl {};
+
+AsyncHttpClient::AsyncHttpClient() {
+    throw std::runtime_error("AsyncHttpClient is not supported on this platform");
+}
+
+AsyncHttpClient::~AsyncHttpClient() = default;
+
+bool AsyncHttpClient::supported() noexcept {
+    return false;
+}
+
+void AsyncHttpClient::post(const std::string &, const httplib::Headers &, std::string_view,
+                           std::string_view, Callback callback) {
+    callback(nullptr);
+}
+
+std::future<std::shared_ptr<httplib::Response>>
+AsyncHttpClient::post(const std::string &, const httplib::Headers &, std::string_view,
+                      std::string_view) {
+    std::promise<std::shared_ptr<httplib::Response>> promise;
+    promise.set_value(nullptr);
+    return promise.get_future();
+}
+
+void AsyncHttpClient::setMaxConnectionsPerHost(std::size_t) {
+}
+
+void AsyncHttpClient::setTimeout(std::chrono::seconds) {
+}
+
+void AsyncHttpClient::setIdleTimeout(std::chrono::seconds) {
+}
+
+void AsyncHttpClient::setMaxRequestsPerConnection(std::size_t) {
+}
+
+#endif
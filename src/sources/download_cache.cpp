@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <fstream>
+#include <system_error>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "headers/download_cache.h"
+#include "utility/logger.h"
+
+using namespace telegram;
+
+namespace {
+constexpr std::string_view partial_extension = ".part";
+} // namespace
+
+DownloadCache::DownloadCache(fs::path directory, std::uintmax_t capacity)
+    : directory{directory.empty() ? defaultDirectory() : directory}, capacity{capacity},
+      private_directory{directory.empty()} {
+}
+
+fs::path DownloadCache::defaultDirectory() {
+    std::error_code error;
+    auto temporary = fs::temp_directory_path(error);
+#ifndef _WIN32
+    // the temporary directory is shared, so every user has its own cache
+    const auto name = "tgbot_files-" + std::to_string(::geteuid());
+#else
+    // the temporary directory is in the profile of the user
+    const std::string name = "tgbot_files";
+#endif
+    return (error ? fs::path(".") : temporary) / name;
+}
+
+bool DownloadCache::makePrivateDirectory(const fs::path &path) {
+#ifndef _WIN32
+    if (::mkdir(path.c_str(), 0700) != 0 && errno != EEXIST)
+        return false;
+    // the directory could be made by someone else beforehand, e.g to read or replace files
+    struct stat info {};
+    return ::lstat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode) &&
+           info.st_uid == ::geteuid() && (info.st_mode & 077) == 0;
+#else
+    std::error_code error;
+    fs::create_directories(path, error);
+    return fs::is_directory(path, error);
+#endif
+}
+
+void DownloadCache::configure(fs::path new_directory, std::uintmax_t new_capacity) {
+    const bool is_default = new_directory.empty();
+    if (is_default)
+        new_directory = defaultDirectory();
+    std::unique_lock lock(mutex);
+    if (new_directory != directory) {
+        directory = std::move(new_directory);
+        private_directory = is_default;
+        entries.clear();
+        total = 0;
+        loaded = false;
+        ++generation;
+    }
+    capacity = new_capacity;
+    if (loaded)
+        evict();
+}
+
+DownloadCache::Lease DownloadCache::find(const std::string &key) {
+    std::unique_lock lock(mutex);
+    load();
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return nullptr;
+    std::error_code error;
+    // the file could be removed by someone else
+    if (!fs::exists(location(key), error)) {
+        total -= it->second.size;
+        entries.erase(it);
+        return nullptr;
+    }
+    return lease(key, it->second);
+}
+
+fs::path DownloadCache::partial(const std::string &key) {
+    std::unique_lock lock(mutex);
+    load();
+    if (!usable)
+        return {};
+    std::error_code error;
+    fs::create_directories(directory, error);
+    auto path = location(key);
+    path += partial_extension;
+    return path;
+}
+
+DownloadCache::Lease DownloadCache::commit(const std::string &key) {
+    std::unique_lock lock(mutex);
+    load();
+    if (!usable)
+        return nullptr;
+    auto path = location(key);
+    auto part = path;
+    part += partial_extension;
+    std::error_code error;
+    const auto size = fs::file_size(part, error);
+    if (!error)
+        fs::rename(part, path, error);
+    if (error) {
+        utility::Logger::warn("Unable to store downloaded file ", path.string(), ": ",
+                              error.message());
+        return nullptr;
+    }
+    auto &entry = entries[key];
+    total = total - entry.size + size;
+    entry.size = size;
+    auto file = lease(key, entry);
+    evict();
+    return file;
+}
+
+std::uintmax_t DownloadCache::size() const {
+    std::unique_lock lock(mutex);
+    return total;
+}
+
+void DownloadCache::load() {
+    if (loaded)
+        return;
+    loaded = true;
+    usable = !private_directory || makePrivateDirectory(directory);
+    if (!usable) {
+        utility::Logger::warn("Download cache directory ", directory.string(),
+                              " is accessible by other users, set a directory with "
+                              "Bot::setDownloadCache");
+        return;
+    }
+    std::error_code error;
+    const auto now = clock::now();
+    const auto file_now = fs::file_time_type::clock::now();
+    for (auto it = fs::directory_iterator(directory, error); !error && it != fs::directory_iterator();
+         it.increment(error)) {
+        std::error_code skipped;
+        if (!it->is_regular_file(skipped) || it->path().extension() == partial_extension)
+            continue;
+        const auto size = it->file_size(skipped);
+        const auto modified = it->last_write_time(skipped);
+        if (skipped)
+            continue;
+        auto &entry = entries[it->path().filename().string()];
+        entry.size = size;
+        // files written earlier are evicted first
+        entry.used = now - std::chrono::duration_cast<clock::duration>(file_now - modified);
+        total += entry.size;
+    }
+    evict();
+}
+
+DownloadCache::Lease DownloadCache::lease(const std::string &key, Entry &entry) {
+    ++entry.readers;
+    entry.used = clock::now();
+    std::weak_ptr<DownloadCache *> cache = self;
+    return Lease(new fs::path(location(key)),
+                 [cache, key, generation = generation](const fs::path *path) {
+                     if (auto alive = cache.lock())
+                         (*alive)->release(key, generation);
+                     delete path;
+                 });
+}
+
+void DownloadCache::release(const std::string &key, std::size_t lease_generation) {
+    std::unique_lock lock(mutex);
+    if (lease_generation != generation)
+        return;
+    auto it = entries.find(key);
+    if (it == entries.end() || !it->second.readers)
+        return;
+    --it->second.readers;
+    it->second.used = clock::now();
+    if (!it->second.readers)
+        evict();
+}
+
+void DownloadCache::evict() {
+    while (total > capacity) {
+        auto oldest = entries.end();
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (!it->second.readers && (oldest == entries.end() || it->second.used < oldest->second.used))
+                oldest = it;
+        }
+        // the rest is in use
+        if (oldest == entries.end())
+            return;
+        std::error_code error;
+        fs::remove(location(oldest->first), error);
+        total -= oldest->second.size;
+        entries.erase(oldest);
+    }
+}
+
+fs::path DownloadCache::location(const std::string &key) const {
+    // file_unique_id is made of these characters, others can not escape the directory
+    std::string name = key;
+    for (auto &c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_')
+            c = '_';
+    }
+    return directory / name;
+}
+
+MappedFile::MappedFile(DownloadCache::Lease file) {
+    if (!file)
+        return;
+#ifndef _WIN32
+    const int fd = ::open(file->c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat info {};
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void *ptr = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr != MAP_FAILED) {
+            bytes = static_cast<const char *>(ptr);
+            length = static_cast<std::size_t>(info.st_size);
+        }
+    }
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    if (!bytes && info.st_size > 0)
+        return;
+#else
+    std::ifstream in(*file, std::ios::binary);
+    if (!in)
+        return;
+    contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    bytes = contents.data();
+    length = contents.size();
+#endif
+    lease = std::move(file);
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this == &other)
+        return *this;
+    unmap();
+    lease = std::move(other.lease);
+#ifdef _WIN32
+    contents = std::move(other.contents);
+    bytes = contents.data();
+#else
+    bytes = other.bytes;
+#endif
+    length = other.length;
+    other.bytes = nullptr;
+    other.length = 0;
+    return *this;
+}
+
+void MappedFile::unmap() noexcept {
+#ifndef _WIN32
+    if (bytes)
+        munmap(const_cast<char *>(bytes), length);
+#endif
+    bytes = nullptr;
+    length = 0;
+    lease.reset();
+}
@@ -0,0 +1,148 @@
+#include <fstream>
+#include <system_error>
+
+#include "headers/file_downloader.h"
+
+using namespace telegram;
+
+namespace {
+/// size of a file, 0 if it does not exist
+std::uintmax_t sizeOf(const fs::path &path) {
+    std::error_code error;
+    const auto size = fs::file_size(path, error);
+    return error ? 0 : size;
+}
+
+/// drop bytes received after 'size', e.g an error page appended to the file
+void truncate(const fs::path &path, std::uintmax_t size) {
+    std::error_code error;
+    if (size)
+        fs::resize_file(path, size, error);
+    else
+        fs::remove(path, error);
+}
+} // namespace
+
+FileDownloader::FileDownloader(std::string url) : url{std::move(url)} {
+}
+
+bool FileDownloader::setServer(const ApiServer &server, std::string file_url) {
+    if (!NetworkManager::supports(server) || !network.setServer(server))
+        return false;
+    url = std::move(file_url);
+    local = server.local;
+    return true;
+}
+
+FileDownloader::Result FileDownloader::fetch(const std::string &key, const std::string &path,
+                                             std::optional<int64_t> size) {
+    if (local && fs::path(path).is_absolute()) {
+        std::error_code error;
+        if (!fs::is_regular_file(path, error))
+            return {nullptr, static_cast<int32_t>(ErrorCodes::NotValid),
+                    "File " + path + " of the local server can not be read"};
+        return {std::make_shared<const fs::path>(path)};
+    }
+    if (auto file = files.find(key))
+        return {std::move(file)};
+    std::promise<Result> promise;
+    {
+        std::unique_lock lock(mutex);
+        if (auto it = in_flight.find(key); it != in_flight.end()) {
+            auto pending = it->second;
+            lock.unlock();
+            return pending.get();
+        }
+        in_flight.emplace(key, promise.get_future().share());
+    }
+    Result result;
+    try {
+        // the file could be stored while the lock was not held
+        result.file = files.find(key);
+        if (!result.file)
+            result = download(key, path, size);
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+        std::unique_lock lock(mutex);
+        in_flight.erase(key);
+        throw;
+    }
+    promise.set_value(result);
+    std::unique_lock lock(mutex);
+    in_flight.erase(key);
+    return result;
+}
+
+FileDownloader::Result FileDownloader::download(const std::string &key, const std::string &path,
+                                                std::optional<int64_t> size) {
+    if (!network.blockingSupported())
+        return {nullptr, static_cast<int32_t>(ErrorCodes::NotValid),
+                "Files can not be downloaded over unix socket, run the server in local mode"};
+    const auto part = files.partial(key);
+    if (part.empty())
+        return {nullptr, static_cast<int32_t>(ErrorCodes::NotValid),
+                "Download cache directory can not be used"};
+    // an empty file is complete before anything is received
+    std::ofstream(part, std::ios::binary | std::ios::app);
+    const auto expected = size ? std::optional<std::uintmax_t>(static_cast<std::uintmax_t>(*size))
+                               : std::nullopt;
+    bool complete = false;
+    // attempts are counted only when nothing was received
+    for (int attempt = 0; attempt < max_attempts && !complete;) {
+        const auto offset = sizeOf(part);
+        if (expected && offset >= *expected) {
+            complete = offset == *expected;
+            if (complete)
+                break;
+            truncate(part, 0);
+            continue;
+        }
+        std::ofstream out(part, std::ios::binary | std::ios::app);
+        if (!out)
+            return {nullptr, static_cast<int32_t>(ErrorCodes::NotValid),
+                    "Unable to write " + part.string()};
+        httplib::Headers headers;
+        if (offset)
+            headers.emplace("Range", "bytes=" + std::to_string(offset) + '-');
+        auto reply = network.get(url + path, headers, [&out](const char *data, std::size_t length) {
+            return static_cast<bool>(out.write(data, static_cast<std::streamsize>(length)));
+        });
+        const bool written = static_cast<bool>(out.flush());
+        out.close();
+        if (!written) {
+            truncate(part, offset);
+            return {nullptr, static_cast<int32_t>(ErrorCodes::NotValid),
+                    "Unable to write " + part.string()};
+        }
+        const auto received = sizeOf(part);
+        if (!reply) {
+            // connection was broken, the rest is requested from the received size
+            if (received == offset)
+                ++attempt;
+            else
+                attempt = 0;
+            continue;
+        }
+        if (reply->status == 206 || (reply->status == 200 && !offset)) {
+            complete = !expected || received == *expected;
+            attempt = received > offset ? 0 : attempt + 1;
+            continue;
+        }
+        // the body is not a part of the file
+        truncate(part, offset);
+        if ((reply->status == 200 || reply->status == 416) && offset) {
+            // range is ignored or does not match the file, download it from the start
+            truncate(part, 0);
+            ++attempt;
+            continue;
+        }
+        return {nullptr, reply->status, "Unable to download " + path};
+    }
+    if (!complete)
+        return {nullptr, static_cast<int32_t>(ErrorCodes::UnableToMakeRequest),
+                "Unable to download " + path};
+    if (auto file = files.commit(key))
+        return {std::move(file)};
+    return {nullptr, static_cast<int32_t>(ErrorCodes::NotValid),
+            "Unable to store " + path + " in " + part.parent_path().string()};
+}
@@ -0,0 +1,174 @@
+#include <system_error>
+
+#include "headers/file_id_cache.h"
+
+using namespace telegram;
+
+namespace {
+/// first line of the index, followed by the owner
+constexpr std::string_view index_header = "tgbot-file-ids 1 ";
+} // namespace
+
+FileIdCache::FileIdCache(std::size_t capacity) : capacity{capacity} {
+}
+
+std::optional<std::string> FileIdCache::key(const fs::path &file) {
+    std::error_code error;
+    const auto size = fs::file_size(file, error);
+    if (error)
+        return {};
+    const auto modified = fs::last_write_time(file, error);
+    if (error)
+        return {};
+    auto path = fs::absolute(file, error).string();
+    // one line of the index holds one entry
+    if (error || path.find('\n') != std::string::npos)
+        return {};
+    return std::to_string(size) + ':' +
+           std::to_string(modified.time_since_epoch().count()) + ':' + path;
+}
+
+bool FileIdCache::setIndex(const fs::path &path, const std::string &bot) {
+    std::unique_lock lock(mutex);
+    index.close();
+    index_path = path;
+    owner = bot;
+    logged = 0;
+    if (std::ifstream stored(path); stored) {
+        std::string line;
+        if (std::getline(stored, line) && line == std::string(index_header) + owner) {
+            // lines are "file_id\tkey", later lines override earlier ones
+            while (std::getline(stored, line)) {
+                const auto separator = line.find('\t');
+                if (separator == std::string::npos)
+                    continue;
+                auto file_key = line.substr(separator + 1);
+                if (separator == 0)
+                    remove(file_key);
+                else
+                    put(file_key, line.substr(0, separator));
+                ++logged;
+            }
+        }
+    }
+    trim();
+    // the index is rewritten, so entries of other bots and removed entries are dropped
+    compact();
+    if (!index.is_open()) {
+        utility::Logger::warn("File id index ", path.string(), " can not be written");
+        index_path.clear();
+        return false;
+    }
+    return true;
+}
+
+void FileIdCache::setCapacity(std::size_t new_capacity) {
+    std::unique_lock lock(mutex);
+    capacity = new_capacity;
+    trim();
+}
+
+std::optional<std::string> FileIdCache::find(const fs::path &file) {
+    {
+        std::unique_lock lock(mutex);
+        if (!capacity || entries.empty())
+            return {};
+    }
+    auto file_key = key(file);
+    if (!file_key)
+        return {};
+    std::unique_lock lock(mutex);
+    auto it = positions.find(*file_key);
+    if (it == positions.end())
+        return {};
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+}
+
+void FileIdCache::insert(const fs::path &file, const std::string &file_id) {
+    if (file_id.empty() || file_id.find_first_of("\t\n") != std::string::npos)
+        return;
+    auto file_key = key(file);
+    if (!file_key)
+        return;
+    std::unique_lock lock(mutex);
+    if (!capacity)
+        return;
+    put(*file_key, file_id);
+    log(*file_key, file_id);
+    trim();
+}
+
+void FileIdCache::erase(const fs::path &file) {
+    auto file_key = key(file);
+    if (!file_key)
+        return;
+    std::unique_lock lock(mutex);
+    if (positions.count(*file_key)) {
+        remove(*file_key);
+        log(*file_key, {});
+    }
+}
+
+std::size_t FileIdCache::size() const {
+    std::unique_lock lock(mutex);
+    return entries.size();
+}
+
+void FileIdCache::put(const std::string &file_key, const std::string &file_id) {
+    if (auto it = positions.find(file_key); it != positions.end()) {
+        it->second->second = file_id;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    entries.emplace_front(file_key, file_id);
+    positions[file_key] = entries.begin();
+}
+
+void FileIdCache::remove(const std::string &file_key) {
+    if (auto it = positions.find(file_key); it != positions.end()) {
+        entries.erase(it->second);
+        positions.erase(it);
+    }
+}
+
+void FileIdCache::trim() {
+    while (entries.size() > capacity) {
+        positions.erase(entries.back().first);
+        entries.pop_back();
+    }
+    if (logged > 2 * std::max<std::size_t>(entries.size(), 1024))
+        compact();
+}
+
+void FileIdCache::log(const std::string &file_key, const std::string &file_id) {
+    if (!index.is_open())
+        return;
+    index << file_id << '\t' << file_key << '\n';
+    // entries are written at once, so they survive a crash
+    index.flush();
+    ++logged;
+}
+
+void FileIdCache::compact() {
+    if (index_path.empty())
+        return;
+    index.close();
+    auto temporary = index_path;
+    temporary += ".tmp";
+    {
+        std::ofstream rewritten(temporary, std::ios::trunc);
+        rewritten << index_header << owner << '\n';
+        // the least recently used first, so they are evicted first after loading
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+            rewritten << it->second << '\t' << it->first << '\n';
+        if (!rewritten.flush())
+            return;
+    }
+    std::error_code error;
+    fs::rename(temporary, index_path, error);
+    if (error)
+        return;
+    logged = entries.size();
+    index.open(index_path, std::ios::app);
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <random>
+
+#include "headers/multipart_body.h"
+
+using namespace telegram;
+
+namespace {
+constexpr std::string_view crlf = "\r\n";
+
+/// quotes are not allowed in values of Content-Disposition parameters
+std::string escapeQuotes(std::string_view value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '"')
+            escaped += "%22";
+        else if (c == '\r' || c == '\n')
+            escaped += ' ';
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+std::string randomBoundary() {
+    constexpr std::string_view alphabet =
+        "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    thread_local std::mt19937 engine{std::random_device{}()};
+    std::uniform_int_distribution<std::size_t> distribution(0, alphabet.size() - 1);
+    std::string boundary = "--------------------------tgbot";
+    for (int i = 0; i < 16; ++i)
+        boundary += alphabet[distribution(engine)];
+    return boundary;
+}
+} // namespace
+
+MultipartBody::MultipartBody() : boundary{randomBoundary()} {
+}
+
+void MultipartBody::append(std::string_view text) {
+    // adjacent pieces of text are kept in one segment
+    if (segments.empty() || !segments.back().file.empty() || segments.back().data)
+        segments.push_back({{}, {}, nullptr, 0, total});
+    segments.back().text += text;
+    segments.back().size += text.size();
+    total += text.size();
+}
+
+void MultipartBody::appendBoundary() {
+    append("--");
+    append(boundary);
+    append(crlf);
+}
+
+std::string MultipartBody::closing() const {
+    return "--" + boundary + "--" + std::string(crlf);
+}
+
+void MultipartBody::addField(std::string_view name, std::string_view value) {
+    appendBoundary();
+    append("Content-Disposition: form-data; name=\"" + escapeQuotes(name) + '"');
+    append(crlf);
+    append(crlf);
+    append(value);
+    append(crlf);
+}
+
+bool MultipartBody::addFile(std::string_view name, const fs::path &path,
+                            std::string_view filename) {
+    std::error_code error;
+    const auto file_size = fs::file_size(path, error);
+    if (error)
+        return false;
+    addFile(name, path, file_size, filename);
+    return true;
+}
+
+void MultipartBody::addFile(std::string_view name, const fs::path &path, std::uintmax_t size,
+                            std::string_view filename) {
+    appendFileHeader(name, filename);
+    segments.push_back({{}, path, nullptr, static_cast<std::size_t>(size), total});
+    total += static_cast<std::size_t>(size);
+    append(crlf);
+}
+
+void MultipartBody::addMemory(std::string_view name, const char *data, std::size_t size,
+                              std::string_view filename) {
+    appendFileHeader(name, filename);
+    if (size) {
+        segments.push_back({{}, {}, data, size, total});
+        total += size;
+    }
+    append(crlf);
+}
+
+void MultipartBody::appendFileHeader(std::string_view name, std::string_view filename) {
+    appendBoundary();
+    append("Content-Disposition: form-data; name=\"" + escapeQuotes(name) +
+           "\"; filename=\"" + escapeQuotes(filename) + '"');
+    append(crlf);
+    append("Content-Type: ");
+    append(utility::toString(ContentTypes::application_octet_stream));
+    append(crlf);
+    append(crlf);
+}
+
+std::string MultipartBody::contentType() const {
+    return std::string(utility::toString(ContentTypes::multipart_form_data)) +
+           "; boundary=" + boundary;
+}
+
+std::size_t MultipartBody::size() const {
+    return total + closing().size();
+}
+
+std::size_t MultipartBody::read(std::size_t offset, const Writer &write) {
+    if (offset >= size())
+        return 0;
+    if (offset >= total) {
+        const auto tail = closing();
+        const auto position = offset - total;
+        write(tail.data() + position, tail.size() - position);
+        return tail.size() - position;
+    }
+    // the last segment that starts not after 'offset'
+    auto it = std::upper_bound(segments.begin(), segments.end(), offset,
+                               [](std::size_t value, const Segment &segment) {
+                                   return value < segment.offset;
+                               });
+    const auto index = static_cast<std::size_t>(std::distance(segments.begin(), it)) - 1;
+    const auto &segment = segments[index];
+    const auto position = offset - segment.offset;
+    if (!segment.file.empty())
+        return readFile(index, position, write);
+    const auto length = std::min(segment.size - position, chunk_size);
+    write((segment.data ? segment.data : segment.text.data()) + position, length);
+    return length;
+}
+
+std::size_t MultipartBody::readFile(std::size_t index, std::size_t position,
+                                    const Writer &write) {
+    const auto &segment = segments[index];
+    const auto length = std::min(segment.size - position, chunk_size);
+    buffer.resize(chunk_size);
+    // the body is usually written sequentially, the file is reopened or seeked otherwise
+    if (stream_segment != index || stream_position != position || !stream) {
+        stream.close();
+        stream.clear();
+        stream.open(segment.file, std::ios::in | std::ios::binary);
+        stream.seekg(static_cast<std::streamoff>(position));
+        stream_segment = index;
+    }
+    stream.read(buffer.data(), static_cast<std::streamsize>(length));
+    const auto received = static_cast<std::size_t>(std::max<std::streamsize>(stream.gcount(), 0));
+    if (received < length) {
+        if (!read_failed)
+            utility::Logger::warn("Failed to read file ", segment.file.string(),
+                                  " while it is being uploaded");
+        read_failed = true;
+        std::fill(buffer.begin() + static_cast<std::ptrdiff_t>(received),
+                  buffer.begin() + static_cast<std::ptrdiff_t>(length), '\0');
+    }
+    stream_position = position + length;
+    write(buffer.data(), length);
+    return length;
+}
@@ -1,28 +1,333 @@
+#include <algorithm>
+#include <cctype>
+#include <type_traits>
+#include <fmt/format.h>
+
 #include "headers/networkmanager.h"
+#include "utility/threadpool.h"
 
 using namespace telegram;
 using namespace telegram::utility;
-NetworkManager::NetworkManager(const char *host) : cli{host} {
-  cli.set_follow_location(true);
+namespace {
+/// larger buffers are released after use, so a single big request does not stay in memory
+constexpr std::size_t max_kept_buffer = 64 * 1024;
+
+/// prepare a pooled response for the next request
+void recycle(httplib::Response &response) {
+  response.version.clear();
+  response.status = -1;
+  response.headers.clear();
+  if (response.body.capacity() > max_kept_buffer)
+    std::string().swap(response.body);
+  else
+    response.body.clear();
+}
+
+/**
+ * POST request of the calling thread
+ * Its strings keep their memory between requests and headers are rebuilt only when they
+ * differ from the previous request, so a usual call does not allocate here
+ */
+httplib::Request &threadRequest(std::string_view path, const httplib::Headers &headers,
+                                std::string_view body, std::string_view content_type) {
+  thread_local httplib::Request request;
+  // headers of the request are 'Content-Type' of this value only
+  thread_local std::string plain_content_type;
+  thread_local bool plain = false;
+  request.method = "POST";
+  request.path.assign(path.data(), path.size());
+  if (!headers.empty() || !plain || plain_content_type != content_type) {
+    request.headers = headers;
+    request.headers.emplace("Content-Type", std::string(content_type));
+    plain = headers.empty();
+    plain_content_type.assign(content_type.data(), content_type.size());
+  }
+  request.body.assign(body.data(), body.size());
+  return request;
+}
+
+/// httplib passes data sink either as a callable or as an object with 'write' member
+template <class Sink>
+void writeTo(Sink &sink, const char *data, std::size_t size) {
+  if constexpr (std::is_invocable_v<Sink &, const char *, std::size_t>)
+    sink(data, size);
+  else
+    sink.write(data, size);
+}
+} // namespace
+
+class NetworkManager::Lease {
+  NetworkManager *manager;
+  std::unique_ptr<Connection> connection;
+public:
+  Lease(NetworkManager *manager, std::unique_ptr<Connection> connection)
+      : manager{manager}, connection{std::move(connection)} {
+  }
+  Lease(Lease &&) = default;
+  ~Lease() {
+    if (connection)
+      manager->release(std::move(connection));
+  }
+  httplib::Client &operator*() {
+    return *connection->client;
+  }
+  httplib::Client *operator->() {
+    return connection->client.get();
+  }
+};
+
+NetworkManager::NetworkManager(const char *host) : host{host} {
+  // blocking clients can not keep connections alive, see NetworkManager
+  if (AsyncHttpClient::supported()) {
+    try {
+      setEventLoopBackend(true);
+    } catch (const std::exception &e) {
+      Logger::warn("Event loop transport is not available: ", e.what());
+    }
+  }
+}
+
+NetworkManager::~NetworkManager() = default;
+
+std::unique_ptr<NetworkManager::Connection> NetworkManager::connect() {
+  auto connection = std::make_unique<Connection>();
+  if (!origin) {
+    connection->client = std::make_unique<httplib::Client>(host.data());
+  } else if (origin->tls) {
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+    connection->client = std::make_unique<httplib::SSLClient>(origin->host.data(), origin->port);
+#endif
+  } else {
+    connection->client = std::make_unique<httplib::Client>(origin->host.data(), origin->port);
+  }
+  connection->client->set_follow_location(true);
+  if (read_timeout.count())
+    connection->client->set_read_timeout(static_cast<time_t>(read_timeout.count()), 0);
+  return connection;
+}
+
+NetworkManager::Lease NetworkManager::checkout() {
+  std::unique_lock lock(pool_mutex);
+  for (;;) {
+    if (!idle.empty()) {
+      auto connection = std::move(idle.back());
+      idle.pop_back();
+      if (read_timeout.count())
+        connection->client->set_read_timeout(static_cast<time_t>(read_timeout.count()), 0);
+      return {this, std::move(connection)};
+    }
+    if (open < max_connections) {
+      ++open;
+      lock.unlock();
+      try {
+        return {this, connect()};
+      } catch (...) {
+        lock.lock();
+        --open;
+        throw;
+      }
+    }
+    pool_condition.wait(lock);
+  }
+}
+
+void NetworkManager::release(std::unique_ptr<Connection> connection) {
+  {
+    std::unique_lock lock(pool_mutex);
+    if (open > max_connections)
+      --open;
+    else
+      idle.push_back(std::move(connection));
+  }
+  pool_condition.notify_one();
+  // connection that was not returned is closed here, outside of the lock
+}
+
+void NetworkManager::setReadTimeout(std::chrono::seconds timeout) {
+  // applied to connections when they are checked out
+  std::unique_lock lock(pool_mutex);
+  read_timeout = timeout;
+  if (async_client && timeout.count())
+    async_client->setTimeout(timeout);
+}
+
+bool NetworkManager::setEventLoopBackend(bool enable) {
+  if (!enable) {
+    async_client.reset();
+    return true;
+  }
+  if (!AsyncHttpClient::supported()) {
+    Logger::warn("Event loop transport is not supported on this platform");
+    return false;
+  }
+  if (!async_client) {
+    async_client = std::make_unique<AsyncHttpClient>();
+    async_client->setMaxConnectionsPerHost(max_connections);
+    async_client->setIdleTimeout(idle_timeout);
+    async_client->setMaxRequestsPerConnection(max_requests);
+    if (read_timeout.count())
+      async_client->setTimeout(read_timeout);
+  }
+  return true;
+}
+
+std::optional<NetworkManager::Origin> NetworkManager::parseServer(const ApiServer &server) {
+  const auto scheme_end = server.url.find("://");
+  const auto scheme = server.url.substr(0, scheme_end);
+  if (scheme_end == std::string::npos || (scheme != "http" && scheme != "https")) {
+    Logger::warn("Not valid server url: ", server.url);
+    return {};
+  }
+  Origin next;
+  next.tls = scheme == "https";
+  next.port = next.tls ? 443 : 80;
+  auto authority = server.url.substr(scheme_end + 3);
+  authority.resize(std::min(authority.find('/'), authority.size()));
+  next.prefix = server.url.substr(0, scheme_end + 3 + authority.size());
+  if (const auto colon = authority.rfind(':'); colon != std::string::npos) {
+    const auto port = authority.substr(colon + 1);
+    if (port.empty() || port.size() > 5 ||
+        !std::all_of(port.begin(), port.end(), [](unsigned char c) { return std::isdigit(c); })) {
+      Logger::warn("Not valid port of server url: ", server.url);
+      return {};
+    }
+    next.port = std::stoi(port);
+    authority.resize(colon);
+  }
+  next.host = authority;
+  next.unix_socket = server.unix_socket;
+  if (next.unix_socket.empty()) {
+#ifndef CPPHTTPLIB_OPENSSL_SUPPORT
+    if (next.tls) {
+      Logger::warn("HTTPS server requires the library to be built with OpenSSL: ", server.url);
+      return {};
+    }
+#endif
+  } else if (!AsyncHttpClient::supported()) {
+    Logger::warn("Event loop transport is not supported on this platform");
+    return {};
+  }
+  return next;
+}
+
+bool NetworkManager::supports(const ApiServer &server) {
+  return parseServer(server).has_value();
+}
+
+bool NetworkManager::setServer(const ApiServer &server) {
+  auto next = parseServer(server);
+  if (!next || (!next->unix_socket.empty() && !setEventLoopBackend(true)))
+    return false;
+  {
+    std::unique_lock lock(pool_mutex);
+    origin = std::move(*next);
+    // connections to the previous server
+    open -= idle.size();
+    idle.clear();
+  }
+  return true;
+}
+
+std::string_view NetworkManager::target(const std::string &url) const {
+  std::string_view path = url;
+  if (origin && url.compare(0, origin->prefix.size(), origin->prefix) == 0)
+    path.remove_prefix(origin->prefix.size());
+  return path;
+}
+
+bool NetworkManager::blockingSupported() const noexcept {
+  return !origin || origin->unix_socket.empty();
+}
+
+bool NetworkManager::blockingSupported(const std::string &url) const {
+  if (blockingSupported())
+    return true;
+  Logger::warn("Request to ", url, " can not be sent over unix socket ", origin->unix_socket);
+  return false;
+}
+
+std::string NetworkManager::absoluteUrl(const std::string &url) const {
+  if (origin && !origin->unix_socket.empty()) {
+    std::string socket;
+    for (unsigned char c : origin->unix_socket) {
+      if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~')
+        socket += static_cast<char>(c);
+      else
+        socket += fmt::format("%{:02X}", c);
+    }
+    const auto path = target(url);
+    return "http+unix://" + socket + (path.empty() || path.front() != '/' ? "/" : "") +
+           std::string(path);
+  }
+  // relative urls are resolved against the host, like httplib::Client does
+  if (!url.empty() && url.front() == '/')
+    return "http://" + host + url;
+  return url;
+}
+
+void NetworkManager::postAsync(const std::string &url, const httplib::Headers &headers,
+                               std::string_view body, std::string_view content_type,
+                               AsyncHttpClient::Callback callback) {
+  if (async_client)
+    return async_client->post(absoluteUrl(url), headers, body, content_type,
+                              std::move(callback));
+  callback(post(url, headers, body, content_type));
+}
+
+void NetworkManager::setPoolSize(std::size_t size) {
+  {
+    std::unique_lock lock(pool_mutex);
+    max_connections = std::max<std::size_t>(size, 1);
+    if (async_client)
+      async_client->setMaxConnectionsPerHost(max_connections);
+    while (open > max_connections && !idle.empty()) {
+      idle.erase(idle.begin());
+      --open;
+    }
+  }
+  pool_condition.notify_all();
+}
+
+void NetworkManager::setIdleTimeout(std::chrono::seconds timeout) {
+  std::unique_lock lock(pool_mutex);
+  idle_timeout = timeout;
+  if (async_client)
+    async_client->setIdleTimeout(timeout);
+}
+
+void NetworkManager::setMaxRequestsPerConnection(std::size_t count) {
+  std::unique_lock lock(pool_mutex);
+  max_requests = std::max<std::size_t>(count, 1);
+  if (async_client)
+    async_client->setMaxRequestsPerConnection(max_requests);
 }
 
 std::shared_ptr<httplib::Response>
 NetworkManager::post(const std::string &url,
                      const httplib::Headers &headers,
-                     const std::string &body ,
-                     const std::string &content_type) {
-  auto reply = cli.Post(url.data(), headers, body, content_type.data());
-  if (reply && reply->status) {
-      // check if status is redirection
-    if (reply->status == std::clamp(reply->status,
-                                    static_cast<int>(http::redirection),
-                                    static_cast<int>(http::client_error))) {
-        // follow the redirection
-      reply = cli.Post(url.data(), headers, body, content_type.data());
-    }
+                     std::string_view body,
+                     std::string_view content_type) {
+  // let the pool start another worker while this one waits for network
+  ThreadPool::BlockingScope blocking;
+  if (async_client)
+    return async_client->post(absoluteUrl(url), headers, body, content_type).get();
+  auto cli = checkout();
+  auto &request = threadRequest(target(url), headers, body, content_type);
+  auto reply = responses.acquire(recycle);
+  bool sent = cli->send(request, *reply);
+  // check if status is redirection
+  if (sent && reply->status == std::clamp(reply->status,
+                                          static_cast<int>(http::redirection),
+                                          static_cast<int>(http::client_error))) {
+    // follow the redirection
+    recycle(*reply);
+    sent = cli->send(request, *reply);
+  }
+  if (request.body.capacity() > max_kept_buffer)
+    std::string().swap(request.body);
+  if (sent && reply->status > 0)
     return reply;
-  } else
-    return {};
+  return {};
 }
 
 uint32_t NetworkManager::ipv4(const std::string& s) {
@@ -51,18 +356,43 @@ uint32_t NetworkManager::ipv4(const std::string& s) {
 
 
 std::shared_ptr<httplib::Response>
-NetworkManager::post(const std::string &url,
-                     const httplib::MultipartFormDataItems &items) {
-  auto reply = cli.Post(url.data(), items);
+NetworkManager::post(const std::string &url, MultipartBody &body) {
+  if (!blockingSupported(url))
+    return {};
+  ThreadPool::BlockingScope blocking;
+  auto cli = checkout();
+  const auto path = target(url);
+  // httplib asks for the rest of the body, it is written by chunks until it is complete
+  auto provider = [&body](std::size_t offset, std::size_t, auto &&sink) {
+    body.read(offset, [&sink](const char *data, std::size_t size) { writeTo(sink, data, size); });
+  };
+  const auto content_type = body.contentType();
+  auto reply = cli->Post(path.data(), {}, body.size(), provider, content_type.data());
   if (reply && reply->status) {
 
     if (reply->status == std::clamp(reply->status,
                                     static_cast<int>(http::redirection),
                                     static_cast<int>(http::client_error))) {
         // follow the redirection
-        reply = cli.Post(url.data(), items);
+        reply = cli->Post(path.data(), {}, body.size(), provider, content_type.data());
     }
+    // the server received a damaged file
+    if (body.failed())
+      return {};
     return reply;
   } else
     return {};
 }
+
+std::shared_ptr<httplib::Response>
+NetworkManager::get(const std::string &url, const httplib::Headers &headers,
+                    httplib::ContentReceiver receiver) {
+  if (!blockingSupported(url))
+    return {};
+  ThreadPool::BlockingScope blocking;
+  auto cli = checkout();
+  auto reply = cli->Get(target(url).data(), headers, std::move(receiver));
+  if (reply && reply->status)
+    return reply;
+  return {};
+}
@@ -1,13 +1,64 @@
+#include <rapidjson/writer.h>
 #include "headers/querybuilder.h"
 using namespace telegram;
 
+namespace {
+/// rapidjson output stream that appends to std::string
+struct StringOutput {
+  using Ch = char;
+  std::string *out = nullptr;
+  void Put(Ch c) { out->push_back(c); }
+  void Flush() {}
+};
+} // namespace
+
 QueryBuilder::QueryBuilder(
     rapidjson::Document::AllocatorType &allocator)
     : doc{&allocator} {}
 
+QueryBuilder::QueryBuilder(QueryBuilder &&other) {
+  doc.CopyFrom(other.doc, doc.GetAllocator());
+}
+
+QueryBuilder &QueryBuilder::operator=(QueryBuilder &&other) {
+  if (this != &other)
+    doc.CopyFrom(other.doc, doc.GetAllocator());
+  return *this;
+}
+
 std::string QueryBuilder::getQuery() const noexcept {
   return JsonParser::i().rapidDocumentToString(doc);
 }
+void QueryBuilder::getQuery(std::string &out) const {
+  // the writer keeps its stack between calls of the thread
+  thread_local StringOutput stream;
+  thread_local rapidjson::Writer<StringOutput> writer;
+  out.clear();
+  stream.out = &out;
+  writer.Reset(stream);
+  doc.Accept(writer);
+}
+void QueryBuilder::getQuery(std::string &out, std::string_view members) const {
+  getQuery(out);
+  if (members.empty())
+    return;
+  // 'null' if nothing was written
+  if (out.size() < 2 || out.back() != '}') {
+    out.assign("{");
+  } else {
+    out.pop_back();
+    if (out.size() > 1)
+      out += ',';
+  }
+  out.append(members.data(), members.size());
+  out += '}';
+}
+std::string QueryBuilder::getMembers() const {
+  if (!doc.IsObject() || doc.ObjectEmpty())
+    return {};
+  auto query = getQuery();
+  return query.substr(1, query.size() - 2);
+}
 const rapidjson::Document &QueryBuilder::getDocument() const noexcept {
   return doc;
 }
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "headers/rate_limiter.h"
+
+using namespace telegram;
+
+namespace {
+/// idle chats are forgotten once their bucket is full, checked with this period
+constexpr std::chrono::seconds purge_period{60};
+/// scheduler wakes up at least this often, so changed limits are applied
+constexpr std::chrono::seconds max_sleep{1};
+
+bool limited(double rate) noexcept {
+    return rate > 0;
+}
+} // namespace
+
+void RateLimiter::Bucket::refill(clock::time_point now, double rate, double capacity) {
+    if (updated == clock::time_point{}) {
+        tokens = capacity;
+    } else {
+        std::chrono::duration<double> elapsed = now - updated;
+        tokens = std::min(capacity, tokens + elapsed.count() * rate);
+    }
+    updated = now;
+}
+
+RateLimiter::clock::time_point RateLimiter::Bucket::next(double rate) const {
+    if (available())
+        return updated;
+    std::chrono::duration<double> wait((1 - tokens) / rate);
+    return updated + std::chrono::duration_cast<clock::duration>(wait);
+}
+
+RateLimiter::RateLimiter(RateLimits limits) : limits{limits} {
+    scheduler = std::thread([this] { run(); });
+}
+
+RateLimiter::~RateLimiter() {
+    stop();
+}
+
+void RateLimiter::setLimits(RateLimits new_limits) {
+    {
+        std::unique_lock lock(mutex);
+        limits = new_limits;
+    }
+    condition.notify_all();
+}
+
+void RateLimiter::stop() {
+    {
+        std::unique_lock lock(mutex);
+        stopped = true;
+        chats.clear();
+        ready.clear();
+        delayed.clear();
+    }
+    condition.notify_all();
+    // dispatched jobs are finished before returning, so their resources can be released
+    if (scheduler.joinable() && scheduler.get_id() != std::this_thread::get_id())
+        scheduler.join();
+}
+
+double RateLimiter::chatRate(const ChatQueue &queue) const noexcept {
+    if (queue.global_only)
+        return 0;
+    return queue.group ? limits.group_rate : limits.private_chat_rate;
+}
+
+RateLimiter::ChatQueue &RateLimiter::chatQueue(const Destination &destination) {
+    auto &queue = chats[destination.chat];
+    queue.group = destination.group;
+    queue.global_only = destination.chat.empty();
+    return queue;
+}
+
+bool RateLimiter::tryTake(ChatQueue &queue, clock::time_point now) {
+    if (now < paused_until || now < queue.paused_until)
+        return false;
+    const double rate = chatRate(queue);
+    if (limited(rate)) {
+        queue.bucket.refill(now, rate, std::max(limits.chat_burst, 1.0));
+        if (!queue.bucket.available())
+            return false;
+    }
+    if (limited(limits.global_rate)) {
+        global.refill(now, limits.global_rate, std::max(limits.global_rate, 1.0));
+        if (!global.available())
+            return false;
+        global.take();
+    }
+    if (limited(rate))
+        queue.bucket.take();
+    return true;
+}
+
+void RateLimiter::enqueue(const Destination &destination, Job job) {
+    auto &queue = chatQueue(destination);
+    queue.jobs.push_back(std::move(job));
+    if (!queue.scheduled) {
+        queue.scheduled = true;
+        ready.push_back(destination.chat);
+    }
+}
+
+void RateLimiter::submit(const Destination &destination, Job job,
+                         std::chrono::milliseconds delay) {
+    {
+        std::unique_lock lock(mutex);
+        if (stopped) {
+            // the job may complete a promise, so it is run rather than dropped
+            lock.unlock();
+            job();
+            return;
+        }
+        if (delay.count() > 0) {
+            delayed.emplace(clock::now() + delay, std::make_pair(destination, std::move(job)));
+            lock.unlock();
+            condition.notify_all();
+            return;
+        }
+        auto &queue = chatQueue(destination);
+        // the fast path is taken only if nobody waits, otherwise the call is queued for fairness
+        if (!ready.empty() || !tryTake(queue, clock::now())) {
+            enqueue(destination, std::move(job));
+            lock.unlock();
+            condition.notify_all();
+            return;
+        }
+    }
+    job();
+}
+
+void RateLimiter::pause(const Destination &destination, std::chrono::milliseconds duration) {
+    {
+        std::unique_lock lock(mutex);
+        const auto until = clock::now() + duration;
+        if (destination.chat.empty()) {
+            paused_until = std::max(paused_until, until);
+        } else {
+            auto &queue = chatQueue(destination);
+            queue.paused_until = std::max(queue.paused_until, until);
+        }
+    }
+    condition.notify_all();
+}
+
+RateLimiter::clock::time_point RateLimiter::releaseDelayed(clock::time_point now) {
+    while (!delayed.empty() && delayed.begin()->first <= now) {
+        auto node = delayed.extract(delayed.begin());
+        enqueue(node.mapped().first, std::move(node.mapped().second));
+    }
+    return delayed.empty() ? clock::time_point::max() : delayed.begin()->first;
+}
+
+void RateLimiter::acquire(const Destination &destination, std::chrono::milliseconds delay) {
+    if (delay.count() <= 0) {
+        // usual call passes under the lock, without a job and its shared state
+        std::unique_lock lock(mutex);
+        if (stopped || (ready.empty() && tryTake(chatQueue(destination), clock::now())))
+            return;
+    }
+    auto allowed = std::make_shared<std::promise<void>>();
+    auto future = allowed->get_future();
+    submit(destination, [allowed] { allowed->set_value(); }, delay);
+    // jobs are dropped on stop, the call is let through then
+    while (future.wait_for(max_sleep) != std::future_status::ready) {
+        std::unique_lock lock(mutex);
+        if (stopped)
+            return;
+    }
+}
+
+void RateLimiter::purgeIdle(clock::time_point now) {
+    if (now - last_purge < purge_period)
+        return;
+    last_purge = now;
+    for (auto it = chats.begin(); it != chats.end();) {
+        auto &queue = it->second;
+        const double rate = chatRate(queue);
+        if (!queue.scheduled && limited(rate))
+            queue.bucket.refill(now, rate, std::max(limits.chat_burst, 1.0));
+        if (!queue.scheduled && queue.paused_until < now &&
+            (!limited(rate) || queue.bucket.full(std::max(limits.chat_burst, 1.0))))
+            it = chats.erase(it);
+        else
+            ++it;
+    }
+}
+
+void RateLimiter::run() {
+    std::unique_lock lock(mutex);
+    std::vector<Job> dispatched;
+    while (!stopped) {
+        auto now = clock::now();
+        purgeIdle(now);
+        auto wake = std::min(now + max_sleep, releaseDelayed(now));
+        if (now < paused_until)
+            wake = std::min(wake, paused_until);
+        // one round: every chat with queued jobs gets at most one call
+        for (std::size_t round = ready.size(); round > 0 && !stopped; --round) {
+            // chats keep their places while the global limit is exhausted or calls are paused
+            if (now < paused_until)
+                break;
+            if (limited(limits.global_rate)) {
+                global.refill(now, limits.global_rate, std::max(limits.global_rate, 1.0));
+                if (!global.available()) {
+                    wake = std::min(wake, global.next(limits.global_rate));
+                    break;
+                }
+            }
+            auto name = std::move(ready.front());
+            ready.pop_front();
+            auto &queue = chats[name];
+            if (tryTake(queue, now)) {
+                dispatched.push_back(std::move(queue.jobs.front()));
+                queue.jobs.pop_front();
+            } else if (now < queue.paused_until) {
+                wake = std::min(wake, queue.paused_until);
+            } else {
+                wake = std::min(wake, queue.bucket.next(chatRate(queue)));
+            }
+            if (queue.jobs.empty())
+                queue.scheduled = false;
+            else
+                ready.push_back(std::move(name));
+        }
+        if (!dispatched.empty()) {
+            lock.unlock();
+            for (auto &job : dispatched)
+                job();
+            dispatched.clear();
+            lock.lock();
+            continue;
+        }
+        condition.wait_until(lock, wake);
+    }
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <array>
+#include <fmt/format.h>
+
+#include "headers/retry_controller.h"
+#include "utility/logger.h"
+#include "utility/utility.h"
+
+using namespace telegram;
+
+namespace {
+constexpr int32_t too_many_requests = 429;
+/// wait used when 429 reply does not contain 'retry_after'
+constexpr std::chrono::seconds default_retry_after{1};
+/// prefixes of methods that can be repeated safely
+constexpr std::array<std::string_view, 6> idempotent_prefixes{"get", "set", "delete", "edit",
+                                                              "pin", "unpin"};
+
+bool serverFailure(int32_t code) noexcept {
+    return (code >= 500 && code < 600) ||
+           code == static_cast<int32_t>(ErrorCodes::UnableToMakeRequest);
+}
+} // namespace
+
+RetryController::RetryController(RateLimiter &limiter, RetryPolicy policy)
+    : limiter{limiter}, policy{policy} {
+}
+
+void RetryController::setPolicy(RetryPolicy new_policy) {
+    std::unique_lock lock(mutex);
+    policy = new_policy;
+}
+
+bool RetryController::idempotent(std::string_view api) noexcept {
+    return std::any_of(idempotent_prefixes.begin(), idempotent_prefixes.end(),
+                       [api](std::string_view prefix) {
+                           return api.substr(0, prefix.size()) == prefix;
+                       });
+}
+
+ApiCounters RetryController::counters() const {
+    std::unique_lock lock(mutex);
+    return totals;
+}
+
+std::chrono::milliseconds RetryController::jitter(std::chrono::milliseconds max) {
+    if (max.count() <= 0)
+        return std::chrono::milliseconds(0);
+    return std::chrono::milliseconds(
+        std::uniform_int_distribution<std::chrono::milliseconds::rep>(0, max.count())(random));
+}
+
+void RetryController::trip(clock::time_point now) {
+    const auto pause = std::min<std::chrono::milliseconds>(
+        policy.breaker_pause * (1ull << std::min<std::size_t>(trips_in_row, 16)),
+        policy.max_breaker_pause);
+    ++trips_in_row;
+    ++totals.breaker_trips;
+    // one more failure after the pause trips the breaker again
+    failures_in_row = policy.breaker_threshold ? policy.breaker_threshold - 1 : 0;
+    counted_since = now + pause;
+    utility::Logger::warn(fmt::format("API is degraded, calls are held for {} ms", pause.count()));
+    limiter.pause({}, pause);
+}
+
+std::optional<std::chrono::milliseconds>
+RetryController::onResult(std::string_view api, const RateLimiter::Destination &destination,
+                          int32_t error_code, std::optional<int32_t> retry_after,
+                          std::size_t attempt) {
+    std::unique_lock lock(mutex);
+    const auto now = clock::now();
+    if (error_code == too_many_requests) {
+        ++totals.rate_limited;
+        const auto wait = retry_after ? std::chrono::seconds(*retry_after) : default_retry_after;
+        if (attempt >= policy.max_attempts || wait > policy.max_retry_after)
+            return {};
+        // jitter spreads retries of calls that were rejected together
+        const auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(wait) +
+                           jitter(std::max<std::chrono::milliseconds>(wait / 10, std::chrono::milliseconds(100)));
+        limiter.pause(destination, delay);
+        ++totals.retries;
+        return delay;
+    }
+    if (!serverFailure(error_code)) {
+        // any reply from a healthy API (including client errors) closes the breaker
+        failures_in_row = 0;
+        trips_in_row = 0;
+        return {};
+    }
+    ++totals.failures;
+    if (now >= counted_since && policy.breaker_threshold &&
+        ++failures_in_row >= policy.breaker_threshold)
+        trip(now);
+    if (attempt >= policy.max_attempts || !idempotent(api))
+        return {};
+    // equal jitter: half of the backoff is fixed, half is random
+    const auto backoff = std::min<std::chrono::milliseconds>(
+        policy.base_delay * (1ull << std::min<std::size_t>(attempt - 1, 16)), policy.max_delay);
+    ++totals.retries;
+    return backoff / 2 + jitter(backoff / 2);
+}
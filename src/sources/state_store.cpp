@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <fmt/format.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <sstream>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "headers/state_store.h"
+#include "utility/logger.h"
+
+using namespace telegram;
+
+namespace {
+constexpr std::string_view file_header = "TGSTATE1";
+// size and checksum of the payload
+constexpr std::size_t record_header_size = 2 * sizeof(uint32_t);
+constexpr std::size_t min_file_size = 64 * 1024;
+
+enum class RecordType : uint8_t { save = 1, erase = 2 };
+
+uint32_t checksum(std::string_view data) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <class T>
+void put(std::string &out, T value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+void put(std::string &out, std::string_view value) {
+    put(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+template <class T>
+bool get(std::string_view &in, T &value) {
+    if (in.size() < sizeof(T))
+        return false;
+    std::memcpy(&value, in.data(), sizeof(T));
+    in.remove_prefix(sizeof(T));
+    return true;
+}
+bool get(std::string_view &in, std::string &value) {
+    uint32_t size = 0;
+    if (!get(in, size) || in.size() < size)
+        return false;
+    value.assign(in.data(), size);
+    in.remove_prefix(size);
+    return true;
+}
+
+std::string makeRecord(RecordType type, int64_t id, const std::string &sequence = {},
+                       const SequenceState &state = {}) {
+    std::string payload;
+    put(payload, type);
+    put(payload, id);
+    if (type == RecordType::save) {
+        put(payload, state.step);
+        put(payload, state.revision);
+        put(payload, std::string_view{sequence});
+        put(payload, std::string_view{state.data});
+    }
+    std::string record;
+    record.reserve(record_header_size + payload.size());
+    put(record, static_cast<uint32_t>(payload.size()));
+    put(record, checksum(payload));
+    record += payload;
+    return record;
+}
+
+/// write 'contents' to a new file at 'path' and wait until it reaches the disk
+bool writeFile(const std::string &path, std::string_view contents) {
+#ifndef _WIN32
+    const int fd = ::open(path.data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+    bool ok = true;
+    while (ok && !contents.empty()) {
+        const auto written = ::write(fd, contents.data(), contents.size());
+        if (written < 0 && errno == EINTR)
+            continue;
+        ok = written > 0;
+        if (ok)
+            contents.remove_prefix(static_cast<std::size_t>(written));
+    }
+    ok = ok && ::fsync(fd) == 0;
+    return ::close(fd) == 0 && ok;
+#else
+    std::FILE *out = std::fopen(path.data(), "wb");
+    if (!out)
+        return false;
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), out) == contents.size()
+            && std::fflush(out) == 0 && _commit(_fileno(out)) == 0;
+    return std::fclose(out) == 0 && ok;
+#endif
+}
+} // namespace
+
+#ifndef _WIN32
+/// Append-only file mapped into memory, grows by doubling
+class MappedStateStore::File {
+    int fd = -1;
+    char *data = nullptr;
+    std::size_t capacity = 0;
+    std::size_t used = 0;
+
+    void map(std::size_t size) {
+        if (data)
+            munmap(data, capacity);
+        data = nullptr;
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+            throw std::runtime_error("Unable to resize state file");
+        void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED)
+            throw std::runtime_error("Unable to map state file");
+        data = static_cast<char *>(ptr);
+        capacity = size;
+    }
+public:
+    explicit File(const std::string &path) {
+        fd = ::open(path.data(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+            throw std::runtime_error(fmt::format("Unable to open state file {}", path));
+        struct stat info {};
+        fstat(fd, &info);
+        map(std::max<std::size_t>(static_cast<std::size_t>(info.st_size), min_file_size));
+        if (!info.st_size)
+            append(file_header);
+    }
+    ~File() {
+        if (data)
+            munmap(data, capacity);
+        // drop preallocated tail
+        if (ftruncate(fd, static_cast<off_t>(used)) != 0)
+            utility::Logger::warn("Unable to truncate state file");
+        ::close(fd);
+    }
+    /// whole mapped region, unused tail is filled with zeroes
+    std::string_view contents() const {
+        return {data, capacity};
+    }
+    std::size_t size() const noexcept {
+        return used;
+    }
+    void setSize(std::size_t size) noexcept {
+        used = size;
+    }
+    void append(std::string_view record) {
+        if (used + record.size() > capacity)
+            map(std::max(capacity * 2, used + record.size()));
+        std::memcpy(data + used, record.data(), record.size());
+        used += record.size();
+    }
+    void flush() {
+        msync(data, used, MS_ASYNC);
+    }
+};
+#else
+/// Fallback for platforms without mmap: buffered append-only file
+class MappedStateStore::File {
+    std::string data;
+    std::ofstream out;
+    std::size_t used = 0;
+public:
+    explicit File(const std::string &path) {
+        {
+            std::ifstream in(path, std::ios::binary);
+            std::stringstream buffer;
+            buffer << in.rdbuf();
+            data = buffer.str();
+        }
+        out.open(path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!out.is_open())
+            out.open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!out.is_open())
+            throw std::runtime_error(fmt::format("Unable to open state file {}", path));
+        if (data.empty()) {
+            data = file_header;
+            append(file_header);
+        }
+    }
+    std::string_view contents() const {
+        return data;
+    }
+    std::size_t size() const noexcept {
+        return used;
+    }
+    void setSize(std::size_t size) {
+        used = size;
+        out.seekp(static_cast<std::streamoff>(used));
+    }
+    void append(std::string_view record) {
+        out.write(record.data(), static_cast<std::streamsize>(record.size()));
+        used += record.size();
+    }
+    void flush() {
+        out.flush();
+    }
+};
+#endif
+
+MappedStateStore::MappedStateStore(std::string path, std::size_t compaction_ratio)
+    : path{std::move(path)}, compaction_ratio{std::max<std::size_t>(compaction_ratio, 2)},
+      file{std::make_unique<File>(this->path)} {
+    std::string_view contents = file->contents();
+    if (contents.substr(0, file_header.size()) != file_header)
+        throw std::runtime_error(fmt::format("{} is not a state file", this->path));
+
+    // replay the log, stop at the first record that is incomplete or damaged
+    std::size_t offset = file_header.size();
+    for (;;) {
+        std::string_view rest = contents.substr(offset);
+        uint32_t size = 0, sum = 0;
+        if (!get(rest, size) || !size || !get(rest, sum) || rest.size() < size)
+            break;
+        std::string_view payload = rest.substr(0, size);
+        if (checksum(payload) != sum)
+            break;
+        RecordType type{};
+        int64_t id = 0;
+        if (!get(payload, type) || !get(payload, id))
+            break;
+        const std::size_t record_size = record_header_size + size;
+        if (type == RecordType::save) {
+            auto &record = live[id];
+            live_size -= record.size();
+            record.assign(contents.substr(offset, record_size));
+            live_size += record_size;
+        } else if (auto it = live.find(id); it != live.end()) {
+            live_size -= it->second.size();
+            live.erase(it);
+        }
+        offset += record_size;
+    }
+    file->setSize(offset);
+    utility::Logger::info(fmt::format("State file {} loaded, {} states", this->path, live.size()));
+    std::unique_lock lock(mutex);
+    compactIfNeeded();
+}
+
+MappedStateStore::~MappedStateStore() = default;
+
+void MappedStateStore::save(int64_t id, const std::string &sequence, const SequenceState &state) {
+    std::string record = makeRecord(RecordType::save, id, sequence, state);
+    std::unique_lock lock(mutex);
+    append(record);
+    auto &current = live[id];
+    live_size = live_size - current.size() + record.size();
+    current = std::move(record);
+    compactIfNeeded();
+}
+
+void MappedStateStore::erase(int64_t id) {
+    std::unique_lock lock(mutex);
+    auto it = live.find(id);
+    if (it == live.end())
+        return;
+    live_size -= it->second.size();
+    live.erase(it);
+    append(makeRecord(RecordType::erase, id));
+    compactIfNeeded();
+}
+
+std::vector<StoredState> MappedStateStore::load() {
+    std::unique_lock lock(mutex);
+    std::vector<StoredState> states;
+    states.reserve(live.size());
+    for (const auto &[id, record] : live) {
+        std::string_view payload = std::string_view{record}.substr(record_header_size);
+        RecordType type{};
+        StoredState state{id, {}, {}};
+        int64_t stored_id = 0;
+        if (get(payload, type) && get(payload, stored_id) && get(payload, state.state.step)
+                && get(payload, state.state.revision) && get(payload, state.sequence)
+                && get(payload, state.state.data))
+            states.push_back(std::move(state));
+    }
+    return states;
+}
+
+void MappedStateStore::compact() {
+    std::unique_lock lock(mutex);
+    compactLocked();
+}
+
+void MappedStateStore::compactLocked() {
+    const std::string tmp_path = path + ".tmp";
+    std::string contents;
+    contents.reserve(file_header.size() + live_size);
+    contents += file_header;
+    for (const auto &[id, record] : live)
+        contents += record;
+    // the new file must be on disk before it replaces the old one,
+    // otherwise a crash right after the rename may leave an empty file
+    if (!writeFile(tmp_path, contents)) {
+        std::remove(tmp_path.data());
+        utility::Logger::warn(fmt::format("Unable to compact state file {}", path));
+        return;
+    }
+    bool replaced = false;
+#ifdef _WIN32
+    // open file can not be replaced, the old one is kept until the new one is in place
+    const std::size_t size = file->size();
+    const std::string old_path = path + ".old";
+    file.reset();
+    std::remove(old_path.data());
+    if (std::rename(path.data(), old_path.data()) == 0) {
+        replaced = std::rename(tmp_path.data(), path.data()) == 0;
+        if (replaced)
+            std::remove(old_path.data());
+        else
+            std::rename(old_path.data(), path.data());
+    }
+    if (!replaced) {
+        file = std::make_unique<File>(path);
+        file->setSize(size);
+    }
+#else
+    // the old file stays open and valid until the rename succeeds
+    replaced = std::rename(tmp_path.data(), path.data()) == 0;
+#endif
+    if (!replaced) {
+        // records keep being appended to the old file
+        std::remove(tmp_path.data());
+        utility::Logger::warn(fmt::format("Unable to replace state file {}", path));
+        return;
+    }
+    file = std::make_unique<File>(path);
+    file->setSize(contents.size());
+}
+
+void MappedStateStore::flush() {
+    std::unique_lock lock(mutex);
+    file->flush();
+}
+
+void MappedStateStore::append(const std::string &record) {
+    file->append(record);
+}
+
+void MappedStateStore::compactIfNeeded() {
+    if (file->size() < min_file_size
+            || file->size() < compaction_ratio * (file_header.size() + live_size))
+        return;
+    compactLocked();
+}
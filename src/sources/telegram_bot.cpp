@@ -1,3 +1,10 @@
+#include <array>
+#include <cctype>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <queue>
+#include <thread>
 #include <spdlog/spdlog.h>
 
 #include "include/telegram_bot.h"
@@ -7,11 +14,111 @@
 
 namespace telegram {
 
-Bot::Bot(const std::string &token, std::size_t thread_number) noexcept
+namespace {
+/// long polling timeout used when it is not specified, seconds
+constexpr int64_t default_polling_timeout = 30;
+/// read timeout of polling requests is longer than polling timeout by this value
+constexpr std::chrono::seconds polling_read_margin{10};
+/// delay before the next request after a failed one
+constexpr std::chrono::seconds polling_retry_delay{1};
+/// number of replies that may be received ahead of routing
+constexpr std::size_t max_pending_batches = 4;
+
+/**
+ * @brief Limit of updates in one getUpdates reply
+ * Grows while replies are full (there is a backlog) and shrinks when replies are
+ * mostly empty, so small batches are routed without waiting for big ones
+ */
+class AdaptiveLimit {
+  static constexpr uint8_t min_limit = 10;
+  static constexpr uint8_t max_limit = 100;
+  uint8_t value = min_limit;
+public:
+  uint8_t get() const noexcept {
+    return value;
+  }
+  void update(std::size_t received, bool catching_up) noexcept {
+    if (catching_up)
+      value = max_limit;
+    else if (received >= value)
+      value = static_cast<uint8_t>(std::min<std::size_t>(value * 2u, max_limit));
+    else if (received < value / 4u)
+      value = static_cast<uint8_t>(std::max<std::size_t>(value / 2u, min_limit));
+  }
+};
+
+/// number of updates in getUpdates reply, counted without parsing it
+std::size_t countUpdates(std::string_view reply) {
+  constexpr std::string_view key = R"("update_id":)";
+  std::size_t count = 0;
+  for (auto pos = reply.find(key); pos != std::string_view::npos;
+       pos = reply.find(key, pos + key.size()))
+    ++count;
+  return count;
+}
+
+/**
+ * Get id of the last update in getUpdates reply without parsing it
+ * Updates are ordered by id and 'update_id' key is used only at the top level of updates
+ */
+std::optional<uint64_t> lastUpdateId(std::string_view reply) {
+  constexpr std::string_view key = R"("update_id":)";
+  auto pos = reply.rfind(key);
+  if (pos == std::string_view::npos)
+    return {};
+  pos = reply.find_first_not_of(' ', pos + key.size());
+  if (pos == std::string_view::npos || !std::isdigit(static_cast<unsigned char>(reply[pos])))
+    return {};
+  uint64_t id = 0;
+  for (; pos < reply.size() && std::isdigit(static_cast<unsigned char>(reply[pos])); ++pos)
+    id = id * 10 + static_cast<uint64_t>(reply[pos] - '0');
+  return id;
+}
+
+/// names of files uploaded by sendMediaGroup, a group has at most 10 items
+constexpr std::array<std::string_view, 10> media_names = {
+    "file0", "file1", "file2", "file3", "file4", "file5", "file6", "file7", "file8", "file9"};
+/// names of thumbnails of videos uploaded by sendMediaGroup
+constexpr std::array<std::string_view, 10> thumb_names = {
+    "thumb0", "thumb1", "thumb2", "thumb3", "thumb4", "thumb5", "thumb6", "thumb7", "thumb8", "thumb9"};
+
+/// refer to local files of 'media' with "attach://<name>" and return them as file parameters
+std::vector<name_file_pair>
+attachMedia(std::vector<std::variant<InputMediaPhoto, InputMediaVideo>> &media) {
+  std::vector<name_file_pair> files;
+  for (std::size_t i = 0; i < media.size(); ++i) {
+    std::visit([&](auto &item) {
+      constexpr bool photo = std::is_same_v<std::decay_t<decltype(item)>, InputMediaPhoto>;
+      if (item.type.empty())
+        item.type = photo ? "photo" : "video";
+      if (i >= media_names.size())
+        return;
+      if constexpr (!photo) {
+        // a thumbnail can only be uploaded with the video
+        if (item.thumb && FileSource(*item.thumb).kind() == FileSource::Kind::Path) {
+          files.push_back(name_file_pair{thumb_names[i], FileSource(*item.thumb)});
+          item.thumb = "attach://" + std::string(thumb_names[i]);
+        }
+      }
+      FileSource file(item.media);
+      if (file.kind() != FileSource::Kind::Path)
+        return;
+      item.media = "attach://" + std::string(media_names[i]);
+      files.push_back(name_file_pair{media_names[i], std::move(file)});
+    }, media[i]);
+  }
+  return files;
+}
+} // namespace
+
+Bot::Bot(const std::string &token, std::size_t thread_number,
+         std::size_t io_thread_number) noexcept
     : api{std::make_unique<ApiManager>("https://api.telegram.org/bot" + token +
-                                       '/')},
-      updater(std::max(thread_number,std::size_t{2})) {
-    utility::Logger::info(fmt::format("Threadpool capacity set to {}",std::max(thread_number,std::size_t{2})));
+                                       '/', std::max(io_thread_number,std::size_t{2}))},
+      downloader{std::make_unique<FileDownloader>("https://api.telegram.org/file/bot" + token + '/')},
+      updater(2, std::max(thread_number,std::size_t{2})) {
+    utility::Logger::info(fmt::format("Threadpool capacity set to [2, {}]",std::max(thread_number,std::size_t{2})));
+    utility::Logger::info(fmt::format("I/O threadpool capacity set to [1, {}]",std::max(io_thread_number,std::size_t{2})));
 }
 
 void Bot::onUpdate(UpdateCallback &&cb) {
@@ -42,11 +149,140 @@ void Bot::onInlineQuery(std::string_view cmd, InlineQueryCallback&& cb) {
 void Bot::onShippingQuery(std::string_view cmd,ShippingQueryCallback&& cb) {
     updater.addCallback(cmd, std::move(cb));
 }
+void Bot::setThreadPoolBounds(std::size_t min_threads, std::size_t max_threads) {
+    updater.setThreadPoolBounds(min_threads, max_threads);
+}
+
+void Bot::setIoThreadPoolBounds(std::size_t min_threads, std::size_t max_threads) {
+    utility::Logger::info(fmt::format("I/O threadpool bounds set to [{}, {}]",min_threads,max_threads));
+    api->setThreadPoolBounds(min_threads, max_threads);
+}
+bool Bot::setEventLoopTransport(bool enable) {
+    utility::Logger::info(fmt::format("Event loop transport {}",enable ? "enabled" : "disabled"));
+    return api->setEventLoopTransport(enable);
+}
+
+void Bot::setRateLimits(RateLimits limits) {
+    utility::Logger::info(fmt::format("Rate limits set to {}/s in total, {}/s per private chat, {}/s per group",
+                                      limits.global_rate, limits.private_chat_rate, limits.group_rate));
+    api->setRateLimits(limits);
+}
+
+void Bot::setRetryPolicy(RetryPolicy policy) {
+    api->setRetryPolicy(policy);
+}
+
+ApiCounters Bot::apiCounters() const {
+    return api->counters();
+}
+
+bool Bot::setFileIdCache(const std::string &index_path, std::size_t capacity) {
+    utility::Logger::info(fmt::format("File id cache capacity set to {}", capacity));
+    return api->setFileIdCache(index_path, capacity);
+}
+
+std::pair<DownloadCache::Lease, opt_error> Bot::fetchFile(const std::string &file_id) {
+    auto [file, error] = getFile(file_id);
+    if (error)
+        return {nullptr, error};
+    if (!file.file_path)
+        return {nullptr, Error{static_cast<int32_t>(ErrorCodes::InvalidReply),
+                               "File " + file_id + " can not be downloaded"}};
+    // different file_ids of one file share the download
+    auto result = downloader->fetch(file.file_unique_id.empty() ? file_id : file.file_unique_id,
+                                    *file.file_path, file.file_size);
+    if (!result.file)
+        return {nullptr, Error{result.error_code, result.description}};
+    return {std::move(result.file), {}};
+}
+
+opt_error Bot::downloadFile(const std::string &file_id, const std::string &destination) {
+    auto [file, error] = fetchFile(file_id);
+    if (error)
+        return error;
+    std::error_code copy_error;
+    // a copy, so changes of the destination do not change the cache
+    fs::copy_file(*file, destination, fs::copy_options::overwrite_existing, copy_error);
+    if (copy_error)
+        return Error{static_cast<int32_t>(ErrorCodes::NotValid),
+                     "Unable to copy file to " + destination + ": " + copy_error.message()};
+    return {};
+}
+
+opt_error Bot::downloadFile(const std::string &file_id,
+                            const std::function<bool(const char *, std::size_t)> &sink) {
+    auto [file, error] = fetchFile(file_id);
+    if (error)
+        return error;
+    std::ifstream in(*file, std::ios::binary);
+    std::vector<char> chunk(MultipartBody::chunk_size);
+    while (in) {
+        in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        const auto size = static_cast<std::size_t>(in.gcount());
+        if (size && !sink(chunk.data(), size))
+            break;
+    }
+    if (in.bad())
+        return Error{static_cast<int32_t>(ErrorCodes::NotValid), "Unable to read " + file->string()};
+    return {};
+}
+
+std::pair<MappedFile, opt_error> Bot::openFile(const std::string &file_id) {
+    auto [file, error] = fetchFile(file_id);
+    if (error)
+        return {MappedFile{}, error};
+    MappedFile mapped(file);
+    if (!mapped.valid())
+        return {MappedFile{}, Error{static_cast<int32_t>(ErrorCodes::NotValid),
+                                    "Unable to map " + file->string()}};
+    return {std::move(mapped), {}};
+}
+
+void Bot::setDownloadCache(const std::string &directory, std::uintmax_t capacity) {
+    utility::Logger::info(fmt::format("Download cache capacity set to {} bytes", capacity));
+    downloader->cache().configure(directory, capacity);
+}
+
+bool Bot::setApiServer(const ApiServer &server) {
+    utility::Logger::info(fmt::format("Bot API server set to {}{}{}", server.url,
+                                      server.unix_socket.empty() ? "" : " on " + server.unix_socket,
+                                      server.local ? " in local mode" : ""));
+    // nothing is changed unless every part accepts the server
+    if (!NetworkManager::supports(server) || !api->setServer(server))
+        return false;
+    return downloader->setServer(server, api->fileUrl());
+}
+
+void Bot::setConnectionPool(std::size_t size, std::chrono::seconds idle_timeout,
+                            std::size_t max_requests) {
+    utility::Logger::info(fmt::format("Connection pool size set to {}",size));
+    api->setConnectionPool(size, idle_timeout, max_requests);
+}
 void Bot::stopSequence(int64_t user_id) {
     utility::Logger::info(fmt::format("Removed sequence for user #{}",user_id));
     updater.removeSequence(user_id);
 }
 
+void Bot::setStateStore(std::unique_ptr<StateStore> store) {
+    updater.setStateStore(std::move(store));
+}
+
+void Bot::setCatchUpPolicy(CatchUpPolicy policy) {
+    updater.setCatchUpPolicy(std::move(policy));
+}
+
+void Bot::cancelNextUpdate(int64_t user_id) {
+    updater.removeWaiter(user_id);
+}
+
+std::optional<SequenceState> Bot::getSequenceState(int64_t user_id) const {
+    return updater.getSequenceState(user_id);
+}
+
+bool Bot::setSequenceState(int64_t user_id, SequenceState state) {
+    return updater.setSequenceState(user_id, std::move(state));
+}
+
 void Bot::start(std::optional<int64_t> timeout, std::optional<int64_t> offset, std::optional<int8_t> limit,
                 std::optional<std::vector<std::string_view>> allowed_updates) {
   if (auto &&[webhook, Error] = getWebhookInfo();
@@ -60,11 +296,82 @@ void Bot::start(std::optional<int64_t> timeout, std::optional<int64_t> offset, s
   stopPolling = false;
   updater.setOffset(offset.value_or(0));
   utility::Logger::info("Bot started");
-  while (!stopPolling) {
-    updater.routeCallback(getUpdatesRawJson(updater.getOffset(), limit, timeout,
-                                            allowed_updates));
-    std::this_thread::sleep_for(std::chrono::milliseconds(timeout.value_or(1)));
+
+  const auto poll_timeout = static_cast<uint32_t>(timeout.value_or(default_polling_timeout));
+  // replies that are received but not routed yet
+  std::queue<std::string> batches;
+  std::mutex batches_mutex;
+  std::condition_variable batches_condition;
+  bool polling_finished = false;
+
+  // the next request is sent as soon as the offset of the previous reply is known,
+  // the reply is parsed and routed on the calling thread meanwhile
+  std::thread poller([&] {
+    std::size_t next_offset = updater.getOffset();
+    AdaptiveLimit adaptive_limit;
+    while (!stopPolling) {
+      // without explicit values the limit follows the load and update types follow
+      // registered handlers (handlers may be added while the bot is running)
+      auto types = allowed_updates ? *allowed_updates : updater.allowedUpdates();
+      // Telegram treats an empty list as every update type, so nothing is requested
+      // until a handler is registered
+      if (!allowed_updates && types.empty()) {
+        std::this_thread::sleep_for(polling_retry_delay);
+        continue;
+      }
+      std::string batch = pollUpdates(static_cast<uint32_t>(next_offset),
+                                      limit ? std::optional<uint8_t>(*limit)
+                                            : std::optional<uint8_t>(adaptive_limit.get()),
+                                      poll_timeout, std::move(types));
+      const bool failed = batch.find(R"("ok":true)") == std::string::npos;
+      if (!failed)
+        adaptive_limit.update(countUpdates(batch), updater.catchingUp());
+      if (auto last = lastUpdateId(batch))
+        next_offset = *last + 1;
+      if (!batch.empty()) {
+        std::unique_lock lock(batches_mutex);
+        batches_condition.wait(lock, [&] {
+          return batches.size() < max_pending_batches || stopPolling;
+        });
+        batches.push(std::move(batch));
+      }
+      batches_condition.notify_all();
+      // back off only if the request failed, so errors do not turn into a busy loop
+      if (failed && !stopPolling) {
+        utility::Logger::warn("getUpdates request failed, retrying");
+        std::this_thread::sleep_for(polling_retry_delay);
+      }
+    }
+    {
+      std::unique_lock lock(batches_mutex);
+      polling_finished = true;
+    }
+    batches_condition.notify_all();
+  });
+
+  for (;;) {
+    std::string batch;
+    {
+      std::unique_lock lock(batches_mutex);
+      batches_condition.wait(lock, [&] { return !batches.empty() || polling_finished; });
+      if (batches.empty())
+        break;
+      batch = std::move(batches.front());
+      batches.pop();
+    }
+    batches_condition.notify_all();
+    updater.routeCallback(batch);
   }
+  poller.join();
+}
+std::string Bot::pollUpdates(std::optional<uint32_t> offset, std::optional<uint8_t> limit,
+                             uint32_t timeout,
+                             const std::optional<std::vector<std::string_view>> &allowed_updates) {
+  QueryBuilder builder;
+  builder << make_named_pair(offset) << make_named_pair(limit)
+          << make_named_pair(timeout) << make_named_pair(allowed_updates);
+  return api->ApiCallRaw("getUpdates", builder,
+                         std::chrono::seconds(timeout) + polling_read_margin);
 }
 std::string Bot::getUpdatesRawJson(
     std::optional<uint32_t> offset, std::optional<uint8_t> limit,
@@ -134,6 +441,35 @@ bool Bot::setWebhookServer(const std::string &url, uint16_t port,
   return server.listen("0.0.0.0", port);
 }
 
+std::pair<std::vector<Message>, opt_error>
+Bot::sendMediaGroup(const std::variant<int64_t, std::string> &chat_id,
+                    std::vector<std::variant<InputMediaPhoto, InputMediaVideo>> media,
+                    std::optional<bool> disable_notification,
+                    std::optional<int64_t> reply_to_message_id) const {
+  auto params = attachMedia(media);
+  QueryBuilder builder;
+  builder << make_named_pair(chat_id) << make_named_pair(media)
+          << make_named_pair(disable_notification) << make_named_pair(reply_to_message_id);
+  if (params.empty())
+    return api->ApiCall<std::vector<Message>>(__func__, builder);
+  return api->ApiCall<std::vector<Message>>(__func__, builder, params);
+}
+
+ApiFuture<std::pair<std::vector<Message>, opt_error>>
+Bot::sendMediaGroupAsync(const std::variant<int64_t, std::string> &chat_id,
+                         std::vector<std::variant<InputMediaPhoto, InputMediaVideo>> media,
+                         std::optional<bool> disable_notification,
+                         std::optional<int64_t> reply_to_message_id) const {
+  auto params = attachMedia(media);
+  QueryBuilder builder;
+  builder << make_named_pair(chat_id) << make_named_pair(media)
+          << make_named_pair(disable_notification) << make_named_pair(reply_to_message_id);
+  if (params.empty())
+    return api->ApiCallAsync<std::vector<Message>>("sendMediaGroup", builder);
+  return api->ApiCallAsync<std::vector<Message>>("sendMediaGroup", std::move(builder),
+                                                 std::move(params));
+}
+
 // --------------------------- AUTOGENERAGED CODE ------------------------------
 
 
@@ -151,9 +487,23 @@ builder << make_named_pair(offset)
 ;
 return api->ApiCall<std::vector<Update>>(__func__,builder);
 }
+ApiFuture<std::pair<std::vector<Update>,opt_error>> Bot::getUpdatesAsync ( 
+															std::optional<int64_t>	offset,
+															std::optional<int64_t>	limit,
+															std::optional<int64_t>	timeout,
+															const std::optional<std::vector<std::string>>& 	allowed_updates
+) const {
+QueryBuilder builder;
+builder << make_named_pair(offset)
+ << make_named_pair(limit)
+ << make_named_pair(timeout)
+ << make_named_pair(allowed_updates);
+;
+return api->ApiCallAsync<std::vector<Update>>("getUpdates",builder);
+}
 std::pair<bool,opt_error> Bot::setWebhook ( 
 															const std::string& 	url,
-															const std::optional<std::string>& 	certificate,
+															const std::optional<FileSource>& 	certificate,
 															std::optional<int64_t>	max_connections,
 															const std::optional<std::vector<std::string>>& 	allowed_updates
 ) const {
@@ -162,27 +512,59 @@ builder << make_named_pair(url)
  << make_named_pair(max_connections)
  << make_named_pair(allowed_updates);
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(1);
 if (certificate.has_value())
-	params.push_back(name_value_pair{"certificate",std::move(certificate.value())});
+	params.push_back(name_file_pair{"certificate",certificate.value()});
 return api->ApiCall<bool>(__func__,builder,params);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::setWebhookAsync ( 
+															const std::string& 	url,
+															const std::optional<FileSource>& 	certificate,
+															std::optional<int64_t>	max_connections,
+															const std::optional<std::vector<std::string>>& 	allowed_updates
+) const {
+QueryBuilder builder;
+builder << make_named_pair(url)
+ << make_named_pair(max_connections)
+ << make_named_pair(allowed_updates);
+;
+std::vector<name_file_pair> params;
+params.reserve(1);
+if (certificate.has_value())
+	params.push_back(name_file_pair{"certificate",certificate.value()});
+return api->ApiCallAsync<bool>("setWebhook",std::move(builder),std::move(params));
+}
 std::pair<bool,opt_error> Bot::deleteWebhook ( 
 
 ) const {
 return api->ApiCall<bool>(__func__);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::deleteWebhookAsync ( 
+
+) const {
+return api->ApiCallAsync<bool>("deleteWebhook");
+}
 std::pair<WebhookInfo,opt_error> Bot::getWebhookInfo ( 
 
 ) const {
 return api->ApiCall<WebhookInfo>(__func__);
 }
+ApiFuture<std::pair<WebhookInfo,opt_error>> Bot::getWebhookInfoAsync ( 
+
+) const {
+return api->ApiCallAsync<WebhookInfo>("getWebhookInfo");
+}
 std::pair<User,opt_error> Bot::getMe ( 
 
 ) const {
 return api->ApiCall<User>(__func__);
 }
+ApiFuture<std::pair<User,opt_error>> Bot::getMeAsync ( 
+
+) const {
+return api->ApiCallAsync<User>("getMe");
+}
 std::pair<Message,opt_error> Bot::sendMessage ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::string& 	text,
@@ -203,6 +585,26 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<Message>(__func__,builder);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::sendMessageAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	text,
+															const std::optional<std::string>& 	parse_mode,
+															std::optional<bool>	disable_web_page_preview,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(text)
+ << make_named_pair(parse_mode)
+ << make_named_pair(disable_web_page_preview)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<Message>("sendMessage",builder);
+}
 std::pair<Message,opt_error> Bot::forwardMessage ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::variant<int64_t,std::string>& 	from_chat_id,
@@ -217,9 +619,23 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<Message>(__func__,builder);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::forwardMessageAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::variant<int64_t,std::string>& 	from_chat_id,
+															int64_t	message_id,
+															std::optional<bool>	disable_notification
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(from_chat_id)
+ << make_named_pair(disable_notification)
+ << make_named_pair(message_id);
+;
+return api->ApiCallAsync<Message>("forwardMessage",builder);
+}
 std::pair<Message,opt_error> Bot::sendPhoto ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	photo,
+															const FileSource& 	photo,
 															const std::optional<std::string>& 	caption,
 															const std::optional<std::string>& 	parse_mode,
 															std::optional<bool>	disable_notification,
@@ -234,20 +650,42 @@ builder << make_named_pair(chat_id)
  << make_named_pair(reply_to_message_id)
  << make_named_pair(reply_markup);
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(1);
-params.push_back(name_value_pair{"photo",std::move(photo)});
+params.push_back(name_file_pair{"photo",photo});
 return api->ApiCall<Message>(__func__,builder,params);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::sendPhotoAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	photo,
+															const std::optional<std::string>& 	caption,
+															const std::optional<std::string>& 	parse_mode,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(caption)
+ << make_named_pair(parse_mode)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+std::vector<name_file_pair> params;
+params.reserve(1);
+params.push_back(name_file_pair{"photo",photo});
+return api->ApiCallAsync<Message>("sendPhoto",std::move(builder),std::move(params));
+}
 std::pair<Message,opt_error> Bot::sendAudio ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	audio,
+															const FileSource& 	audio,
 															const std::optional<std::string>& 	caption,
 															const std::optional<std::string>& 	parse_mode,
 															std::optional<int64_t>	duration,
 															const std::optional<std::string>& 	performer,
 															const std::optional<std::string>& 	title,
-															const std::optional<std::string>& 	thumb,
+															const std::optional<FileSource>& 	thumb,
 															std::optional<bool>	disable_notification,
 															std::optional<int64_t>	reply_to_message_id,
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
@@ -263,17 +701,48 @@ builder << make_named_pair(chat_id)
  << make_named_pair(reply_to_message_id)
  << make_named_pair(reply_markup);
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(2);
-params.push_back(name_value_pair{"audio",std::move(audio)});
+params.push_back(name_file_pair{"audio",audio});
 if (thumb.has_value())
-	params.push_back(name_value_pair{"thumb",std::move(thumb.value())});
+	params.push_back(name_file_pair{"thumb",thumb.value()});
 return api->ApiCall<Message>(__func__,builder,params);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::sendAudioAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	audio,
+															const std::optional<std::string>& 	caption,
+															const std::optional<std::string>& 	parse_mode,
+															std::optional<int64_t>	duration,
+															const std::optional<std::string>& 	performer,
+															const std::optional<std::string>& 	title,
+															const std::optional<FileSource>& 	thumb,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(caption)
+ << make_named_pair(parse_mode)
+ << make_named_pair(duration)
+ << make_named_pair(performer)
+ << make_named_pair(title)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+std::vector<name_file_pair> params;
+params.reserve(2);
+params.push_back(name_file_pair{"audio",audio});
+if (thumb.has_value())
+	params.push_back(name_file_pair{"thumb",thumb.value()});
+return api->ApiCallAsync<Message>("sendAudio",std::move(builder),std::move(params));
+}
 std::pair<Message,opt_error> Bot::sendDocument ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	document,
-															const std::optional<std::string>& 	thumb,
+															const FileSource& 	document,
+															const std::optional<FileSource>& 	thumb,
 															const std::optional<std::string>& 	caption,
 															const std::optional<std::string>& 	parse_mode,
 															std::optional<bool>	disable_notification,
@@ -288,20 +757,45 @@ builder << make_named_pair(chat_id)
  << make_named_pair(reply_to_message_id)
  << make_named_pair(reply_markup);
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(2);
-params.push_back(name_value_pair{"document",std::move(document)});
+params.push_back(name_file_pair{"document",document});
 if (thumb.has_value())
-	params.push_back(name_value_pair{"thumb",std::move(thumb.value())});
+	params.push_back(name_file_pair{"thumb",thumb.value()});
 return api->ApiCall<Message>(__func__,builder,params);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::sendDocumentAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	document,
+															const std::optional<FileSource>& 	thumb,
+															const std::optional<std::string>& 	caption,
+															const std::optional<std::string>& 	parse_mode,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(caption)
+ << make_named_pair(parse_mode)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+std::vector<name_file_pair> params;
+params.reserve(2);
+params.push_back(name_file_pair{"document",document});
+if (thumb.has_value())
+	params.push_back(name_file_pair{"thumb",thumb.value()});
+return api->ApiCallAsync<Message>("sendDocument",std::move(builder),std::move(params));
+}
 std::pair<Message,opt_error> Bot::sendVideo ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	video,
+															const FileSource& 	video,
 															std::optional<int64_t>	duration,
 															std::optional<int64_t>	width,
 															std::optional<int64_t>	height,
-															const std::optional<std::string>& 	thumb,
+															const std::optional<FileSource>& 	thumb,
 															const std::optional<std::string>& 	caption,
 															const std::optional<std::string>& 	parse_mode,
 															std::optional<bool>	supports_streaming,
@@ -321,22 +815,23 @@ builder << make_named_pair(chat_id)
  << make_named_pair(reply_to_message_id)
  << make_named_pair(reply_markup);
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(2);
-params.push_back(name_value_pair{"video",std::move(video)});
+params.push_back(name_file_pair{"video",video});
 if (thumb.has_value())
-	params.push_back(name_value_pair{"thumb",std::move(thumb.value())});
+	params.push_back(name_file_pair{"thumb",thumb.value()});
 return api->ApiCall<Message>(__func__,builder,params);
 }
-std::pair<Message,opt_error> Bot::sendAnimation ( 
+ApiFuture<std::pair<Message,opt_error>> Bot::sendVideoAsync ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	animation,
+															const FileSource& 	video,
 															std::optional<int64_t>	duration,
 															std::optional<int64_t>	width,
 															std::optional<int64_t>	height,
-															const std::optional<std::string>& 	thumb,
+															const std::optional<FileSource>& 	thumb,
 															const std::optional<std::string>& 	caption,
 															const std::optional<std::string>& 	parse_mode,
+															std::optional<bool>	supports_streaming,
 															std::optional<bool>	disable_notification,
 															std::optional<int64_t>	reply_to_message_id,
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
@@ -348,47 +843,58 @@ builder << make_named_pair(chat_id)
  << make_named_pair(height)
  << make_named_pair(caption)
  << make_named_pair(parse_mode)
+ << make_named_pair(supports_streaming)
  << make_named_pair(disable_notification)
  << make_named_pair(reply_to_message_id)
  << make_named_pair(reply_markup);
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(2);
-params.push_back(name_value_pair{"animation",std::move(animation)});
+params.push_back(name_file_pair{"video",video});
 if (thumb.has_value())
-	params.push_back(name_value_pair{"thumb",std::move(thumb.value())});
-return api->ApiCall<Message>(__func__,builder,params);
+	params.push_back(name_file_pair{"thumb",thumb.value()});
+return api->ApiCallAsync<Message>("sendVideo",std::move(builder),std::move(params));
 }
-std::pair<Message,opt_error> Bot::sendVoice ( 
+std::pair<Message,opt_error> Bot::sendAnimation ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	voice,
+															const FileSource& 	animation,
+															std::optional<int64_t>	duration,
+															std::optional<int64_t>	width,
+															std::optional<int64_t>	height,
+															const std::optional<FileSource>& 	thumb,
 															const std::optional<std::string>& 	caption,
 															const std::optional<std::string>& 	parse_mode,
-															std::optional<int64_t>	duration,
 															std::optional<bool>	disable_notification,
 															std::optional<int64_t>	reply_to_message_id,
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
 ) const {
 QueryBuilder builder;
 builder << make_named_pair(chat_id)
+ << make_named_pair(duration)
+ << make_named_pair(width)
+ << make_named_pair(height)
  << make_named_pair(caption)
  << make_named_pair(parse_mode)
- << make_named_pair(duration)
  << make_named_pair(disable_notification)
  << make_named_pair(reply_to_message_id)
  << make_named_pair(reply_markup);
 ;
-std::vector<name_value_pair> params;
-params.reserve(1);
-params.push_back(name_value_pair{"voice",std::move(voice)});
+std::vector<name_file_pair> params;
+params.reserve(2);
+params.push_back(name_file_pair{"animation",animation});
+if (thumb.has_value())
+	params.push_back(name_file_pair{"thumb",thumb.value()});
 return api->ApiCall<Message>(__func__,builder,params);
 }
-std::pair<Message,opt_error> Bot::sendVideoNote ( 
+ApiFuture<std::pair<Message,opt_error>> Bot::sendAnimationAsync ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	video_note,
+															const FileSource& 	animation,
 															std::optional<int64_t>	duration,
-															std::optional<int64_t>	length,
-															const std::optional<std::string>& 	thumb,
+															std::optional<int64_t>	width,
+															std::optional<int64_t>	height,
+															const std::optional<FileSource>& 	thumb,
+															const std::optional<std::string>& 	caption,
+															const std::optional<std::string>& 	parse_mode,
 															std::optional<bool>	disable_notification,
 															std::optional<int64_t>	reply_to_message_id,
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
@@ -396,56 +902,195 @@ std::pair<Message,opt_error> Bot::sendVideoNote (
 QueryBuilder builder;
 builder << make_named_pair(chat_id)
  << make_named_pair(duration)
- << make_named_pair(length)
+ << make_named_pair(width)
+ << make_named_pair(height)
+ << make_named_pair(caption)
+ << make_named_pair(parse_mode)
  << make_named_pair(disable_notification)
  << make_named_pair(reply_to_message_id)
  << make_named_pair(reply_markup);
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(2);
-params.push_back(name_value_pair{"video_note",std::move(video_note)});
+params.push_back(name_file_pair{"animation",animation});
 if (thumb.has_value())
-	params.push_back(name_value_pair{"thumb",std::move(thumb.value())});
-return api->ApiCall<Message>(__func__,builder,params);
+	params.push_back(name_file_pair{"thumb",thumb.value()});
+return api->ApiCallAsync<Message>("sendAnimation",std::move(builder),std::move(params));
 }
-std::pair<Message,opt_error> Bot::sendLocation ( 
+std::pair<Message,opt_error> Bot::sendVoice ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															float	latitude,
-															float	longitude,
-															std::optional<int64_t>	live_period,
+															const FileSource& 	voice,
+															const std::optional<std::string>& 	caption,
+															const std::optional<std::string>& 	parse_mode,
+															std::optional<int64_t>	duration,
 															std::optional<bool>	disable_notification,
 															std::optional<int64_t>	reply_to_message_id,
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
 ) const {
 QueryBuilder builder;
 builder << make_named_pair(chat_id)
- << make_named_pair(latitude)
- << make_named_pair(longitude)
- << make_named_pair(live_period)
+ << make_named_pair(caption)
+ << make_named_pair(parse_mode)
+ << make_named_pair(duration)
  << make_named_pair(disable_notification)
  << make_named_pair(reply_to_message_id)
  << make_named_pair(reply_markup);
 ;
-return api->ApiCall<Message>(__func__,builder);
+std::vector<name_file_pair> params;
+params.reserve(1);
+params.push_back(name_file_pair{"voice",voice});
+return api->ApiCall<Message>(__func__,builder,params);
 }
-std::pair<std::variant<bool, Message>,opt_error> Bot::editMessageLiveLocation ( 
-															float	latitude,
-															float	longitude,
-															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
-															std::optional<int64_t>	message_id,
-															const std::optional<std::string>& 	inline_message_id,
-															const std::optional<InlineKeyboardMarkup>& 	reply_markup
+ApiFuture<std::pair<Message,opt_error>> Bot::sendVoiceAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	voice,
+															const std::optional<std::string>& 	caption,
+															const std::optional<std::string>& 	parse_mode,
+															std::optional<int64_t>	duration,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(caption)
+ << make_named_pair(parse_mode)
+ << make_named_pair(duration)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+std::vector<name_file_pair> params;
+params.reserve(1);
+params.push_back(name_file_pair{"voice",voice});
+return api->ApiCallAsync<Message>("sendVoice",std::move(builder),std::move(params));
+}
+std::pair<Message,opt_error> Bot::sendVideoNote ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	video_note,
+															std::optional<int64_t>	duration,
+															std::optional<int64_t>	length,
+															const std::optional<FileSource>& 	thumb,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(duration)
+ << make_named_pair(length)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+std::vector<name_file_pair> params;
+params.reserve(2);
+params.push_back(name_file_pair{"video_note",video_note});
+if (thumb.has_value())
+	params.push_back(name_file_pair{"thumb",thumb.value()});
+return api->ApiCall<Message>(__func__,builder,params);
+}
+ApiFuture<std::pair<Message,opt_error>> Bot::sendVideoNoteAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	video_note,
+															std::optional<int64_t>	duration,
+															std::optional<int64_t>	length,
+															const std::optional<FileSource>& 	thumb,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(duration)
+ << make_named_pair(length)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+std::vector<name_file_pair> params;
+params.reserve(2);
+params.push_back(name_file_pair{"video_note",video_note});
+if (thumb.has_value())
+	params.push_back(name_file_pair{"thumb",thumb.value()});
+return api->ApiCallAsync<Message>("sendVideoNote",std::move(builder),std::move(params));
+}
+std::pair<Message,opt_error> Bot::sendLocation ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															float	latitude,
+															float	longitude,
+															std::optional<int64_t>	live_period,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
 ) const {
 QueryBuilder builder;
 builder << make_named_pair(chat_id)
- << make_named_pair(message_id)
- << make_named_pair(inline_message_id)
+ << make_named_pair(latitude)
+ << make_named_pair(longitude)
+ << make_named_pair(live_period)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCall<Message>(__func__,builder);
+}
+ApiFuture<std::pair<Message,opt_error>> Bot::sendLocationAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															float	latitude,
+															float	longitude,
+															std::optional<int64_t>	live_period,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(latitude)
+ << make_named_pair(longitude)
+ << make_named_pair(live_period)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<Message>("sendLocation",builder);
+}
+std::pair<std::variant<bool, Message>,opt_error> Bot::editMessageLiveLocation ( 
+															float	latitude,
+															float	longitude,
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
+															std::optional<int64_t>	message_id,
+															const std::optional<std::string>& 	inline_message_id,
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(message_id)
+ << make_named_pair(inline_message_id)
  << make_named_pair(latitude)
  << make_named_pair(longitude)
  << make_named_pair(reply_markup);
 ;
 return api->ApiCall<std::variant<bool, Message>,Message>(__func__,builder);
 }
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> Bot::editMessageLiveLocationAsync ( 
+															float	latitude,
+															float	longitude,
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
+															std::optional<int64_t>	message_id,
+															const std::optional<std::string>& 	inline_message_id,
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(message_id)
+ << make_named_pair(inline_message_id)
+ << make_named_pair(latitude)
+ << make_named_pair(longitude)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<std::variant<bool, Message>,Message>("editMessageLiveLocation",builder);
+}
 std::pair<std::variant<bool, Message>,opt_error> Bot::stopMessageLiveLocation ( 
 															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
 															std::optional<int64_t>	message_id,
@@ -460,6 +1105,20 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<std::variant<bool, Message>,Message>(__func__,builder);
 }
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> Bot::stopMessageLiveLocationAsync ( 
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
+															std::optional<int64_t>	message_id,
+															const std::optional<std::string>& 	inline_message_id,
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(message_id)
+ << make_named_pair(inline_message_id)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<std::variant<bool, Message>,Message>("stopMessageLiveLocation",builder);
+}
 std::pair<Message,opt_error> Bot::sendVenue ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															float	latitude,
@@ -486,6 +1145,32 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<Message>(__func__,builder);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::sendVenueAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															float	latitude,
+															float	longitude,
+															const std::string& 	title,
+															const std::string& 	address,
+															const std::optional<std::string>& 	foursquare_id,
+															const std::optional<std::string>& 	foursquare_type,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(latitude)
+ << make_named_pair(longitude)
+ << make_named_pair(title)
+ << make_named_pair(address)
+ << make_named_pair(foursquare_id)
+ << make_named_pair(foursquare_type)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<Message>("sendVenue",builder);
+}
 std::pair<Message,opt_error> Bot::sendContact ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::string& 	phone_number,
@@ -508,6 +1193,28 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<Message>(__func__,builder);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::sendContactAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	phone_number,
+															const std::string& 	first_name,
+															const std::optional<std::string>& 	last_name,
+															const std::optional<std::string>& 	vcard,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(phone_number)
+ << make_named_pair(first_name)
+ << make_named_pair(last_name)
+ << make_named_pair(vcard)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<Message>("sendContact",builder);
+}
 std::pair<Message,opt_error> Bot::sendPoll ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::string& 	question,
@@ -544,6 +1251,42 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<Message>(__func__,builder);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::sendPollAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	question,
+															const std::vector<std::string>& 	options,
+															std::optional<bool>	is_anonymous,
+															const std::optional<std::string>& 	type,
+															std::optional<bool>	allows_multiple_answers,
+															std::optional<int64_t>	correct_option_id,
+															const std::optional<std::string>& 	explanation,
+															const std::optional<std::string>& 	explanation_parse_mode,
+															std::optional<int64_t>	open_period,
+															std::optional<int64_t>	close_date,
+															std::optional<bool>	is_closed,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(question)
+ << make_named_pair(options)
+ << make_named_pair(is_anonymous)
+ << make_named_pair(type)
+ << make_named_pair(allows_multiple_answers)
+ << make_named_pair(correct_option_id)
+ << make_named_pair(explanation)
+ << make_named_pair(explanation_parse_mode)
+ << make_named_pair(open_period)
+ << make_named_pair(close_date)
+ << make_named_pair(is_closed)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<Message>("sendPoll",builder);
+}
 std::pair<Message,opt_error> Bot::sendDice ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::optional<std::string>& 	emoji,
@@ -560,6 +1303,22 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<Message>(__func__,builder);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::sendDiceAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::optional<std::string>& 	emoji,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(emoji)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<Message>("sendDice",builder);
+}
 std::pair<bool,opt_error> Bot::sendChatAction ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::string& 	action
@@ -570,6 +1329,16 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::sendChatActionAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	action
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(action);
+;
+return api->ApiCallAsync<bool>("sendChatAction",builder);
+}
 std::pair<UserProfilePhotos,opt_error> Bot::getUserProfilePhotos ( 
 															int64_t	user_id,
 															std::optional<int64_t>	offset,
@@ -582,6 +1351,18 @@ builder << make_named_pair(user_id)
 ;
 return api->ApiCall<UserProfilePhotos>(__func__,builder);
 }
+ApiFuture<std::pair<UserProfilePhotos,opt_error>> Bot::getUserProfilePhotosAsync ( 
+															int64_t	user_id,
+															std::optional<int64_t>	offset,
+															std::optional<int64_t>	limit
+) const {
+QueryBuilder builder;
+builder << make_named_pair(user_id)
+ << make_named_pair(offset)
+ << make_named_pair(limit);
+;
+return api->ApiCallAsync<UserProfilePhotos>("getUserProfilePhotos",builder);
+}
 std::pair<File,opt_error> Bot::getFile ( 
 															const std::string& 	file_id
 ) const {
@@ -590,6 +1371,14 @@ builder << make_named_pair(file_id);
 ;
 return api->ApiCall<File>(__func__,builder);
 }
+ApiFuture<std::pair<File,opt_error>> Bot::getFileAsync ( 
+															const std::string& 	file_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(file_id);
+;
+return api->ApiCallAsync<File>("getFile",builder);
+}
 std::pair<bool,opt_error> Bot::kickChatMember ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															int64_t	user_id,
@@ -602,6 +1391,18 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::kickChatMemberAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id,
+															std::optional<int64_t>	until_date
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(user_id)
+ << make_named_pair(until_date);
+;
+return api->ApiCallAsync<bool>("kickChatMember",builder);
+}
 std::pair<bool,opt_error> Bot::unbanChatMember ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															int64_t	user_id
@@ -612,6 +1413,16 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::unbanChatMemberAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(user_id);
+;
+return api->ApiCallAsync<bool>("unbanChatMember",builder);
+}
 std::pair<std::variant<bool>,opt_error> Bot::restrictChatMember ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															int64_t	user_id,
@@ -626,6 +1437,20 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<std::variant<bool>,bool>(__func__,builder);
 }
+ApiFuture<std::pair<std::variant<bool>,opt_error>> Bot::restrictChatMemberAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id,
+															const ChatPermissions& 	permissions,
+															std::optional<int64_t>	until_date
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(user_id)
+ << make_named_pair(permissions)
+ << make_named_pair(until_date);
+;
+return api->ApiCallAsync<std::variant<bool>,bool>("restrictChatMember",builder);
+}
 std::pair<std::variant<bool>,opt_error> Bot::promoteChatMember ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															int64_t	user_id,
@@ -652,6 +1477,32 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<std::variant<bool>,bool>(__func__,builder);
 }
+ApiFuture<std::pair<std::variant<bool>,opt_error>> Bot::promoteChatMemberAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id,
+															std::optional<bool>	can_change_info,
+															std::optional<bool>	can_post_messages,
+															std::optional<bool>	can_edit_messages,
+															std::optional<bool>	can_delete_messages,
+															std::optional<bool>	can_invite_users,
+															std::optional<bool>	can_restrict_members,
+															std::optional<bool>	can_pin_messages,
+															std::optional<bool>	can_promote_members
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(user_id)
+ << make_named_pair(can_change_info)
+ << make_named_pair(can_post_messages)
+ << make_named_pair(can_edit_messages)
+ << make_named_pair(can_delete_messages)
+ << make_named_pair(can_invite_users)
+ << make_named_pair(can_restrict_members)
+ << make_named_pair(can_pin_messages)
+ << make_named_pair(can_promote_members);
+;
+return api->ApiCallAsync<std::variant<bool>,bool>("promoteChatMember",builder);
+}
 std::pair<bool,opt_error> Bot::setChatAdministratorCustomTitle ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															int64_t	user_id,
@@ -664,6 +1515,18 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::setChatAdministratorCustomTitleAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id,
+															const std::string& 	custom_title
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(user_id)
+ << make_named_pair(custom_title);
+;
+return api->ApiCallAsync<bool>("setChatAdministratorCustomTitle",builder);
+}
 std::pair<bool,opt_error> Bot::setChatPermissions ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const ChatPermissions& 	permissions
@@ -674,6 +1537,16 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::setChatPermissionsAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const ChatPermissions& 	permissions
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(permissions);
+;
+return api->ApiCallAsync<bool>("setChatPermissions",builder);
+}
 std::pair<std::string,opt_error> Bot::exportChatInviteLink ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const {
@@ -682,18 +1555,38 @@ builder << make_named_pair(chat_id);
 ;
 return api->ApiCall<std::string>(__func__,builder);
 }
+ApiFuture<std::pair<std::string,opt_error>> Bot::exportChatInviteLinkAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id);
+;
+return api->ApiCallAsync<std::string>("exportChatInviteLink",builder);
+}
 std::pair<bool,opt_error> Bot::setChatPhoto ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	photo
+															const FileSource& 	photo
 ) const {
 QueryBuilder builder;
 builder << make_named_pair(chat_id)
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(1);
-params.push_back(name_value_pair{"photo",std::move(photo)});
+params.push_back(name_file_pair{"photo",photo});
 return api->ApiCall<bool>(__func__,builder,params);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::setChatPhotoAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	photo
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+;
+std::vector<name_file_pair> params;
+params.reserve(1);
+params.push_back(name_file_pair{"photo",photo});
+return api->ApiCallAsync<bool>("setChatPhoto",std::move(builder),std::move(params));
+}
 std::pair<bool,opt_error> Bot::deleteChatPhoto ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const {
@@ -702,6 +1595,14 @@ builder << make_named_pair(chat_id);
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::deleteChatPhotoAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id);
+;
+return api->ApiCallAsync<bool>("deleteChatPhoto",builder);
+}
 std::pair<bool,opt_error> Bot::setChatTitle ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::string& 	title
@@ -712,6 +1613,16 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::setChatTitleAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	title
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(title);
+;
+return api->ApiCallAsync<bool>("setChatTitle",builder);
+}
 std::pair<bool,opt_error> Bot::setChatDescription ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::optional<std::string>& 	description
@@ -722,6 +1633,16 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::setChatDescriptionAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::optional<std::string>& 	description
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(description);
+;
+return api->ApiCallAsync<bool>("setChatDescription",builder);
+}
 std::pair<bool,opt_error> Bot::pinChatMessage ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															int64_t	message_id,
@@ -734,6 +1655,18 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::pinChatMessageAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	message_id,
+															std::optional<bool>	disable_notification
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(message_id)
+ << make_named_pair(disable_notification);
+;
+return api->ApiCallAsync<bool>("pinChatMessage",builder);
+}
 std::pair<bool,opt_error> Bot::unpinChatMessage ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const {
@@ -742,6 +1675,14 @@ builder << make_named_pair(chat_id);
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::unpinChatMessageAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id);
+;
+return api->ApiCallAsync<bool>("unpinChatMessage",builder);
+}
 std::pair<bool,opt_error> Bot::leaveChat ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const {
@@ -750,6 +1691,14 @@ builder << make_named_pair(chat_id);
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::leaveChatAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id);
+;
+return api->ApiCallAsync<bool>("leaveChat",builder);
+}
 std::pair<Chat,opt_error> Bot::getChat ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const {
@@ -758,6 +1707,14 @@ builder << make_named_pair(chat_id);
 ;
 return api->ApiCall<Chat>(__func__,builder);
 }
+ApiFuture<std::pair<Chat,opt_error>> Bot::getChatAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id);
+;
+return api->ApiCallAsync<Chat>("getChat",builder);
+}
 std::pair<std::vector<ChatMember>,opt_error> Bot::getChatAdministrators ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const {
@@ -766,6 +1723,14 @@ builder << make_named_pair(chat_id);
 ;
 return api->ApiCall<std::vector<ChatMember>>(__func__,builder);
 }
+ApiFuture<std::pair<std::vector<ChatMember>,opt_error>> Bot::getChatAdministratorsAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id);
+;
+return api->ApiCallAsync<std::vector<ChatMember>>("getChatAdministrators",builder);
+}
 std::pair<int64_t,opt_error> Bot::getChatMembersCount ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const {
@@ -774,6 +1739,14 @@ builder << make_named_pair(chat_id);
 ;
 return api->ApiCall<int64_t>(__func__,builder);
 }
+ApiFuture<std::pair<int64_t,opt_error>> Bot::getChatMembersCountAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id);
+;
+return api->ApiCallAsync<int64_t>("getChatMembersCount",builder);
+}
 std::pair<ChatMember,opt_error> Bot::getChatMember ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															int64_t	user_id
@@ -784,6 +1757,16 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<ChatMember>(__func__,builder);
 }
+ApiFuture<std::pair<ChatMember,opt_error>> Bot::getChatMemberAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	user_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(user_id);
+;
+return api->ApiCallAsync<ChatMember>("getChatMember",builder);
+}
 std::pair<bool,opt_error> Bot::setChatStickerSet ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															const std::string& 	sticker_set_name
@@ -794,6 +1777,16 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::setChatStickerSetAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const std::string& 	sticker_set_name
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(sticker_set_name);
+;
+return api->ApiCallAsync<bool>("setChatStickerSet",builder);
+}
 std::pair<bool,opt_error> Bot::deleteChatStickerSet ( 
 															const std::variant<int64_t,std::string>& 	chat_id
 ) const {
@@ -802,6 +1795,14 @@ builder << make_named_pair(chat_id);
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::deleteChatStickerSetAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id);
+;
+return api->ApiCallAsync<bool>("deleteChatStickerSet",builder);
+}
 std::pair<bool,opt_error> Bot::answerCallbackQuery ( 
 															const std::string& 	callback_query_id,
 															const std::optional<std::string>& 	text,
@@ -818,6 +1819,22 @@ builder << make_named_pair(callback_query_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::answerCallbackQueryAsync ( 
+															const std::string& 	callback_query_id,
+															const std::optional<std::string>& 	text,
+															std::optional<bool>	show_alert,
+															const std::optional<std::string>& 	url,
+															std::optional<int64_t>	cache_time
+) const {
+QueryBuilder builder;
+builder << make_named_pair(callback_query_id)
+ << make_named_pair(text)
+ << make_named_pair(show_alert)
+ << make_named_pair(url)
+ << make_named_pair(cache_time);
+;
+return api->ApiCallAsync<bool>("answerCallbackQuery",builder);
+}
 std::pair<bool,opt_error> Bot::setMyCommands ( 
 															const std::vector<BotCommand>& 	commands
 ) const {
@@ -826,11 +1843,24 @@ builder << make_named_pair(commands);
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::setMyCommandsAsync ( 
+															const std::vector<BotCommand>& 	commands
+) const {
+QueryBuilder builder;
+builder << make_named_pair(commands);
+;
+return api->ApiCallAsync<bool>("setMyCommands",builder);
+}
 std::pair<std::vector<BotCommand>,opt_error> Bot::getMyCommands ( 
 
 ) const {
 return api->ApiCall<std::vector<BotCommand>>(__func__);
 }
+ApiFuture<std::pair<std::vector<BotCommand>,opt_error>> Bot::getMyCommandsAsync ( 
+
+) const {
+return api->ApiCallAsync<std::vector<BotCommand>>("getMyCommands");
+}
 std::pair<std::variant<bool, Message>,opt_error> Bot::editMessageText ( 
 															const std::string& 	text,
 															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
@@ -851,6 +1881,26 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<std::variant<bool, Message>,Message>(__func__,builder);
 }
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> Bot::editMessageTextAsync ( 
+															const std::string& 	text,
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
+															std::optional<int64_t>	message_id,
+															const std::optional<std::string>& 	inline_message_id,
+															const std::optional<std::string>& 	parse_mode,
+															std::optional<bool>	disable_web_page_preview,
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(message_id)
+ << make_named_pair(inline_message_id)
+ << make_named_pair(text)
+ << make_named_pair(parse_mode)
+ << make_named_pair(disable_web_page_preview)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<std::variant<bool, Message>,Message>("editMessageText",builder);
+}
 std::pair<std::variant<bool, Message>,opt_error> Bot::editMessageCaption ( 
 															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
 															std::optional<int64_t>	message_id,
@@ -863,14 +1913,63 @@ QueryBuilder builder;
 builder << make_named_pair(chat_id)
  << make_named_pair(message_id)
  << make_named_pair(inline_message_id)
- << make_named_pair(caption)
- << make_named_pair(parse_mode)
+ << make_named_pair(caption)
+ << make_named_pair(parse_mode)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCall<std::variant<bool, Message>,Message>(__func__,builder);
+}
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> Bot::editMessageCaptionAsync ( 
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
+															std::optional<int64_t>	message_id,
+															const std::optional<std::string>& 	inline_message_id,
+															const std::optional<std::string>& 	caption,
+															const std::optional<std::string>& 	parse_mode,
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(message_id)
+ << make_named_pair(inline_message_id)
+ << make_named_pair(caption)
+ << make_named_pair(parse_mode)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<std::variant<bool, Message>,Message>("editMessageCaption",builder);
+}
+std::pair<std::variant<bool, Message>,opt_error> Bot::editMessageMedia ( 
+															const InputMedia& 	media,
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
+															std::optional<int64_t>	message_id,
+															const std::optional<std::string>& 	inline_message_id,
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(message_id)
+ << make_named_pair(inline_message_id)
+ << make_named_pair(media)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCall<std::variant<bool, Message>,Message>(__func__,builder);
+}
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> Bot::editMessageMediaAsync ( 
+															const InputMedia& 	media,
+															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
+															std::optional<int64_t>	message_id,
+															const std::optional<std::string>& 	inline_message_id,
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(message_id)
+ << make_named_pair(inline_message_id)
+ << make_named_pair(media)
  << make_named_pair(reply_markup);
 ;
-return api->ApiCall<std::variant<bool, Message>,Message>(__func__,builder);
+return api->ApiCallAsync<std::variant<bool, Message>,Message>("editMessageMedia",builder);
 }
-std::pair<std::variant<bool, Message>,opt_error> Bot::editMessageMedia ( 
-															const InputMedia& 	media,
+std::pair<std::variant<bool, Message>,opt_error> Bot::editMessageReplyMarkup ( 
 															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
 															std::optional<int64_t>	message_id,
 															const std::optional<std::string>& 	inline_message_id,
@@ -880,12 +1979,11 @@ QueryBuilder builder;
 builder << make_named_pair(chat_id)
  << make_named_pair(message_id)
  << make_named_pair(inline_message_id)
- << make_named_pair(media)
  << make_named_pair(reply_markup);
 ;
 return api->ApiCall<std::variant<bool, Message>,Message>(__func__,builder);
 }
-std::pair<std::variant<bool, Message>,opt_error> Bot::editMessageReplyMarkup ( 
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> Bot::editMessageReplyMarkupAsync ( 
 															const std::optional<std::variant<int64_t,std::string>>& 	chat_id,
 															std::optional<int64_t>	message_id,
 															const std::optional<std::string>& 	inline_message_id,
@@ -897,7 +1995,7 @@ builder << make_named_pair(chat_id)
  << make_named_pair(inline_message_id)
  << make_named_pair(reply_markup);
 ;
-return api->ApiCall<std::variant<bool, Message>,Message>(__func__,builder);
+return api->ApiCallAsync<std::variant<bool, Message>,Message>("editMessageReplyMarkup",builder);
 }
 std::pair<Poll,opt_error> Bot::stopPoll ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
@@ -911,6 +2009,18 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<Poll>(__func__,builder);
 }
+ApiFuture<std::pair<Poll,opt_error>> Bot::stopPollAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	message_id,
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(message_id)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<Poll>("stopPoll",builder);
+}
 std::pair<bool,opt_error> Bot::deleteMessage ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
 															int64_t	message_id
@@ -921,9 +2031,19 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::deleteMessageAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															int64_t	message_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(message_id);
+;
+return api->ApiCallAsync<bool>("deleteMessage",builder);
+}
 std::pair<Message,opt_error> Bot::sendSticker ( 
 															const std::variant<int64_t,std::string>& 	chat_id,
-															const std::string& 	sticker,
+															const FileSource& 	sticker,
 															std::optional<bool>	disable_notification,
 															std::optional<int64_t>	reply_to_message_id,
 															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
@@ -934,11 +2054,29 @@ builder << make_named_pair(chat_id)
  << make_named_pair(reply_to_message_id)
  << make_named_pair(reply_markup);
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(1);
-params.push_back(name_value_pair{"sticker",std::move(sticker)});
+params.push_back(name_file_pair{"sticker",sticker});
 return api->ApiCall<Message>(__func__,builder,params);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::sendStickerAsync ( 
+															const std::variant<int64_t,std::string>& 	chat_id,
+															const FileSource& 	sticker,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<std::variant<InlineKeyboardMarkup,ReplyKeyboardMarkup,ReplyKeyboardRemove,ForceReply>>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+std::vector<name_file_pair> params;
+params.reserve(1);
+params.push_back(name_file_pair{"sticker",sticker});
+return api->ApiCallAsync<Message>("sendSticker",std::move(builder),std::move(params));
+}
 std::pair<StickerSet,opt_error> Bot::getStickerSet ( 
 															const std::string& 	name
 ) const {
@@ -947,25 +2085,45 @@ builder << make_named_pair(name);
 ;
 return api->ApiCall<StickerSet>(__func__,builder);
 }
+ApiFuture<std::pair<StickerSet,opt_error>> Bot::getStickerSetAsync ( 
+															const std::string& 	name
+) const {
+QueryBuilder builder;
+builder << make_named_pair(name);
+;
+return api->ApiCallAsync<StickerSet>("getStickerSet",builder);
+}
 std::pair<File,opt_error> Bot::uploadStickerFile ( 
 															int64_t	user_id,
-															const std::string& 	png_sticker
+															const FileSource& 	png_sticker
 ) const {
 QueryBuilder builder;
 builder << make_named_pair(user_id)
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(1);
-params.push_back(name_value_pair{"png_sticker",std::move(png_sticker)});
+params.push_back(name_file_pair{"png_sticker",png_sticker});
 return api->ApiCall<File>(__func__,builder,params);
 }
+ApiFuture<std::pair<File,opt_error>> Bot::uploadStickerFileAsync ( 
+															int64_t	user_id,
+															const FileSource& 	png_sticker
+) const {
+QueryBuilder builder;
+builder << make_named_pair(user_id)
+;
+std::vector<name_file_pair> params;
+params.reserve(1);
+params.push_back(name_file_pair{"png_sticker",png_sticker});
+return api->ApiCallAsync<File>("uploadStickerFile",std::move(builder),std::move(params));
+}
 std::pair<bool,opt_error> Bot::createNewStickerSet ( 
 															int64_t	user_id,
 															const std::string& 	name,
 															const std::string& 	title,
 															const std::string& 	emojis,
-															const std::optional<std::string>& 	png_sticker,
-															const std::optional<std::string>& 	tgs_sticker,
+															const std::optional<FileSource>& 	png_sticker,
+															const std::optional<FileSource>& 	tgs_sticker,
 															std::optional<bool>	contains_masks,
 															const std::optional<MaskPosition>& 	mask_position
 ) const {
@@ -977,20 +2135,46 @@ builder << make_named_pair(user_id)
  << make_named_pair(contains_masks)
  << make_named_pair(mask_position);
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(2);
 if (png_sticker.has_value())
-	params.push_back(name_value_pair{"png_sticker",std::move(png_sticker.value())});
+	params.push_back(name_file_pair{"png_sticker",png_sticker.value()});
 if (tgs_sticker.has_value())
-	params.push_back(name_value_pair{"tgs_sticker",std::move(tgs_sticker.value())});
+	params.push_back(name_file_pair{"tgs_sticker",tgs_sticker.value()});
 return api->ApiCall<bool>(__func__,builder,params);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::createNewStickerSetAsync ( 
+															int64_t	user_id,
+															const std::string& 	name,
+															const std::string& 	title,
+															const std::string& 	emojis,
+															const std::optional<FileSource>& 	png_sticker,
+															const std::optional<FileSource>& 	tgs_sticker,
+															std::optional<bool>	contains_masks,
+															const std::optional<MaskPosition>& 	mask_position
+) const {
+QueryBuilder builder;
+builder << make_named_pair(user_id)
+ << make_named_pair(name)
+ << make_named_pair(title)
+ << make_named_pair(emojis)
+ << make_named_pair(contains_masks)
+ << make_named_pair(mask_position);
+;
+std::vector<name_file_pair> params;
+params.reserve(2);
+if (png_sticker.has_value())
+	params.push_back(name_file_pair{"png_sticker",png_sticker.value()});
+if (tgs_sticker.has_value())
+	params.push_back(name_file_pair{"tgs_sticker",tgs_sticker.value()});
+return api->ApiCallAsync<bool>("createNewStickerSet",std::move(builder),std::move(params));
+}
 std::pair<bool,opt_error> Bot::addStickerToSet ( 
 															int64_t	user_id,
 															const std::string& 	name,
 															const std::string& 	emojis,
-															const std::optional<std::string>& 	png_sticker,
-															const std::optional<std::string>& 	tgs_sticker,
+															const std::optional<FileSource>& 	png_sticker,
+															const std::optional<FileSource>& 	tgs_sticker,
 															const std::optional<MaskPosition>& 	mask_position
 ) const {
 QueryBuilder builder;
@@ -999,14 +2183,36 @@ builder << make_named_pair(user_id)
  << make_named_pair(emojis)
  << make_named_pair(mask_position);
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(2);
 if (png_sticker.has_value())
-	params.push_back(name_value_pair{"png_sticker",std::move(png_sticker.value())});
+	params.push_back(name_file_pair{"png_sticker",png_sticker.value()});
 if (tgs_sticker.has_value())
-	params.push_back(name_value_pair{"tgs_sticker",std::move(tgs_sticker.value())});
+	params.push_back(name_file_pair{"tgs_sticker",tgs_sticker.value()});
 return api->ApiCall<bool>(__func__,builder,params);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::addStickerToSetAsync ( 
+															int64_t	user_id,
+															const std::string& 	name,
+															const std::string& 	emojis,
+															const std::optional<FileSource>& 	png_sticker,
+															const std::optional<FileSource>& 	tgs_sticker,
+															const std::optional<MaskPosition>& 	mask_position
+) const {
+QueryBuilder builder;
+builder << make_named_pair(user_id)
+ << make_named_pair(name)
+ << make_named_pair(emojis)
+ << make_named_pair(mask_position);
+;
+std::vector<name_file_pair> params;
+params.reserve(2);
+if (png_sticker.has_value())
+	params.push_back(name_file_pair{"png_sticker",png_sticker.value()});
+if (tgs_sticker.has_value())
+	params.push_back(name_file_pair{"tgs_sticker",tgs_sticker.value()});
+return api->ApiCallAsync<bool>("addStickerToSet",std::move(builder),std::move(params));
+}
 std::pair<bool,opt_error> Bot::setStickerPositionInSet ( 
 															const std::string& 	sticker,
 															int64_t	position
@@ -1017,6 +2223,16 @@ builder << make_named_pair(sticker)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::setStickerPositionInSetAsync ( 
+															const std::string& 	sticker,
+															int64_t	position
+) const {
+QueryBuilder builder;
+builder << make_named_pair(sticker)
+ << make_named_pair(position);
+;
+return api->ApiCallAsync<bool>("setStickerPositionInSet",builder);
+}
 std::pair<bool,opt_error> Bot::deleteStickerFromSet ( 
 															const std::string& 	sticker
 ) const {
@@ -1025,21 +2241,44 @@ builder << make_named_pair(sticker);
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::deleteStickerFromSetAsync ( 
+															const std::string& 	sticker
+) const {
+QueryBuilder builder;
+builder << make_named_pair(sticker);
+;
+return api->ApiCallAsync<bool>("deleteStickerFromSet",builder);
+}
 std::pair<bool,opt_error> Bot::setStickerSetThumb ( 
 															const std::string& 	name,
 															int64_t	user_id,
-															const std::optional<std::string>& 	thumb
+															const std::optional<FileSource>& 	thumb
 ) const {
 QueryBuilder builder;
 builder << make_named_pair(name)
  << make_named_pair(user_id)
 ;
-std::vector<name_value_pair> params;
+std::vector<name_file_pair> params;
 params.reserve(1);
 if (thumb.has_value())
-	params.push_back(name_value_pair{"thumb",std::move(thumb.value())});
+	params.push_back(name_file_pair{"thumb",thumb.value()});
 return api->ApiCall<bool>(__func__,builder,params);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::setStickerSetThumbAsync ( 
+															const std::string& 	name,
+															int64_t	user_id,
+															const std::optional<FileSource>& 	thumb
+) const {
+QueryBuilder builder;
+builder << make_named_pair(name)
+ << make_named_pair(user_id)
+;
+std::vector<name_file_pair> params;
+params.reserve(1);
+if (thumb.has_value())
+	params.push_back(name_file_pair{"thumb",thumb.value()});
+return api->ApiCallAsync<bool>("setStickerSetThumb",std::move(builder),std::move(params));
+}
 std::pair<bool,opt_error> Bot::answerInlineQuery ( 
 															const std::string& 	inline_query_id,
 															const std::vector<InlineQueryResult>& 	results,
@@ -1060,6 +2299,26 @@ builder << make_named_pair(inline_query_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::answerInlineQueryAsync ( 
+															const std::string& 	inline_query_id,
+															const std::vector<InlineQueryResult>& 	results,
+															std::optional<int64_t>	cache_time,
+															std::optional<bool>	is_personal,
+															const std::optional<std::string>& 	next_offset,
+															const std::optional<std::string>& 	switch_pm_text,
+															const std::optional<std::string>& 	switch_pm_parameter
+) const {
+QueryBuilder builder;
+builder << make_named_pair(inline_query_id)
+ << make_named_pair(results)
+ << make_named_pair(cache_time)
+ << make_named_pair(is_personal)
+ << make_named_pair(next_offset)
+ << make_named_pair(switch_pm_text)
+ << make_named_pair(switch_pm_parameter);
+;
+return api->ApiCallAsync<bool>("answerInlineQuery",builder);
+}
 std::pair<Message,opt_error> Bot::sendInvoice ( 
 															int64_t	chat_id,
 															const std::string& 	title,
@@ -1112,6 +2371,58 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<Message>(__func__,builder);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::sendInvoiceAsync ( 
+															int64_t	chat_id,
+															const std::string& 	title,
+															const std::string& 	description,
+															const std::string& 	payload,
+															const std::string& 	provider_token,
+															const std::string& 	start_parameter,
+															const std::string& 	currency,
+															const std::vector<LabeledPrice>& 	prices,
+															const std::optional<std::string>& 	provider_data,
+															const std::optional<std::string>& 	photo_url,
+															std::optional<int64_t>	photo_size,
+															std::optional<int64_t>	photo_width,
+															std::optional<int64_t>	photo_height,
+															std::optional<bool>	need_name,
+															std::optional<bool>	need_phone_number,
+															std::optional<bool>	need_email,
+															std::optional<bool>	need_shipping_address,
+															std::optional<bool>	send_phone_number_to_provider,
+															std::optional<bool>	send_email_to_provider,
+															std::optional<bool>	is_flexible,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(title)
+ << make_named_pair(description)
+ << make_named_pair(payload)
+ << make_named_pair(provider_token)
+ << make_named_pair(start_parameter)
+ << make_named_pair(currency)
+ << make_named_pair(prices)
+ << make_named_pair(provider_data)
+ << make_named_pair(photo_url)
+ << make_named_pair(photo_size)
+ << make_named_pair(photo_width)
+ << make_named_pair(photo_height)
+ << make_named_pair(need_name)
+ << make_named_pair(need_phone_number)
+ << make_named_pair(need_email)
+ << make_named_pair(need_shipping_address)
+ << make_named_pair(send_phone_number_to_provider)
+ << make_named_pair(send_email_to_provider)
+ << make_named_pair(is_flexible)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<Message>("sendInvoice",builder);
+}
 std::pair<bool,opt_error> Bot::answerShippingQuery ( 
 															const std::string& 	shipping_query_id,
 															bool	ok,
@@ -1126,6 +2437,20 @@ builder << make_named_pair(shipping_query_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::answerShippingQueryAsync ( 
+															const std::string& 	shipping_query_id,
+															bool	ok,
+															const std::optional<std::vector<ShippingOption>>& 	shipping_options,
+															const std::optional<std::string>& 	error_message
+) const {
+QueryBuilder builder;
+builder << make_named_pair(shipping_query_id)
+ << make_named_pair(ok)
+ << make_named_pair(shipping_options)
+ << make_named_pair(error_message);
+;
+return api->ApiCallAsync<bool>("answerShippingQuery",builder);
+}
 std::pair<bool,opt_error> Bot::answerPreCheckoutQuery ( 
 															const std::string& 	pre_checkout_query_id,
 															bool	ok,
@@ -1138,6 +2463,18 @@ builder << make_named_pair(pre_checkout_query_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::answerPreCheckoutQueryAsync ( 
+															const std::string& 	pre_checkout_query_id,
+															bool	ok,
+															const std::optional<std::string>& 	error_message
+) const {
+QueryBuilder builder;
+builder << make_named_pair(pre_checkout_query_id)
+ << make_named_pair(ok)
+ << make_named_pair(error_message);
+;
+return api->ApiCallAsync<bool>("answerPreCheckoutQuery",builder);
+}
 std::pair<bool,opt_error> Bot::setPassportDataErrors ( 
 															int64_t	user_id,
 															const std::vector<PassportElementError>& 	errors
@@ -1148,6 +2485,16 @@ builder << make_named_pair(user_id)
 ;
 return api->ApiCall<bool>(__func__,builder);
 }
+ApiFuture<std::pair<bool,opt_error>> Bot::setPassportDataErrorsAsync ( 
+															int64_t	user_id,
+															const std::vector<PassportElementError>& 	errors
+) const {
+QueryBuilder builder;
+builder << make_named_pair(user_id)
+ << make_named_pair(errors);
+;
+return api->ApiCallAsync<bool>("setPassportDataErrors",builder);
+}
 std::pair<Message,opt_error> Bot::sendGame ( 
 															int64_t	chat_id,
 															const std::string& 	game_short_name,
@@ -1164,6 +2511,22 @@ builder << make_named_pair(chat_id)
 ;
 return api->ApiCall<Message>(__func__,builder);
 }
+ApiFuture<std::pair<Message,opt_error>> Bot::sendGameAsync ( 
+															int64_t	chat_id,
+															const std::string& 	game_short_name,
+															std::optional<bool>	disable_notification,
+															std::optional<int64_t>	reply_to_message_id,
+															const std::optional<InlineKeyboardMarkup>& 	reply_markup
+) const {
+QueryBuilder builder;
+builder << make_named_pair(chat_id)
+ << make_named_pair(game_short_name)
+ << make_named_pair(disable_notification)
+ << make_named_pair(reply_to_message_id)
+ << make_named_pair(reply_markup);
+;
+return api->ApiCallAsync<Message>("sendGame",builder);
+}
 std::pair<std::variant<bool, Message>,opt_error> Bot::setGameScore ( 
 															int64_t	user_id,
 															int64_t	score,
@@ -1184,6 +2547,26 @@ builder << make_named_pair(user_id)
 ;
 return api->ApiCall<std::variant<bool, Message>,Message>(__func__,builder);
 }
+ApiFuture<std::pair<std::variant<bool, Message>,opt_error>> Bot::setGameScoreAsync ( 
+															int64_t	user_id,
+															int64_t	score,
+															std::optional<bool>	force,
+															std::optional<bool>	disable_edit_message,
+															std::optional<int64_t>	chat_id,
+															std::optional<int64_t>	message_id,
+															const std::optional<std::string>& 	inline_message_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(user_id)
+ << make_named_pair(score)
+ << make_named_pair(force)
+ << make_named_pair(disable_edit_message)
+ << make_named_pair(chat_id)
+ << make_named_pair(message_id)
+ << make_named_pair(inline_message_id);
+;
+return api->ApiCallAsync<std::variant<bool, Message>,Message>("setGameScore",builder);
+}
 std::pair<std::vector<GameHighScore>,opt_error> Bot::getGameHighScores ( 
 															int64_t	user_id,
 															std::optional<int64_t>	chat_id,
@@ -1198,4 +2581,18 @@ builder << make_named_pair(user_id)
 ;
 return api->ApiCall<std::vector<GameHighScore>>(__func__,builder);
 }
+ApiFuture<std::pair<std::vector<GameHighScore>,opt_error>> Bot::getGameHighScoresAsync ( 
+															int64_t	user_id,
+															std::optional<int64_t>	chat_id,
+															std::optional<int64_t>	message_id,
+															const std::optional<std::string>& 	inline_message_id
+) const {
+QueryBuilder builder;
+builder << make_named_pair(user_id)
+ << make_named_pair(chat_id)
+ << make_named_pair(message_id)
+ << make_named_pair(inline_message_id);
+;
+return api->ApiCallAsync<std::vector<GameHighScore>>("getGameHighScores",builder);
+}
 }
@@ -1,3 +1,6 @@
+#include <array>
+#include <chrono>
+#include <map>
 #include <type_traits>
 #include <future>
 #include <fmt/format.h>
@@ -6,24 +9,333 @@
 
 using namespace telegram;
 
+namespace {
+/// names of update types in the order of Callbacks alternatives
+constexpr std::array<std::string_view, std::variant_size_v<Callbacks>> update_types{
+    "message", "callback_query", "inline_query",
+    "chosen_inline_result", "shipping_query", "pre_checkout_query"};
+/// every update type that Update can carry
+constexpr std::array<std::string_view, 11> all_update_types{
+    "message", "edited_message", "channel_post", "edited_channel_post", "inline_query",
+    "chosen_inline_result", "callback_query", "shipping_query", "pre_checkout_query",
+    "poll", "poll_answer"};
+
+/// date of the message carried by update, 0 if update carries no message
+int64_t messageDate(const rapidjson::Value &update) {
+    for (const char *field : {"message", "edited_message", "channel_post", "edited_channel_post"}) {
+        auto message = update.FindMember(field);
+        if (message == update.MemberEnd() || !message->value.IsObject())
+            continue;
+        auto date = message->value.FindMember("date");
+        if (date != message->value.MemberEnd() && date->value.IsInt64())
+            return date->value.GetInt64();
+    }
+    return 0;
+}
+/// chat and message id of edited message, empty if update is not an edit
+std::optional<std::pair<int64_t, int64_t>> editedMessage(const rapidjson::Value &update) {
+    for (const char *field : {"edited_message", "edited_channel_post"}) {
+        auto message = update.FindMember(field);
+        if (message == update.MemberEnd() || !message->value.IsObject())
+            continue;
+        const auto &value = message->value;
+        if (value.HasMember("chat") && value["chat"].HasMember("id") && value.HasMember("message_id"))
+            return std::pair{value["chat"]["id"].GetInt64(), value["message_id"].GetInt64()};
+    }
+    return {};
+}
+std::chrono::milliseconds idleTimeout(const Sequences &sequence) {
+    return std::visit([](const auto& value){
+        return value ? value->idleTimeout() : std::chrono::milliseconds(0);
+    },sequence);
+}
+int64_t unixTime() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+}
+}
+
 void UpdateManager::setUpdateCallback(UpdateCallback &&cb) {
+    handles_all = static_cast<bool>(cb);
     callback = cb;
 }
+std::vector<std::string_view> UpdateManager::allowedUpdates() const {
+    // the list is always explicit, Telegram keeps the list of the previous request if it is omitted,
+    // an empty list means that nothing is handled yet (see Bot::start)
+    if (handles_all)
+        return {all_update_types.begin(), all_update_types.end()};
+    const uint32_t kinds = handled_kinds.load(std::memory_order_relaxed);
+    std::vector<std::string_view> types;
+    for (std::size_t i = 0; i < update_types.size(); ++i)
+        if (kinds & (uint32_t{1} << i))
+            types.push_back(update_types[i]);
+    return types;
+}
 void UpdateManager::addSequence(int64_t user_id, const Sequences& callback) {
     utility::Logger::info(fmt::format("Sequence set for user {}",user_id));
-    dispatcher[user_id] = callback;
+    addHandledKind(callback.index());
+    const auto ttl = idleTimeout(callback);
+    std::optional<uint32_t> timer;
+    // keep revision growing, so transitions still running for the previous entry
+    // do not overwrite the new one
+    if (!dispatcher.visit(user_id,[&](SequenceEntry& entry){
+            timer = armIdleTimeout(entry, ttl);
+            entry.sequence = callback;
+            entry.state = SequenceState{0, entry.state.revision + 1, {}};
+            // inputs sent to the previous sequence are not meant for this one,
+            // the queue is kept for the running transition
+            if (entry.pending)
+                entry.pending->clear();
+            persistState(user_id, entry.sequence, entry.state);
+        })) {
+        SequenceEntry entry{callback, {}};
+        timer = armIdleTimeout(entry, ttl);
+        dispatcher.insert_or_assign(user_id, std::move(entry));
+        persistState(user_id, callback, {});
+    }
+    writeStates();
+    if (timer)
+        scheduleIdleTimeout(user_id, *timer, ttl);
+}
+UpdateManager::~UpdateManager() {
+    {
+        std::unique_lock lock(timers_mutex);
+        timers_stop = true;
+    }
+    timers_condition.notify_all();
+    if (timers_thread.joinable())
+        timers_thread.join();
+}
+std::optional<uint32_t> UpdateManager::armIdleTimeout(SequenceEntry &entry,
+                                                      std::chrono::milliseconds ttl) {
+    const auto now = std::chrono::steady_clock::now();
+    // the running timer is rescheduled on expiration if it is too early
+    const bool armed = entry.idle_timer &&
+                       entry.last_activity + idleTimeout(entry.sequence) <= now + ttl;
+    entry.last_activity = now;
+    if (ttl.count() <= 0 || armed)
+        return {};
+    // 0 stands for no timer
+    do {
+        entry.idle_timer = ++idle_timer_ids;
+    } while (!entry.idle_timer);
+    return entry.idle_timer;
+}
+void UpdateManager::scheduleIdleTimeout(int64_t user_id, uint32_t timer,
+                                        std::chrono::milliseconds ttl) {
+    std::unique_lock lock(timers_mutex);
+    idle_timers.schedule(user_id, timer, ttl);
+    if (!timers_thread.joinable())
+        timers_thread = std::thread([this]{ runIdleTimers(); });
+}
+void UpdateManager::expireSequence(int64_t user_id, uint32_t timer) {
+    std::optional<std::chrono::milliseconds> remaining;
+    auto entry = dispatcher.extract_if(user_id,[&](SequenceEntry& value){
+        if (value.idle_timer != timer)
+            return false;
+        const auto ttl = idleTimeout(value.sequence);
+        if (ttl.count() <= 0) {
+            value.idle_timer = 0;
+            return false;
+        }
+        // the entry was active since the timer was scheduled, wait for the rest of timeout
+        const auto now = std::chrono::steady_clock::now();
+        const auto deadline = value.last_activity + ttl;
+        if (deadline > now) {
+            remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - now);
+            return false;
+        }
+        forgetState(user_id);
+        return true;
+    });
+    writeStates();
+    if (remaining)
+        scheduleIdleTimeout(user_id, timer, *remaining);
+    if (!entry)
+        return;
+    utility::Logger::info(fmt::format("Sequence for user {} expired",user_id));
+    std::visit([&](const auto& sequence){
+        if (sequence && sequence->timeoutEvent())
+            pool.enqueue(sequence->timeoutEvent(),user_id);
+    },entry->sequence);
+}
+void UpdateManager::runIdleTimers() {
+    std::vector<std::pair<int64_t, uint32_t>> expired;
+    std::unique_lock lock(timers_mutex);
+    while (!timers_stop) {
+        timers_condition.wait_for(lock, idle_timers.getResolution());
+        idle_timers.advance(std::chrono::steady_clock::now(),[&](int64_t user_id, uint32_t timer){
+            expired.emplace_back(user_id, timer);
+        });
+        if (expired.empty())
+            continue;
+        // eviction locks dispatcher shards, so timers are not blocked meanwhile
+        lock.unlock();
+        for (auto [user_id, timer] : expired)
+            expireSequence(user_id, timer);
+        expired.clear();
+        lock.lock();
+    }
+}
+void UpdateManager::runSequence(int64_t user_id) {
+    for (;;) {
+        std::optional<Sequences> sequence;
+        SequenceState state;
+        std::string object;
+        dispatcher.visit(user_id,[&](SequenceEntry& entry){
+            if (!entry.pending || entry.pending->empty()) {
+                entry.pending.reset();
+                return;
+            }
+            object = std::move(entry.pending->front());
+            entry.pending->pop_front();
+            sequence = entry.sequence;
+            state.step = entry.state.step;
+            state.revision = entry.state.revision;
+        });
+        // every input is handled or the sequence was removed with its inputs
+        if (!sequence)
+            return;
+        std::visit([&](const auto& value){
+            using arg_type = typename std::decay_t<decltype(*value)>::ArgType;
+            if (!value || value->finished(state.step))
+                return;
+            std::size_t step = state.step;
+            try {
+                step = value->input(state.step,JsonParser::i().fromJson<arg_type>(object));
+            } catch (const std::exception &e) {
+                utility::Logger::warn("Transition of sequence for user ",user_id," failed: ",e.what());
+                return;
+            } catch (...) {
+                utility::Logger::warn("Transition of sequence for user ",user_id," failed");
+                return;
+            }
+            if (step == state.step)
+                return;
+            // store new step unless the entry was changed while transition was running
+            if (value->finished(step)) {
+                dispatcher.erase_if(user_id,[&](const SequenceEntry& entry){
+                    if (entry.sequence != *sequence || entry.state.revision != state.revision)
+                        return false;
+                    forgetState(user_id);
+                    return true;
+                });
+            } else {
+                dispatcher.visit(user_id,[&](SequenceEntry& entry){
+                    if (entry.sequence == *sequence && entry.state.revision == state.revision) {
+                        entry.state.step = static_cast<uint32_t>(step);
+                        ++entry.state.revision;
+                        persistState(user_id, entry.sequence, entry.state);
+                    }
+                });
+            }
+            writeStates();
+        },*sequence);
+    }
 }
 
 void UpdateManager::removeSequence(int64_t user_id) {
-    dispatcher.erase(user_id);
+    dispatcher.erase_if(user_id,[&](const SequenceEntry&){
+        forgetState(user_id);
+        return true;
+    });
+    writeStates();
+}
+void UpdateManager::registerSequence(const std::string &name, const Sequences &sequence) {
+    addHandledKind(sequence.index());
+    named_sequences.insert_or_assign(name, sequence);
+    sequence_names.insert_or_assign(std::visit([](const auto& value) -> const void* {
+        return value.get();
+    },sequence), name);
+}
+void UpdateManager::setStateStore(std::unique_ptr<StateStore> store) {
+    state_store = std::move(store);
+    if (!state_store)
+        return;
+    std::size_t restored = 0;
+    for (auto &stored : state_store->load()) {
+        auto it = named_sequences.find(stored.sequence);
+        if (it == named_sequences.end())
+            continue;
+        const auto ttl = idleTimeout(it->second);
+        SequenceEntry entry{it->second, std::move(stored.state)};
+        const auto timer = armIdleTimeout(entry, ttl);
+        dispatcher.insert_or_assign(stored.id, std::move(entry));
+        if (timer)
+            scheduleIdleTimeout(stored.id, *timer, ttl);
+        ++restored;
+    }
+    utility::Logger::info(fmt::format("Restored {} sequence states",restored));
+}
+void UpdateManager::persistState(int64_t user_id, const Sequences &sequence,
+                                 const SequenceState &state) {
+    if (!state_store)
+        return;
+    auto it = sequence_names.find(std::visit([](const auto& value) -> const void* {
+        return value.get();
+    },sequence));
+    if (it == sequence_names.end())
+        return;
+    std::unique_lock lock(state_mutex);
+    state_changes.push_back(StateChange{user_id, it->second, state});
+}
+void UpdateManager::forgetState(int64_t user_id) {
+    if (!state_store)
+        return;
+    std::unique_lock lock(state_mutex);
+    state_changes.push_back(StateChange{user_id, {}, {}});
+}
+void UpdateManager::writeStates() {
+    std::unique_lock lock(state_mutex);
+    // the thread that is writing already takes changes queued by others
+    if (writing_states || state_changes.empty())
+        return;
+    writing_states = true;
+    while (!state_changes.empty()) {
+        auto change = std::move(state_changes.front());
+        state_changes.pop_front();
+        lock.unlock();
+        try {
+            if (change.state)
+                state_store->save(change.id, change.sequence, *change.state);
+            else
+                state_store->erase(change.id);
+        } catch (const std::exception &e) {
+            utility::Logger::warn("Unable to store sequence state of user ",change.id,": ",e.what());
+        }
+        lock.lock();
+    }
+    writing_states = false;
+}
+std::optional<SequenceState> UpdateManager::getSequenceState(int64_t user_id) const {
+    std::optional<SequenceState> state;
+    dispatcher.cvisit(user_id,[&](const SequenceEntry& entry){
+        state = entry.state;
+    });
+    return state;
+}
+bool UpdateManager::setSequenceState(int64_t user_id, SequenceState state) {
+    const bool found = dispatcher.visit(user_id,[&](SequenceEntry& entry){
+        state.revision = entry.state.revision + 1;
+        entry.state = std::move(state);
+        persistState(user_id, entry.sequence, entry.state);
+    });
+    writeStates();
+    return found;
+}
+void UpdateManager::removeWaiter(int64_t user_id) {
+    // destroyed after the shard is unlocked, see addWaiter
+    auto waiter = waiters.extract_if(user_id,[](const Waiter&){ return true; });
 }
 size_t UpdateManager::getOffset() const noexcept {
     return lastUpdate;
 }
 void UpdateManager::addCallback(std::string_view cmd, telegram::Callbacks &&callback) {
+    addHandledKind(callback.index());
     m_callbacks.insert(cmd,callback);
 }
 void UpdateManager::addCallback(std::regex cmd, telegram::Callbacks &&callback) {
+    addHandledKind(callback.index());
     m_regex.emplace_back(cmd,callback);
 }
 void UpdateManager::routeCallback(const std::string &str) {
@@ -63,7 +375,36 @@ void UpdateManager::routeCallback(const std::string &str) {
         if (updates_arr.Size())
             lastUpdate = updates_arr[updates_arr.Size() - 1].GetObject()["update_id"].GetUint64() + 1;
 
-        for (auto &&it : updates_arr) {
+        if (updates_arr.Empty())
+            return;
+        updateCatchUpMode(messageDate(updates_arr[0]));
+        if (!catching_up) {
+            for (auto &&it : updates_arr) {
+                callback_router(it.GetObject());
+            }
+            return;
+        }
+        // catch-up mode: route only the last edit of a message and skip too old messages
+        std::map<std::pair<int64_t, int64_t>, rapidjson::SizeType> last_edit;
+        if (catch_up_policy.collapse_edits) {
+            for (rapidjson::SizeType i = 0; i < updates_arr.Size(); ++i)
+                if (auto edit = editedMessage(updates_arr[i]))
+                    last_edit[*edit] = i;
+        }
+        const int64_t now = unixTime();
+        for (rapidjson::SizeType i = 0; i < updates_arr.Size(); ++i) {
+            const auto &it = updates_arr[i];
+            if (!last_edit.empty()) {
+                if (auto edit = editedMessage(it); edit && last_edit[*edit] != i)
+                    continue;
+            }
+            if (const int64_t date = messageDate(it); catch_up_policy.max_age.count() && date
+                    && now - date > catch_up_policy.max_age.count()) {
+                if (catch_up_policy.on_stale)
+                    pool.enqueue(catch_up_policy.on_stale,
+                                 JsonParser::i().fromJson<Update>(JsonParser::i().rapidObjectToJson(it.GetObject())));
+                continue;
+            }
             callback_router(it.GetObject());
         }
         // the same but with only one element
@@ -76,6 +417,48 @@ void UpdateManager::routeCallback(const std::string &str) {
         return;
     }
 }
+void UpdateManager::setThreadPoolBounds(std::size_t min_threads, std::size_t max_threads) {
+    utility::Logger::info(fmt::format("Threadpool bounds set to [{}, {}]",min_threads,max_threads));
+    std::unique_lock lock(bounds_mutex);
+    min_pool_threads = min_threads;
+    max_pool_threads = max_threads;
+    if (!catching_up || !catch_up_policy.use_all_cores)
+        pool.setBounds(min_threads, max_threads);
+}
+std::pair<std::size_t, std::size_t> UpdateManager::threadPoolBounds() const {
+    std::unique_lock lock(bounds_mutex);
+    return {min_pool_threads, max_pool_threads};
+}
+void UpdateManager::setCatchUpPolicy(CatchUpPolicy policy) {
+    catch_up_policy = std::move(policy);
+}
+bool UpdateManager::catchingUp() const noexcept {
+    return catching_up;
+}
+void UpdateManager::updateCatchUpMode(int64_t first_date) {
+    // updates without date (e.g callback queries) do not change the mode
+    if (!first_date)
+        return;
+    const bool lagging = unixTime() - first_date > catch_up_policy.max_lag.count();
+    if (lagging == catching_up)
+        return;
+    std::unique_lock lock(bounds_mutex);
+    if (lagging == catching_up)
+        return;
+    catching_up = lagging;
+    if (lagging) {
+        utility::Logger::info("Catching up with backlog of updates");
+        if (catch_up_policy.use_all_cores) {
+            // handlers of different users are independent, so the backlog is spread over every core
+            const std::size_t cores = std::max<std::size_t>(std::thread::hardware_concurrency(), 2);
+            pool.setBounds(std::max(min_pool_threads, cores), std::max(max_pool_threads, cores));
+        }
+    } else {
+        utility::Logger::info("Caught up with updates");
+        if (catch_up_policy.use_all_cores)
+            pool.setBounds(min_pool_threads, max_pool_threads);
+    }
+}
 void UpdateManager::setOffset(size_t offset) {
     lastUpdate = offset;
 }
@@ -0,0 +1,158 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace telegram::utility {
+/**
+ * @brief Hash map split into independently locked shards
+ *
+ * Every shard has its own shared_mutex, so lookups never block each other
+ * and a registration only blocks lookups that fall into the same shard.
+ */
+template <class Key, class Value, std::size_t ShardCount = 64,
+          class Hash = std::hash<Key>>
+class ShardedMap {
+    static_assert(ShardCount > 0, "ShardedMap must have at least one shard");
+    // shards are aligned to separate cache lines to avoid false sharing of mutexes
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<Key, Value, Hash> map;
+    };
+    std::array<Shard, ShardCount> shards;
+    std::atomic<std::size_t> m_size{0};
+
+    Shard &shard(const Key &key) {
+        return shards[Hash{}(key) % ShardCount];
+    }
+    const Shard &shard(const Key &key) const {
+        return shards[Hash{}(key) % ShardCount];
+    }
+public:
+    /**
+     * Insert value or replace existing one
+     * @return true if value was inserted, false if it was replaced
+     */
+    bool insert_or_assign(const Key &key, Value value) {
+        auto &s = shard(key);
+        std::unique_lock lock(s.mutex);
+        bool inserted = s.map.insert_or_assign(key, std::move(value)).second;
+        if (inserted)
+            ++m_size;
+        return inserted;
+    }
+    /**
+     * Insert value or replace existing one, the replaced value is returned
+     * so it is destroyed after the shard is unlocked
+     * @return previous value if it was replaced, empty optional otherwise
+     */
+    std::optional<Value> exchange(const Key &key, Value value) {
+        auto &s = shard(key);
+        std::unique_lock lock(s.mutex);
+        auto [it, inserted] = s.map.try_emplace(key, std::move(value));
+        if (inserted) {
+            ++m_size;
+            return {};
+        }
+        return std::exchange(it->second, std::move(value));
+    }
+    /**
+     * Get copy of value
+     * @return value if present, empty optional otherwise
+     */
+    std::optional<Value> find(const Key &key) const {
+        const auto &s = shard(key);
+        std::shared_lock lock(s.mutex);
+        if (auto it = s.map.find(key); it != s.map.end())
+            return it->second;
+        return {};
+    }
+    /**
+     * Call 'f' with reference to the value while shard is exclusively locked
+     * \warning 'f' must not access the map
+     * @return true if value was found
+     */
+    template <class F>
+    bool visit(const Key &key, F &&f) {
+        auto &s = shard(key);
+        std::unique_lock lock(s.mutex);
+        auto it = s.map.find(key);
+        if (it == s.map.end())
+            return false;
+        std::invoke(std::forward<F>(f), it->second);
+        return true;
+    }
+    /**
+     * Call 'f' with const reference to the value while shard is locked for reading
+     * \warning 'f' must not access the map
+     * @return true if value was found
+     */
+    template <class F>
+    bool cvisit(const Key &key, F &&f) const {
+        const auto &s = shard(key);
+        std::shared_lock lock(s.mutex);
+        auto it = s.map.find(key);
+        if (it == s.map.end())
+            return false;
+        std::invoke(std::forward<F>(f), std::as_const(it->second));
+        return true;
+    }
+    /// remove value
+    bool erase(const Key &key) {
+        return erase_if(key, [](const Value &) { return true; });
+    }
+    /**
+     * Remove value if predicate returns true for it
+     * Allows to erase value only if it was not replaced concurrently
+     */
+    template <class Pred>
+    bool erase_if(const Key &key, Pred &&pred) {
+        auto &s = shard(key);
+        std::unique_lock lock(s.mutex);
+        auto it = s.map.find(key);
+        if (it == s.map.end() || !std::invoke(std::forward<Pred>(pred), it->second))
+            return false;
+        s.map.erase(it);
+        --m_size;
+        return true;
+    }
+    /**
+     * Remove value if predicate returns true for it and return the removed value
+     */
+    template <class Pred>
+    std::optional<Value> extract_if(const Key &key, Pred &&pred) {
+        auto &s = shard(key);
+        std::unique_lock lock(s.mutex);
+        auto it = s.map.find(key);
+        if (it == s.map.end() || !std::invoke(std::forward<Pred>(pred), it->second))
+            return {};
+        std::optional<Value> value{std::move(it->second)};
+        s.map.erase(it);
+        --m_size;
+        return value;
+    }
+    /**
+     * Call 'f' for every key and value, locking one shard at a time
+     * \warning 'f' must not access the map
+     */
+    template <class F>
+    void for_each(F &&f) const {
+        for (const auto &s : shards) {
+            std::shared_lock lock(s.mutex);
+            for (const auto &[key, value] : s.map)
+                f(key, value);
+        }
+    }
+    std::size_t size() const noexcept {
+        return m_size.load(std::memory_order_relaxed);
+    }
+    bool empty() const noexcept {
+        return !size();
+    }
+};
+} // namespace telegram::utility
@@ -0,0 +1,183 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "httplib/httplib.h"
+
+namespace telegram::utility {
+/**
+ * @brief Incremental parser of HTTP/1.1 response
+ * Supports Content-Length, chunked transfer encoding and bodies delimited by connection close
+ */
+class HttpResponseParser {
+    enum class State { head, body, chunk_size, chunk_data, chunk_end, trailer, done };
+    State state = State::head;
+    std::string buffer;
+    std::size_t remaining = 0;
+    bool until_close = false;
+
+    static bool iequals(std::string_view a, std::string_view b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+            return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+        });
+    }
+    /// parse non-negative number of 'base', empty if 'value' is not a number
+    static std::optional<std::size_t> number(std::string_view value, int base) {
+        const std::string digits(value.substr(0, value.find_first_not_of(
+                base == 16 ? "0123456789abcdefABCDEF" : "0123456789")));
+        if (digits.empty())
+            return {};
+        return static_cast<std::size_t>(std::strtoull(digits.data(), nullptr, base));
+    }
+
+    bool parseHead(std::string_view head) {
+        auto line_end = head.find("\r\n");
+        std::string_view status_line = head.substr(0, line_end);
+        // HTTP/1.1 200 OK
+        if (status_line.substr(0, 5) != "HTTP/" || status_line.size() < 12)
+            return false;
+        http10 = status_line.substr(5, 3) == "1.0";
+        response->status = std::atoi(std::string(status_line.substr(9, 3)).data());
+        head.remove_prefix(line_end == std::string_view::npos ? head.size() : line_end + 2);
+
+        bool chunked = false;
+        std::optional<std::size_t> length;
+        while (!head.empty()) {
+            auto end = head.find("\r\n");
+            std::string_view line = head.substr(0, end);
+            head.remove_prefix(end == std::string_view::npos ? head.size() : end + 2);
+            auto colon = line.find(':');
+            if (colon == std::string_view::npos)
+                continue;
+            std::string_view name = line.substr(0, colon);
+            std::string_view value = line.substr(colon + 1);
+            while (!value.empty() && value.front() == ' ')
+                value.remove_prefix(1);
+            response->headers.emplace(std::string(name), std::string(value));
+            if (iequals(name, "Content-Length")) {
+                length = number(value, 10);
+                if (!length)
+                    return false;
+            } else if (iequals(name, "Transfer-Encoding") && value.find("chunked") != std::string_view::npos)
+                chunked = true;
+            else if (iequals(name, "Connection"))
+                close = iequals(value, "close");
+        }
+        if (http10 && !response->has_header("Connection"))
+            close = true;
+        if (chunked) {
+            state = State::chunk_size;
+        } else if (length) {
+            remaining = *length;
+            state = remaining ? State::body : State::done;
+        } else if (response->status == 204 || response->status == 304) {
+            state = State::done;
+        } else {
+            until_close = true;
+            close = true;
+            state = State::body;
+        }
+        return true;
+    }
+
+public:
+    /// @param response - empty response that receives parsed data
+    explicit HttpResponseParser(std::shared_ptr<httplib::Response> response)
+        : response{std::move(response)} {
+    }
+
+    std::shared_ptr<httplib::Response> response;
+    bool close = false;
+    bool http10 = false;
+
+    /// consume received data, returns false if response is malformed
+    bool feed(const char *data, std::size_t size) {
+        buffer.append(data, size);
+        for (;;) {
+            switch (state) {
+            case State::head: {
+                auto end = buffer.find("\r\n\r\n");
+                if (end == std::string::npos)
+                    return true;
+                if (!parseHead(std::string_view(buffer).substr(0, end + 2)))
+                    return false;
+                buffer.erase(0, end + 4);
+                break;
+            }
+            case State::body: {
+                if (until_close) {
+                    response->body += buffer;
+                    buffer.clear();
+                    return true;
+                }
+                const std::size_t count = std::min(remaining, buffer.size());
+                response->body.append(buffer, 0, count);
+                buffer.erase(0, count);
+                remaining -= count;
+                if (remaining)
+                    return true;
+                state = State::done;
+                break;
+            }
+            case State::chunk_size: {
+                auto end = buffer.find("\r\n");
+                if (end == std::string::npos)
+                    return true;
+                const auto size = number(buffer.substr(0, end), 16);
+                if (!size)
+                    return false;
+                remaining = *size;
+                buffer.erase(0, end + 2);
+                state = remaining ? State::chunk_data : State::trailer;
+                break;
+            }
+            case State::chunk_data: {
+                const std::size_t count = std::min(remaining, buffer.size());
+                response->body.append(buffer, 0, count);
+                buffer.erase(0, count);
+                remaining -= count;
+                if (remaining)
+                    return true;
+                state = State::chunk_end;
+                break;
+            }
+            case State::chunk_end:
+                if (buffer.size() < 2)
+                    return true;
+                buffer.erase(0, 2);
+                state = State::chunk_size;
+                break;
+            case State::trailer: {
+                auto end = buffer.find("\r\n");
+                if (end == std::string::npos)
+                    return true;
+                buffer.erase(0, end + 2);
+                // empty line finishes trailers
+                if (!end)
+                    state = State::done;
+                break;
+            }
+            case State::done:
+                return true;
+            }
+        }
+    }
+    /// connection was closed by the server
+    bool finishOnClose() {
+        if (state == State::body && until_close)
+            state = State::done;
+        return done();
+    }
+    bool done() const noexcept {
+        return state == State::done;
+    }
+    bool started() const noexcept {
+        return state != State::head || !buffer.empty();
+    }
+};
+} // namespace telegram::utility
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace telegram::utility {
+/**
+ * @brief Pool of objects that are handed out as std::shared_ptr and reused when released
+ *
+ * The pool keeps a reference to every object it created, an object whose only owner \n
+ * is the pool is free, so neither the object nor its control block is allocated again. \n
+ * Objects requested when every pooled object is in use are not pooled.
+ */
+template <class T>
+class SharedPool {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<T>> items;
+    std::size_t capacity;
+    /// the search starts after the last handed out object
+    std::size_t next = 0;
+
+public:
+    explicit SharedPool(std::size_t capacity = 64) : capacity{capacity} {
+    }
+    SharedPool(const SharedPool &) = delete;
+    SharedPool &operator=(const SharedPool &) = delete;
+
+    /**
+     * Get a free object
+     * @param reset - called with a reused object before it is handed out, e.g to clear it
+     */
+    template <class Reset>
+    std::shared_ptr<T> acquire(Reset &&reset) {
+        std::unique_lock lock(mutex);
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            const auto index = (next + i) % items.size();
+            // copies are made under the lock only, so the object can not be taken meanwhile
+            if (items[index].use_count() != 1)
+                continue;
+            // the last owner released the object before use_count was read
+            std::atomic_thread_fence(std::memory_order_acquire);
+            next = index + 1;
+            auto object = items[index];
+            lock.unlock();
+            reset(*object);
+            return object;
+        }
+        if (items.size() < capacity) {
+            items.push_back(std::make_shared<T>());
+            next = items.size();
+            return items.back();
+        }
+        lock.unlock();
+        return std::make_shared<T>();
+    }
+    /// number of pooled objects
+    std::size_t size() {
+        std::unique_lock lock(mutex);
+        return items.size();
+    }
+};
+} // namespace telegram::utility
@@ -1,9 +1,13 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
 #include <vector>
 #include <queue>
+#include <unordered_map>
 #include <memory>
 #include <thread>
 #include <mutex>
+#include <chrono>
 #include <condition_variable>
 #include <future>
 #include <functional>
@@ -11,51 +15,235 @@
 
 namespace telegram::utility {
 
+/**
+ * @brief Elastic thread pool
+ *
+ * Number of workers is kept between 'min_threads' and 'max_threads'. \n
+ * New worker is started when a task waits in the queue longer than 'max_queue_delay' \n
+ * or when every worker is blocked (see ThreadPool::BlockingScope). \n
+ * Worker that has been idle for 'idle_timeout' is retired if there are more than 'min_threads' workers. \n
+ * A control thread checks age of the queue periodically, so the pool grows even when \n
+ * no task is enqueued or taken (e.g every worker is stuck), and joins retired workers.
+ */
 class ThreadPool {
+    using clock = std::chrono::steady_clock;
 public:
+    /// fixed size pool
     ThreadPool(size_t);
+    /// elastic pool
+    ThreadPool(size_t min_threads, size_t max_threads,
+               std::chrono::milliseconds idle_timeout = std::chrono::seconds(30),
+               std::chrono::milliseconds max_queue_delay = std::chrono::milliseconds(20));
     template<class F, class... Args>
     auto enqueue(F&& f, Args&&... args)
     -> std::future<typename std::invoke_result_t<F,Args...>>;
+    /**
+     * Run f(0), ..., f(count - 1) in parallel and wait until every call is finished
+     * The calling thread runs calls too, so it can be a worker of this pool: calls
+     * that no worker has taken yet are run by the caller instead of being waited for.
+     * The first exception thrown by a call is rethrown
+     */
+    template<class F>
+    void parallelFor(size_t count, F&& f);
+    /**
+     * Change bounds of the pool
+     * Extra workers are retired after they finish their current task
+     */
+    void setBounds(size_t min_threads, size_t max_threads);
+    /// current number of workers
+    size_t size();
     ~ThreadPool();
+
+    /**
+     * @brief Marks current worker as blocked (e.g on network call) while the object is alive
+     * If the pool has queued tasks and no idle workers, a new worker is started in place of
+     * the blocked one. Does nothing if called outside of pool thread.
+     */
+    class BlockingScope {
+        ThreadPool* pool;
+    public:
+        BlockingScope() : pool{ThreadPool::current} {
+            if (pool)
+                pool->blockingBegin();
+        }
+        ~BlockingScope() {
+            if (pool)
+                pool->blockingEnd();
+        }
+        BlockingScope(const BlockingScope&) = delete;
+        BlockingScope& operator=(const BlockingScope&) = delete;
+    };
 private:
+    struct Task {
+        std::function<void()> fn;
+        clock::time_point enqueued;
+    };
+    // worker body
+    void work(size_t id);
+    // both require 'queue_mutex' to be locked
+    void spawn();
+    bool needWorker() const;
+
+    void blockingBegin();
+    void blockingEnd();
+    // body of the control thread: grows the pool on queue latency and joins retired workers
+    void control();
+
     // need to keep track of threads so we can join them
-    std::vector< std::thread > workers;
+    std::unordered_map<size_t, std::thread> workers;
+    std::vector<std::thread> retired;
     // the task queue
-    std::queue< std::function<void()> > tasks;
+    std::queue<Task> tasks;
 
     // synchronization
     std::mutex queue_mutex;
     std::condition_variable condition;
+    // wakes the control thread on stop
+    std::condition_variable control_condition;
+    std::thread controller;
     bool stop;
+
+    size_t min_threads;
+    size_t max_threads;
+    std::chrono::milliseconds idle_timeout;
+    std::chrono::milliseconds max_queue_delay;
+    size_t idle = 0;
+    size_t blocked = 0;
+    size_t next_id = 0;
+
+    // pool that owns current thread
+    static inline thread_local ThreadPool* current = nullptr;
 };
 
-// the constructor just launches some amount of workers
 inline ThreadPool::ThreadPool(size_t threads)
-    :   stop(false)
+    :   ThreadPool(threads, threads)
+{
+}
+
+// the constructor just launches minimal amount of workers
+inline ThreadPool::ThreadPool(size_t min_threads, size_t max_threads,
+                              std::chrono::milliseconds idle_timeout,
+                              std::chrono::milliseconds max_queue_delay)
+    :   stop(false), min_threads(min_threads), max_threads(std::max(min_threads, max_threads)),
+        idle_timeout(idle_timeout), max_queue_delay(max_queue_delay)
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    for(size_t i = 0;i<min_threads;++i)
+        spawn();
+    controller = std::thread([this]{ control(); });
+}
+
+inline void ThreadPool::control()
 {
-    for(size_t i = 0;i<threads;++i)
-        workers.emplace_back(
-                    [this]
+    // often enough to notice a task that waits for 'max_queue_delay'
+    const auto period = std::max(max_queue_delay / 2, std::chrono::milliseconds(1));
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (!stop) {
+        control_condition.wait_for(lock, period);
+        if (needWorker())
+            spawn();
+        if (retired.empty())
+            continue;
+        std::vector<std::thread> finished;
+        finished.swap(retired);
+        lock.unlock();
+        for(std::thread &worker: finished)
+            worker.join();
+        lock.lock();
+    }
+}
+
+inline void ThreadPool::spawn()
+{
+    size_t id = next_id++;
+    workers.emplace(id, std::thread([this, id]{ work(id); }));
+}
+
+inline bool ThreadPool::needWorker() const
+{
+    if (stop || tasks.empty() || idle || workers.size() >= max_threads)
+        return false;
+    // every worker is blocked or pool is below its lower bound
+    if (workers.size() <= blocked || workers.size() < min_threads)
+        return true;
+    // queue latency is too high
+    return clock::now() - tasks.front().enqueued >= max_queue_delay;
+}
+
+inline void ThreadPool::work(size_t id)
+{
+    current = this;
+    for(;;)
+    {
+        Task task;
+
         {
-            for(;;)
-            {
-                std::function<void()> task;
-
-                {
-                    std::unique_lock<std::mutex> lock(this->queue_mutex);
-                    this->condition.wait(lock,
-                                         [this]{ return this->stop || !this->tasks.empty(); });
-                    if(this->stop && this->tasks.empty())
-                        return;
-                    task = std::move(this->tasks.front());
-                    this->tasks.pop();
-                }
-
-                task();
+            std::unique_lock<std::mutex> lock(this->queue_mutex);
+            ++idle;
+            bool ready = this->condition.wait_for(lock, idle_timeout,
+                                                 [this]{ return this->stop || !this->tasks.empty()
+                                                                    || this->workers.size() > this->max_threads; });
+            --idle;
+            if(this->stop && this->tasks.empty())
+                return;
+            // retire the worker if it was idle too long or the pool was shrinked
+            if (!stop && ((!ready && workers.size() > min_threads) || workers.size() > max_threads)) {
+                retired.push_back(std::move(workers[id]));
+                workers.erase(id);
+                return;
             }
+            if (!ready)
+                continue;
+            task = std::move(this->tasks.front());
+            this->tasks.pop();
+            // grow if tasks are waiting for too long
+            if (needWorker())
+                spawn();
         }
-        );
+
+        task.fn();
+    }
+}
+
+template<class F>
+void ThreadPool::parallelFor(size_t count, F&& f)
+{
+    if (count < 2) {
+        if (count)
+            f(size_t{0});
+        return;
+    }
+    struct State {
+        std::atomic<size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        size_t done = 0;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    // helpers that start after every call was taken return without touching 'f'
+    auto run = [state, &f, count] {
+        for (size_t i; (i = state->next++) < count;) {
+            std::exception_ptr error;
+            try {
+                f(i);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (error && !state->error)
+                state->error = error;
+            if (++state->done == count)
+                state->finished.notify_all();
+        }
+    };
+    for (size_t i = 1; i < count; ++i)
+        enqueue(run);
+    run();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&]{ return state->done == count; });
+    if (state->error)
+        std::rethrow_exception(state->error);
 }
 
 // add new work item to the pool
@@ -82,12 +270,47 @@ auto ThreadPool::enqueue(F&& f, Args&&... args)
         // don't allow enqueueing after stopping the pool
         if(stop)
             return {};
-        tasks.emplace([task](){ (*task)(); });
+        tasks.push({[task](){ (*task)(); }, clock::now()});
+        if (needWorker())
+            spawn();
     }
     condition.notify_one();
     return res;
 }
 
+inline void ThreadPool::setBounds(size_t min, size_t max)
+{
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        min_threads = min;
+        max_threads = std::max(min, max);
+        while (!stop && workers.size() < min_threads)
+            spawn();
+    }
+    // wake up workers so extra ones can retire
+    condition.notify_all();
+}
+
+inline size_t ThreadPool::size()
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    return workers.size();
+}
+
+inline void ThreadPool::blockingBegin()
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    ++blocked;
+    if (needWorker())
+        spawn();
+}
+
+inline void ThreadPool::blockingEnd()
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    --blocked;
+}
+
 // the destructor joins all threads
 inline ThreadPool::~ThreadPool()
 {
@@ -96,7 +319,12 @@ inline ThreadPool::~ThreadPool()
         stop = true;
     }
     condition.notify_all();
-    for(std::thread &worker: workers)
+    control_condition.notify_all();
+    controller.join();
+    // workers do not retire after 'stop' is set, so the map does not change anymore
+    for(auto &worker: workers)
+        worker.second.join();
+    for(std::thread &worker: retired)
         worker.join();
 }
 
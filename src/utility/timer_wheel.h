@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace telegram::utility {
+/**
+ * @brief Hierarchical timing wheel
+ *
+ * Timers are kept in 'Levels' wheels of 64 slots, slot of level N covers 64^N ticks. \n
+ * Scheduling is O(1), every timer is moved to a lower level at most 'Levels' times \n
+ * before it expires. Timers are not cancelled explicitly: every timer carries a \n
+ * generation number and the owner ignores expired timers with outdated generation. \n
+ * Timers longer than 64^Levels ticks are rescheduled when they reach the top level slot. \n
+ * \warning class is not thread-safe
+ */
+template <class Key, std::size_t Levels = 4>
+class TimerWheel {
+    static_assert(Levels > 0 && Levels <= 8, "TimerWheel supports from 1 to 8 levels");
+    using clock = std::chrono::steady_clock;
+
+    static constexpr uint64_t slot_bits = 6;
+    static constexpr uint64_t slot_count = uint64_t{1} << slot_bits;
+    static constexpr uint64_t slot_mask = slot_count - 1;
+
+    struct Timer {
+        Key key;
+        uint32_t generation;
+        uint64_t deadline;
+    };
+    std::array<std::array<std::vector<Timer>, slot_count>, Levels> wheels;
+    std::chrono::milliseconds resolution;
+    clock::time_point start;
+    uint64_t current_tick = 0;
+    std::size_t m_size = 0;
+
+    void insert(Timer &&timer) {
+        if (timer.deadline < current_tick)
+            timer.deadline = current_tick;
+        // place timer on the lowest level where deadline is in the same block as current tick,
+        // so its slot is reached during current rotation of that level
+        for (std::size_t level = 0; level + 1 < Levels; ++level) {
+            const uint64_t block_shift = slot_bits * (level + 1);
+            if ((timer.deadline >> block_shift) == (current_tick >> block_shift)) {
+                const uint64_t slot = (timer.deadline >> (slot_bits * level)) & slot_mask;
+                wheels[level][slot].push_back(std::move(timer));
+                return;
+            }
+        }
+        // top level: clamp deadline to one rotation, timer is rescheduled on cascade
+        const uint64_t shift = slot_bits * (Levels - 1);
+        uint64_t distance = (timer.deadline >> shift) - (current_tick >> shift);
+        if (distance >= slot_count)
+            distance = slot_count - 1;
+        wheels[Levels - 1][((current_tick >> shift) + distance) & slot_mask].push_back(
+            std::move(timer));
+    }
+
+    template <class F>
+    void tick(F &on_expired) {
+        ++current_tick;
+        // move timers of higher levels whose block has just started to lower levels
+        for (std::size_t level = Levels - 1; level > 0; --level) {
+            const uint64_t shift = slot_bits * level;
+            if (current_tick & ((uint64_t{1} << shift) - 1))
+                continue;
+            auto slot = std::move(wheels[level][(current_tick >> shift) & slot_mask]);
+            wheels[level][(current_tick >> shift) & slot_mask].clear();
+            for (auto &timer : slot)
+                insert(std::move(timer));
+        }
+        auto expired = std::move(wheels[0][current_tick & slot_mask]);
+        wheels[0][current_tick & slot_mask].clear();
+        m_size -= expired.size();
+        for (auto &timer : expired)
+            on_expired(timer.key, timer.generation);
+    }
+
+public:
+    explicit TimerWheel(std::chrono::milliseconds resolution = std::chrono::seconds(1))
+        : resolution{resolution}, start{clock::now()} {
+    }
+    /**
+     * Schedule timer
+     * @param key - key that will be passed to callback
+     * @param generation - number that will be passed to callback to detect outdated timers
+     * @param delay - time after that timer expires (rounded up to resolution)
+     */
+    void schedule(const Key &key, uint32_t generation, std::chrono::milliseconds delay) {
+        const auto ticks = static_cast<uint64_t>((delay + resolution - std::chrono::milliseconds(1)) / resolution);
+        insert(Timer{key, generation, current_tick + std::max<uint64_t>(ticks, 1)});
+        ++m_size;
+    }
+    /**
+     * Advance wheel to 'now' and call 'on_expired(key, generation)' for every expired timer
+     */
+    template <class F>
+    void advance(clock::time_point now, F &&on_expired) {
+        const auto target = static_cast<uint64_t>((now - start) / resolution);
+        if (!m_size && target > current_tick) {
+            current_tick = target;
+            return;
+        }
+        while (current_tick < target)
+            tick(on_expired);
+    }
+    /// number of scheduled timers (including outdated ones)
+    std::size_t size() const noexcept {
+        return m_size;
+    }
+    /// wheel resolution
+    std::chrono::milliseconds getResolution() const noexcept {
+        return resolution;
+    }
+};
+} // namespace telegram::utility
@@ -149,6 +149,22 @@ struct checked_callback<std::function<R(T)>> {
                                              using checker = std::function<bool(T)>;
                                              using callback = std::function<R(T)>;
 };
+/// index of type T in std::variant V
+template <class T, class V>
+struct variant_index;
+
+template <class T, class... Ts>
+struct variant_index<T, std::variant<T, Ts...>> : std::integral_constant<std::size_t, 0> {};
+
+template <class T, class U, class... Ts>
+struct variant_index<T, std::variant<U, Ts...>>
+    : std::integral_constant<std::size_t, 1 + variant_index<T, std::variant<Ts...>>::value> {};
+
+template <class T, class V>
+constexpr inline std::size_t variant_index_v = variant_index<T, V>::value;
+
+static_assert (variant_index_v<double, std::variant<int,double>> == 1);
+
 /// decompose function into args and returning type
 template <typename Func,typename... Args>
 struct func_signature;
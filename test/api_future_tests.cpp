@@ -0,0 +1,86 @@
+#include <thread>
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+using namespace telegram;
+
+TEST(ApiFuture, get_and_then) {
+    ApiPromise<int> promise;
+    auto future = promise.getFuture();
+    std::thread producer([promise] { promise.setValue(42); });
+    ASSERT_EQ(future.get(), 42);
+    ASSERT_FALSE(future.valid());
+    producer.join();
+
+    ApiPromise<std::string> ready;
+    ready.setValue("ready");
+    std::string received;
+    ready.getFuture().then([&](std::string &&value) { received = std::move(value); });
+    ASSERT_EQ(received, "ready");
+}
+
+TEST(ApiFuture, when_all) {
+    ApiPromise<int> first;
+    ApiPromise<std::string> second;
+    auto both = when_all(first.getFuture(), second.getFuture());
+    ASSERT_FALSE(both.ready());
+    std::thread producer([&] {
+        second.setValue("second");
+        first.setValue(1);
+    });
+    auto [number, text] = both.get();
+    producer.join();
+    ASSERT_EQ(number, 1);
+    ASSERT_EQ(text, "second");
+
+    std::vector<ApiPromise<int>> promises(16);
+    std::vector<ApiFuture<int>> futures;
+    for (auto &promise : promises)
+        futures.push_back(promise.getFuture());
+    auto all = when_all(std::move(futures));
+    std::vector<std::thread> producers;
+    for (int i = 0; i < 16; ++i)
+        producers.emplace_back([&, i] { promises[i].setValue(i); });
+    auto values = all.get();
+    for (auto &producer : producers)
+        producer.join();
+    ASSERT_EQ(values.size(), 16u);
+    for (int i = 0; i < 16; ++i)
+        ASSERT_EQ(values[i], i);
+}
+
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+namespace {
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+Detached sum(ApiFuture<int> first, ApiFuture<int> second, ApiPromise<int> result) {
+    int a = co_await std::move(first);
+    int b = co_await std::move(second);
+    result.setValue(a + b);
+}
+} // namespace
+
+TEST(ApiFuture, co_await) {
+    ApiPromise<int> first, second, result;
+    auto total = result.getFuture();
+    first.setValue(1);
+    sum(first.getFuture(), second.getFuture(), result);
+    ASSERT_FALSE(total.ready());
+    std::thread producer([second] { second.setValue(2); });
+    ASSERT_EQ(total.get(), 3);
+    producer.join();
+}
+#endif
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -59,6 +59,32 @@ TEST(ApiManager, post_conditional) {
         result);
   }
 }
+TEST(ApiManager, set_server) {
+  ApiManager manager(api_url.data());
+  ApiServer server;
+  server.url = "http://localhost:8081/";
+  ASSERT_TRUE(manager.setServer(server));
+  ASSERT_EQ(manager.fileUrl(),
+            std::string("http://localhost:8081/file/bot") + bot_token.data() + '/');
+  // a server that is not valid changes nothing
+  server.url = "ftp://localhost";
+  ASSERT_FALSE(manager.setServer(server));
+  ASSERT_EQ(manager.fileUrl(),
+            std::string("http://localhost:8081/file/bot") + bot_token.data() + '/');
+#ifdef __linux__
+  // files can not be uploaded over unix socket, the call fails without retries
+  server.url = "http://localhost";
+  server.unix_socket = "/tmp/telegram-bot-api.sock";
+  ASSERT_TRUE(manager.setServer(server));
+  QueryBuilder builder;
+  builder << make_named_pair(chat_id);
+  std::vector<name_file_pair> params{{"photo", std::string(TEST_PATH) + "photo.jpg"}};
+  auto &&[result, error] = manager.ApiCall<Message>("sendPhoto", builder, params);
+  ASSERT_TRUE(error);
+  ASSERT_EQ(error->error_code, static_cast<int32_t>(ErrorCodes::NotValid));
+  ASSERT_EQ(manager.counters().retries, 0u);
+#endif
+}
 int main(int argc, char **argv) {
   static_assert(!bot_token.empty(), "Bot token is empty");
   ::testing::InitGoogleTest(&argc, argv);
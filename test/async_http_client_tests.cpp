@@ -0,0 +1,217 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+#include "utility/http_response_parser.h"
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+using namespace telegram;
+using namespace std::chrono_literals;
+
+namespace {
+std::shared_ptr<httplib::Response> parse(const std::vector<std::string> &pieces,
+                                         bool closed = false) {
+    utility::HttpResponseParser parser(std::make_shared<httplib::Response>());
+    for (const auto &piece : pieces)
+        if (!parser.feed(piece.data(), piece.size()))
+            return nullptr;
+    if (closed ? !parser.finishOnClose() : !parser.done())
+        return nullptr;
+    return parser.response;
+}
+
+#ifdef __linux__
+/// HTTP server on 127.0.0.1 that passes every accepted socket with its number to 'handle'
+class TestServer {
+    int listener = -1;
+    uint16_t port = 0;
+    std::atomic<int> accepted{0};
+    std::thread thread;
+
+public:
+    explicit TestServer(std::function<void(int, int)> handle) {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t size = sizeof(address);
+        ::bind(listener, reinterpret_cast<sockaddr *>(&address), size);
+        ::listen(listener, 16);
+        ::getsockname(listener, reinterpret_cast<sockaddr *>(&address), &size);
+        port = ntohs(address.sin_port);
+        thread = std::thread([this, handle = std::move(handle)] {
+            for (;;) {
+                const int fd = ::accept(listener, nullptr, nullptr);
+                if (fd < 0)
+                    return;
+                handle(fd, accepted++);
+                ::close(fd);
+            }
+        });
+    }
+    ~TestServer() {
+        ::shutdown(listener, SHUT_RDWR);
+        ::close(listener);
+        thread.join();
+    }
+    std::string url(const std::string &path) const {
+        return "http://127.0.0.1:" + std::to_string(port) + path;
+    }
+    int connections() const {
+        return accepted;
+    }
+};
+
+/// read head and body of the next request, returns its target or empty string if closed
+std::string readRequest(int fd) {
+    std::string data;
+    char buffer[4096];
+    std::size_t head_end;
+    while ((head_end = data.find("\r\n\r\n")) == std::string::npos) {
+        const auto size = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (size <= 0)
+            return {};
+        data.append(buffer, static_cast<std::size_t>(size));
+    }
+    const auto length = data.find("Content-Length: ");
+    const std::size_t body = std::stoul(data.substr(length + 16));
+    while (data.size() < head_end + 4 + body) {
+        const auto size = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (size <= 0)
+            return {};
+        data.append(buffer, static_cast<std::size_t>(size));
+    }
+    const auto target = data.find(' ') + 1;
+    return data.substr(target, data.find(' ', target) - target);
+}
+
+/// reply with the target of the request as body
+void reply(int fd, const std::string &target) {
+    const std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " +
+                                 std::to_string(target.size()) + "\r\n\r\n" + target;
+    ::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+}
+#endif
+} // namespace
+
+TEST(HttpResponseParser, content_length) {
+    auto response = parse({"HTTP/1.1 200 OK\r\nContent-", "Length: 5\r\nX-Id: 1\r\n\r", "\nhel", "lo"});
+    ASSERT_TRUE(response);
+    EXPECT_EQ(response->status, 200);
+    EXPECT_EQ(response->body, "hello");
+    EXPECT_EQ(response->get_header_value("X-Id"), "1");
+}
+
+TEST(HttpResponseParser, chunked) {
+    auto response = parse({"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n",
+                           "3\r\nabc\r\n", "4\r\nde", "fg\r\n0\r\n", "\r\n"});
+    ASSERT_TRUE(response);
+    EXPECT_EQ(response->body, "abcdefg");
+}
+
+TEST(HttpResponseParser, until_close) {
+    ASSERT_FALSE(parse({"HTTP/1.0 200 OK\r\n\r\npart"}));
+    auto response = parse({"HTTP/1.0 200 OK\r\n\r\npart", "ial"}, true);
+    ASSERT_TRUE(response);
+    EXPECT_EQ(response->body, "partial");
+}
+
+TEST(HttpResponseParser, malformed) {
+    EXPECT_FALSE(parse({"SMTP 220\r\n\r\n"}));
+    EXPECT_FALSE(parse({"HTTP/1.1 200 OK\r\nContent-Length: many\r\n\r\n"}));
+    EXPECT_FALSE(parse({"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n"}));
+}
+
+#ifdef __linux__
+TEST(AsyncHttpClient, queued_on_one_connection) {
+    TestServer server([](int fd, int) {
+        for (std::string target; !(target = readRequest(fd)).empty();)
+            reply(fd, target);
+    });
+    AsyncHttpClient client;
+    client.setMaxConnectionsPerHost(1);
+    std::vector<std::future<std::shared_ptr<httplib::Response>>> responses;
+    for (int i = 0; i < 5; ++i)
+        responses.push_back(client.post(server.url("/" + std::to_string(i)), {}, "{}",
+                                        "application/json"));
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(responses[i].wait_for(10s), std::future_status::ready);
+        auto response = responses[i].get();
+        ASSERT_TRUE(response);
+        EXPECT_EQ(response->body, "/" + std::to_string(i));
+    }
+    // queued requests wait for the connection instead of opening new ones
+    EXPECT_EQ(server.connections(), 1);
+}
+
+TEST(AsyncHttpClient, retried_on_closed_connection) {
+    TestServer server([](int fd, int index) {
+        if (index == 0) {
+            reply(fd, readRequest(fd));
+            // the kept alive connection is closed before the next response
+            readRequest(fd);
+            return;
+        }
+        reply(fd, readRequest(fd));
+    });
+    AsyncHttpClient client;
+    auto first = client.post(server.url("/first"), {}, "{}", "application/json");
+    ASSERT_EQ(first.wait_for(10s), std::future_status::ready);
+    ASSERT_TRUE(first.get());
+    auto second = client.post(server.url("/second"), {}, "{}", "application/json");
+    ASSERT_EQ(second.wait_for(10s), std::future_status::ready);
+    auto response = second.get();
+    ASSERT_TRUE(response);
+    EXPECT_EQ(response->body, "/second");
+    EXPECT_EQ(server.connections(), 2);
+}
+
+TEST(AsyncHttpClient, connection_limits) {
+    TestServer server([](int fd, int) {
+        for (std::string target; !(target = readRequest(fd)).empty();)
+            reply(fd, target);
+    });
+    AsyncHttpClient client;
+    client.setMaxRequestsPerConnection(2);
+    auto call = [&](const std::string &path) {
+        auto response = client.post(server.url(path), {}, "{}", "application/json");
+        ASSERT_EQ(response.wait_for(10s), std::future_status::ready);
+        ASSERT_TRUE(response.get());
+    };
+    for (int i = 0; i < 3; ++i)
+        call("/" + std::to_string(i));
+    // connection is reopened after serving two requests
+    EXPECT_EQ(server.connections(), 2);
+
+    client.setIdleTimeout(0s);
+    // the second connection served one request, it is closed by the loop while idle
+    std::this_thread::sleep_for(500ms);
+    call("/idle");
+    EXPECT_EQ(server.connections(), 3);
+}
+
+TEST(AsyncHttpClient, unreachable_host) {
+    AsyncHttpClient client;
+    // nothing listens on the port
+    auto refused = client.post("http://127.0.0.1:1/", {}, "{}", "application/json");
+    ASSERT_EQ(refused.wait_for(10s), std::future_status::ready);
+    EXPECT_FALSE(refused.get());
+    auto unresolved = client.post("http://host.invalid/", {}, "{}", "application/json");
+    ASSERT_EQ(unresolved.wait_for(30s), std::future_status::ready);
+    EXPECT_FALSE(unresolved.get());
+}
+#endif
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -24,6 +24,14 @@ TEST(BotTests, sendPhoto) {
   ASSERT_TRUE(result.chat.id);
   ASSERT_TRUE(result.message_id);
 }
+TEST(BotTests, sendPhotoFromMemory) {
+  std::ifstream file(std::string(TEST_PATH) + "photo.jpg", std::ios::binary);
+  std::string bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  auto &&[result, error] = bot.sendPhoto(
+      chat_id, FileSource::fromMemory(std::move(bytes), "photo.jpg"), "'sendPhoto' from memory test");
+  ASSERT_FALSE(error);
+  ASSERT_TRUE(result.message_id);
+}
 TEST(BotTests, sendVideo) {
   auto &&[result, error] =
       bot.sendVideo(chat_id, std::string(TEST_PATH) + "video.mp4");
@@ -46,6 +54,40 @@ TEST(BotTests, sendDocument) {
   ASSERT_TRUE(result.chat.id);
   ASSERT_TRUE(result.message_id);
 }
+TEST(BotTests, downloadFile) {
+  const std::string path = std::string(TEST_PATH) + "document.gif";
+  auto &&[result, error] = bot.sendDocument(chat_id, FileSource::fromPath(path));
+  ASSERT_FALSE(error);
+  ASSERT_TRUE(result.document);
+  const auto destination = fs::temp_directory_path() / "download_test.gif";
+  ASSERT_FALSE(bot.downloadFile(result.document->file_id, destination.string()));
+  ASSERT_EQ(fs::file_size(destination), fs::file_size(path));
+  // the second request is served from the cache
+  std::size_t received = 0;
+  ASSERT_FALSE(bot.downloadFile(result.document->file_id, [&](const char *, std::size_t size) {
+    received += size;
+    return true;
+  }));
+  ASSERT_EQ(received, fs::file_size(path));
+  auto &&[mapped, map_error] = bot.openFile(result.document->file_id);
+  ASSERT_FALSE(map_error);
+  ASSERT_EQ(mapped.size(), fs::file_size(path));
+  fs::remove(destination);
+}
+TEST(BotTests, sendMediaGroup) {
+  InputMediaPhoto photo;
+  photo.media = std::string(TEST_PATH) + "photo.jpg";
+  photo.caption = "'sendMediaGroup' test";
+  InputMediaVideo video;
+  video.media = std::string(TEST_PATH) + "video.mp4";
+  // the thumbnail is uploaded with the video
+  video.thumb = std::string(TEST_PATH) + "photo.jpg";
+  auto &&[result, error] = bot.sendMediaGroup(chat_id, {photo, video});
+  ASSERT_FALSE(error);
+  ASSERT_EQ(result.size(), 2u);
+  ASSERT_TRUE(result[0].photo);
+  ASSERT_TRUE(result[1].video);
+}
 TEST(BotTests, sendAnimation) {
   auto &&[result, error] =
       bot.sendAnimation(chat_id, std::string(TEST_PATH) + "document.gif");
@@ -83,6 +125,31 @@ TEST(BotTests, sendLocation) {
   ASSERT_TRUE(result.message_id);
 }
 
+TEST(BotTests, prepare) {
+  InlineKeyboardButton button;
+  button.text = "button";
+  button.callback_data = "data";
+  InlineKeyboardMarkup reply_markup;
+  reply_markup.inline_keyboard = {{button}};
+  auto send = bot.prepare<Message>("sendMessage", make_named_pair(reply_markup));
+  std::string text = "'prepare' test";
+  auto &&[result, error] = send(make_named_pair(chat_id), make_named_pair(text));
+  ASSERT_FALSE(error);
+  ASSERT_TRUE(result.reply_markup);
+  auto &&[second, second_error] = send.async(make_named_pair(chat_id), make_named_pair(text)).get();
+  ASSERT_FALSE(second_error);
+  ASSERT_TRUE(second.message_id);
+}
+
+TEST(BotTests, sendMessageAsync) {
+  auto &&[first, second] = when_all(bot.sendMessageAsync(chat_id, "first"),
+                                    bot.sendMessageAsync(chat_id, "second")).get();
+  ASSERT_FALSE(first.second);
+  ASSERT_FALSE(second.second);
+  ASSERT_TRUE(first.first.message_id);
+  ASSERT_TRUE(second.first.message_id);
+}
+
 int main(int argc, char **argv) {
   static_assert(!bot_token.empty(), "Bot token is empty");
   static_assert(chat_id != 0, "Chat for testing not set");
@@ -0,0 +1,76 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+using namespace telegram;
+
+TEST(ShardedMap, basic) {
+    utility::ShardedMap<int64_t, std::string, 4> map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.insert_or_assign(1, "first"));
+    ASSERT_FALSE(map.insert_or_assign(1, "replaced"));
+    ASSERT_TRUE(map.insert_or_assign(2, "second"));
+    ASSERT_EQ(map.size(), 2u);
+    ASSERT_EQ(map.find(1), "replaced");
+    ASSERT_FALSE(map.find(3));
+
+    ASSERT_TRUE(map.visit(2, [](std::string &value) { value += "!"; }));
+    ASSERT_FALSE(map.visit(3, [](std::string &) { FAIL(); }));
+    std::string seen;
+    ASSERT_TRUE(map.cvisit(2, [&](const std::string &value) { seen = value; }));
+    ASSERT_EQ(seen, "second!");
+    ASSERT_FALSE(map.exchange(3, "third"));
+    ASSERT_EQ(map.exchange(3, "third!"), "third");
+    ASSERT_TRUE(map.erase(3));
+
+    // value is erased only if it was not replaced
+    ASSERT_FALSE(map.erase_if(1, [](const std::string &value) { return value == "first"; }));
+    ASSERT_TRUE(map.erase_if(1, [](const std::string &value) { return value == "replaced"; }));
+    ASSERT_EQ(map.extract_if(2, [](const std::string &) { return true; }), "second!");
+    ASSERT_FALSE(map.erase(2));
+    ASSERT_TRUE(map.empty());
+}
+
+TEST(ShardedMap, for_each) {
+    utility::ShardedMap<int64_t, int64_t, 8> map;
+    for (int64_t i = 0; i < 100; ++i)
+        map.insert_or_assign(i, i * 2);
+    int64_t keys = 0, values = 0;
+    map.for_each([&](int64_t key, int64_t value) {
+        keys += key;
+        values += value;
+    });
+    ASSERT_EQ(keys, 4950);
+    ASSERT_EQ(values, 9900);
+}
+
+TEST(ShardedMap, concurrent) {
+    utility::ShardedMap<int64_t, int64_t> map;
+    constexpr int64_t keys = 1000;
+    constexpr int threads = 8;
+    for (int64_t i = 0; i < keys; ++i)
+        map.insert_or_assign(i, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int64_t i = 0; i < keys; ++i) {
+                map.visit(i, [](int64_t &value) { ++value; });
+                // keys of this thread are inserted and erased concurrently with others
+                const int64_t own = keys + t * keys + i;
+                map.insert_or_assign(own, i);
+                ASSERT_EQ(map.find(own), i);
+                ASSERT_TRUE(map.erase(own));
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    ASSERT_EQ(map.size(), static_cast<std::size_t>(keys));
+    map.for_each([&](int64_t, int64_t value) { ASSERT_EQ(value, threads); });
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,124 @@
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+using namespace telegram;
+
+namespace {
+/// write a complete file into the cache as the downloader does
+DownloadCache::Lease store(DownloadCache &cache, const std::string &key, const std::string &content) {
+    std::ofstream(cache.partial(key), std::ios::binary) << content;
+    return cache.commit(key);
+}
+} // namespace
+
+TEST(DownloadCache, find_and_evict) {
+    const auto directory = fs::temp_directory_path() / "download_cache_test";
+    fs::remove_all(directory);
+    DownloadCache cache(directory, 10);
+    ASSERT_FALSE(cache.find("first"));
+    ASSERT_TRUE(store(cache, "first", "123456"));
+    ASSERT_EQ(cache.size(), 6u);
+    // files in use are not evicted
+    auto first = cache.find("first");
+    ASSERT_TRUE(first);
+    auto second = store(cache, "second", "123456");
+    ASSERT_TRUE(second);
+    ASSERT_TRUE(fs::exists(*first));
+    ASSERT_EQ(cache.size(), 12u);
+    // the least recently used file is evicted when it is released
+    first.reset();
+    ASSERT_FALSE(cache.find("first"));
+    second.reset();
+    ASSERT_TRUE(cache.find("second"));
+    ASSERT_EQ(cache.size(), 6u);
+
+    // files are found after restart
+    DownloadCache restarted(directory, 10);
+    ASSERT_TRUE(restarted.find("second"));
+    ASSERT_EQ(restarted.size(), 6u);
+    fs::remove_all(directory);
+}
+
+TEST(DownloadCache, partial) {
+    const auto directory = fs::temp_directory_path() / "download_cache_test";
+    fs::remove_all(directory);
+    DownloadCache cache(directory);
+    // incomplete file is kept for resume, but it is not found
+    std::ofstream(cache.partial("file"), std::ios::binary) << "half";
+    ASSERT_FALSE(cache.find("file"));
+    std::ofstream(cache.partial("file"), std::ios::binary | std::ios::app) << "full";
+    auto file = cache.commit("file");
+    ASSERT_TRUE(file);
+    ASSERT_FALSE(fs::exists(cache.partial("file")));
+    ASSERT_EQ(fs::file_size(*file), 8u);
+    // keys can not escape the directory
+    ASSERT_EQ(cache.partial("../file").parent_path(), directory);
+    fs::remove_all(directory);
+}
+
+TEST(DownloadCache, mapped_file) {
+    const auto directory = fs::temp_directory_path() / "download_cache_test";
+    fs::remove_all(directory);
+    DownloadCache cache(directory, 0);
+    MappedFile mapped(store(cache, "file", "content"));
+    ASSERT_TRUE(mapped.valid());
+    ASSERT_EQ(mapped.view(), "content");
+    // the mapped file is kept until it is unmapped
+    MappedFile moved(std::move(mapped));
+    ASSERT_FALSE(mapped.valid());
+    ASSERT_EQ(moved.view(), "content");
+    const auto path = moved.path();
+    moved = MappedFile{};
+    ASSERT_FALSE(fs::exists(path));
+    fs::remove_all(directory);
+}
+
+#ifndef _WIN32
+TEST(DownloadCache, default_directory) {
+    const auto temporary = fs::temp_directory_path() / "download_cache_tmp";
+    fs::remove_all(temporary);
+    fs::create_directories(temporary);
+    setenv("TMPDIR", temporary.c_str(), 1);
+    {
+        DownloadCache cache;
+        ASSERT_TRUE(store(cache, "file", "content"));
+    }
+    // the default directory is accessible by the user only
+    fs::path directory = *fs::directory_iterator(temporary);
+    ASSERT_EQ(fs::status(directory).permissions() & fs::perms::all, fs::perms::owner_all);
+    // a directory others can access is not used
+    fs::permissions(directory, fs::perms::all);
+    DownloadCache shared;
+    ASSERT_TRUE(shared.partial("file").empty());
+    ASSERT_FALSE(shared.find("file"));
+    unsetenv("TMPDIR");
+    fs::remove_all(temporary);
+}
+#endif
+
+TEST(DownloadCache, local_server) {
+    const auto directory = fs::temp_directory_path() / "download_cache_test";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    const auto path = directory / "local.txt";
+    std::ofstream(path, std::ios::binary) << "content";
+    FileDownloader downloader("https://api.telegram.org/file/bot/");
+    ApiServer server;
+    server.url = "ftp://localhost";
+    ASSERT_FALSE(downloader.setServer(server, "ftp://localhost/file/bot/"));
+    server.url = "http://localhost:8081";
+    server.local = true;
+    ASSERT_TRUE(downloader.setServer(server, "http://localhost:8081/file/bot/"));
+    // files of the local server are read in place
+    auto result = downloader.fetch("local", path.string(), 7);
+    ASSERT_TRUE(result.file);
+    ASSERT_EQ(*result.file, path);
+    ASSERT_EQ(downloader.cache().size(), 0u);
+    ASSERT_FALSE(downloader.fetch("missing", (directory / "missing").string(), {}).file);
+    fs::remove_all(directory);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+using namespace telegram;
+
+namespace {
+fs::path writeFile(const std::string &name, const std::string &content) {
+    auto path = fs::temp_directory_path() / name;
+    std::ofstream(path, std::ios::binary) << content;
+    return path;
+}
+} // namespace
+
+TEST(FileIdCache, find_and_evict) {
+    auto first = writeFile("file_id_cache_1.bin", "first");
+    auto second = writeFile("file_id_cache_2.bin", "second");
+    FileIdCache cache(1);
+    cache.insert(first, "id1");
+    ASSERT_EQ(cache.find(first), "id1");
+    ASSERT_FALSE(cache.find("file_id_cache_missing.bin"));
+    // the least recently used file is evicted
+    cache.insert(second, "id2");
+    ASSERT_FALSE(cache.find(first));
+    ASSERT_EQ(cache.find(second), "id2");
+    // a modified file is uploaded again
+    writeFile("file_id_cache_2.bin", "modified");
+    ASSERT_FALSE(cache.find(second));
+    fs::remove(first);
+    fs::remove(second);
+}
+
+TEST(FileIdCache, index) {
+    auto file = writeFile("file_id_cache_3.bin", "content");
+    auto other = writeFile("file_id_cache_4.bin", "other");
+    auto index = fs::temp_directory_path() / "file_id_cache_index";
+    fs::remove(index);
+    {
+        FileIdCache cache;
+        ASSERT_TRUE(cache.setIndex(index, "42"));
+        cache.insert(file, "id3");
+        cache.insert(other, "id4");
+        cache.erase(other);
+    }
+    {
+        FileIdCache cache;
+        ASSERT_TRUE(cache.setIndex(index, "42"));
+        ASSERT_EQ(cache.size(), 1u);
+        ASSERT_EQ(cache.find(file), "id3");
+        ASSERT_FALSE(cache.find(other));
+    }
+    {
+        // file_id of another bot can not be used
+        FileIdCache cache;
+        ASSERT_TRUE(cache.setIndex(index, "43"));
+        ASSERT_FALSE(cache.find(file));
+    }
+    fs::remove(index);
+    fs::remove(file);
+    fs::remove(other);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+using namespace telegram;
+
+namespace {
+std::string readAll(MultipartBody &body, std::size_t &max_piece) {
+    std::string result;
+    max_piece = 0;
+    while (result.size() < body.size()) {
+        auto written = body.read(result.size(), [&](const char *data, std::size_t size) {
+            result.append(data, size);
+        });
+        if (!written)
+            break;
+        max_piece = std::max(max_piece, written);
+    }
+    return result;
+}
+
+std::string fileContent(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+} // namespace
+
+TEST(MultipartBody, streams_files) {
+    const std::string path = std::string(TEST_PATH) + "video.mp4";
+    const auto content = fileContent(path);
+    MultipartBody body;
+    body.addField("chat_id", "42");
+    ASSERT_TRUE(body.addFile("video", path, "video.mp4"));
+    ASSERT_FALSE(body.addFile("audio", std::string(TEST_PATH) + "missing.mp3", "missing.mp3"));
+
+    const auto type = body.contentType();
+    const auto boundary = type.substr(type.find("boundary=") + 9);
+    const std::string expected =
+        "--" + boundary + "\r\nContent-Disposition: form-data; name=\"chat_id\"\r\n\r\n42\r\n" +
+        "--" + boundary + "\r\nContent-Disposition: form-data; name=\"video\"; " +
+        "filename=\"video.mp4\"\r\nContent-Type: application/octet-stream\r\n\r\n" + content +
+        "\r\n--" + boundary + "--\r\n";
+    ASSERT_EQ(body.size(), expected.size());
+
+    std::size_t max_piece = 0;
+    // the body can be written again, e.g when the request is redirected
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ(readAll(body, max_piece), expected);
+        ASSERT_LE(max_piece, MultipartBody::chunk_size);
+    }
+    ASSERT_FALSE(body.failed());
+    // pieces can be requested from any offset
+    const auto offset = expected.size() / 2;
+    body.read(offset, [&](const char *data, std::size_t size) {
+        ASSERT_EQ(std::string(data, size), expected.substr(offset, size));
+    });
+    ASSERT_EQ(body.read(body.size(), [](const char *, std::size_t) {}), 0u);
+}
+
+TEST(MultipartBody, truncated_file) {
+    const auto path = fs::temp_directory_path() / "multipart_body_test.bin";
+    std::ofstream(path, std::ios::binary) << std::string(1000, 'a');
+    MultipartBody body;
+    ASSERT_TRUE(body.addFile("document", path, "test.bin"));
+    fs::resize_file(path, 10);
+
+    std::size_t max_piece = 0;
+    // the body keeps its size, so the request is not broken
+    ASSERT_EQ(readAll(body, max_piece).size(), body.size());
+    ASSERT_TRUE(body.failed());
+    fs::remove(path);
+}
+
+TEST(MultipartBody, memory_parts) {
+    const std::string bytes(3 * MultipartBody::chunk_size, 'x');
+    MultipartBody body;
+    body.addMemory("photo", bytes.data(), bytes.size(), "chart.png");
+    std::size_t max_piece = 0;
+    const auto written = readAll(body, max_piece);
+    ASSERT_EQ(written.size(), body.size());
+    ASSERT_NE(written.find("filename=\"chart.png\"\r\nContent-Type: application/octet-stream\r\n\r\n" +
+                           bytes + "\r\n"),
+              std::string::npos);
+}
+
+TEST(FileSource, kinds) {
+    ASSERT_EQ(FileSource("AgADBAADr6cxG2s").kind(), FileSource::Kind::Remote);
+    ASSERT_EQ(FileSource("https://example.com/photo.jpg").kind(), FileSource::Kind::Remote);
+    ASSERT_EQ(FileSource(std::string(TEST_PATH) + "photo.jpg").kind(), FileSource::Kind::Path);
+    ASSERT_EQ(FileSource("photo.jpg").filename(), "photo.jpg");
+    ASSERT_EQ(FileSource::fromPath("photo").kind(), FileSource::Kind::Path);
+    auto memory = FileSource::fromMemory(std::string("bytes"), "chart.png");
+    ASSERT_EQ(memory.kind(), FileSource::Kind::Memory);
+    ASSERT_EQ(std::string(memory.data(), memory.size()), "bytes");
+    ASSERT_EQ(memory.filename(), "chart.png");
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
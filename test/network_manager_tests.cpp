@@ -0,0 +1,147 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+using namespace telegram;
+
+#ifdef __linux__
+namespace {
+/// HTTP server on 127.0.0.1 that replies with the received request as body
+class EchoServer {
+    int listener = -1;
+    uint16_t port = 0;
+    std::atomic<int> accepted{0};
+    std::thread thread;
+
+    /// reply to one request, returns false if the connection was closed
+    static bool echo(int fd) {
+        std::string data;
+        char buffer[4096];
+        std::size_t head_end;
+        while ((head_end = data.find("\r\n\r\n")) == std::string::npos) {
+            const auto size = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (size <= 0)
+                return false;
+            data.append(buffer, static_cast<std::size_t>(size));
+        }
+        const auto length = data.find("Content-Length: ");
+        const std::size_t body = length < head_end ? std::stoul(data.substr(length + 16)) : 0;
+        while (data.size() < head_end + 4 + body) {
+            const auto size = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (size <= 0)
+                return false;
+            data.append(buffer, static_cast<std::size_t>(size));
+        }
+        const auto response = "HTTP/1.1 200 OK\r\nContent-Length: " +
+                              std::to_string(data.size()) + "\r\n\r\n" + data;
+        ::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+        return true;
+    }
+
+public:
+    EchoServer() {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t size = sizeof(address);
+        ::bind(listener, reinterpret_cast<sockaddr *>(&address), size);
+        ::listen(listener, 16);
+        ::getsockname(listener, reinterpret_cast<sockaddr *>(&address), &size);
+        port = ntohs(address.sin_port);
+        thread = std::thread([this] {
+            for (;;) {
+                const int fd = ::accept(listener, nullptr, nullptr);
+                if (fd < 0)
+                    return;
+                ++accepted;
+                while (echo(fd)) {
+                }
+                ::close(fd);
+            }
+        });
+    }
+    ~EchoServer() {
+        ::shutdown(listener, SHUT_RDWR);
+        ::close(listener);
+        thread.join();
+    }
+    std::string url() const {
+        return "http://127.0.0.1:" + std::to_string(port);
+    }
+    int connections() const {
+        return accepted;
+    }
+};
+
+bool contains(const std::string &text, const std::string &part) {
+    return text.find(part) != std::string::npos;
+}
+} // namespace
+
+TEST(NetworkManager, thread_request) {
+    EchoServer server;
+    NetworkManager manager("localhost");
+    ApiServer api;
+    api.url = server.url();
+    ASSERT_TRUE(manager.setServer(api));
+    manager.setEventLoopBackend(false);
+
+    // the request of the thread is reused, every call still sends its own headers and body
+    auto plain = manager.post(server.url() + "/first", {}, R"({"a":1})");
+    ASSERT_TRUE(plain);
+    EXPECT_TRUE(contains(plain->body, "POST /first "));
+    EXPECT_TRUE(contains(plain->body, "Content-Type: application/json"));
+    EXPECT_TRUE(contains(plain->body, "\r\n\r\n{\"a\":1}"));
+
+    auto with_header = manager.post(server.url() + "/second", {{"X-Test", "1"}}, "text",
+                                    "text/plain");
+    ASSERT_TRUE(with_header);
+    EXPECT_TRUE(contains(with_header->body, "POST /second "));
+    EXPECT_TRUE(contains(with_header->body, "X-Test: 1"));
+    EXPECT_TRUE(contains(with_header->body, "Content-Type: text/plain"));
+    EXPECT_FALSE(contains(with_header->body, "application/json"));
+
+    // headers of the previous call are not kept
+    auto again = manager.post(server.url() + "/third", {}, "{}");
+    ASSERT_TRUE(again);
+    EXPECT_FALSE(contains(again->body, "X-Test"));
+    EXPECT_TRUE(contains(again->body, "Content-Type: application/json"));
+    EXPECT_TRUE(contains(again->body, "\r\n\r\n{}"));
+
+    // a large body is released after the call, the next one is complete
+    const std::string large(100 * 1024, 'x');
+    auto big = manager.post(server.url() + "/large", {}, large);
+    ASSERT_TRUE(big);
+    EXPECT_TRUE(contains(big->body, "\r\n\r\n" + large));
+    auto small = manager.post(server.url() + "/small", {}, "{}");
+    ASSERT_TRUE(small);
+    EXPECT_TRUE(contains(small->body, "Content-Length: 2\r\n"));
+}
+
+TEST(NetworkManager, keep_alive) {
+    EchoServer server;
+    NetworkManager manager("localhost");
+    ASSERT_TRUE(manager.usesEventLoop());
+    manager.setMaxRequestsPerConnection(3);
+    for (int i = 0; i < 4; ++i) {
+        auto reply = manager.post(server.url() + "/call", {}, "{}");
+        ASSERT_TRUE(reply);
+        EXPECT_TRUE(contains(reply->body, "POST /call "));
+    }
+    // calls are made over one connection until it served 3 requests
+    EXPECT_EQ(server.connections(), 2);
+}
+#endif
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
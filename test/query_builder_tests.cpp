@@ -55,6 +55,67 @@ TEST(QueryBuilder,builder_empty_document) {
     EXPECT_EQ(expected,json);
 
 }
+TEST(QueryBuilder,builder_buffer) {
+    QueryBuilder builder;
+    int64_t chat_id = 1;
+    // larger than memory inside the builder
+    std::string text(4096, 'a');
+    builder << make_named_pair(chat_id) << make_named_pair(text);
+    std::string expected = "{\"chat_id\":1,\"text\":\"" + text + "\"}";
+
+    std::string buffer = "previous query";
+    builder.getQuery(buffer);
+    EXPECT_EQ(expected,buffer);
+    const auto capacity = buffer.capacity();
+    builder.getQuery(buffer);
+    EXPECT_EQ(expected,buffer);
+    EXPECT_EQ(capacity,buffer.capacity());
+
+    // the document is copied out of memory of the moved builder
+    QueryBuilder moved(std::move(builder));
+    builder = QueryBuilder{};
+    EXPECT_EQ(expected,moved.getQuery());
+}
+TEST(QueryBuilder,builder_members) {
+    QueryBuilder constant;
+    std::string parse_mode = "HTML";
+    std::vector<int> vec{1,2};
+    constant << make_named_pair(parse_mode) << make_named_pair(vec);
+    const auto members = constant.getMembers();
+    EXPECT_EQ("\"parse_mode\":\"HTML\",\"vec\":[1,2]",members);
+
+    QueryBuilder builder;
+    int b = 5;
+    builder << make_named_pair(b);
+    std::string json;
+    builder.getQuery(json,members);
+    EXPECT_EQ("{\"b\":5,"+members+"}",json);
+    // nothing but prepared members
+    QueryBuilder{}.getQuery(json,members);
+    EXPECT_EQ("{"+members+"}",json);
+    EXPECT_EQ("",QueryBuilder{}.getMembers());
+}
+TEST(QueryBuilder,body_reuse) {
+    QueryBuilder builder;
+    // longer than a string without heap memory
+    std::string text(100,'x');
+    builder << make_named_pair(text);
+    const std::string json = builder.getQuery();
+    const char* memory = nullptr;
+    {
+        QueryBuilder::Body body(builder);
+        EXPECT_EQ(json,body.view());
+        memory = body.view().data();
+    }
+    // the next body of the thread takes the memory of the previous one
+    QueryBuilder::Body body(builder);
+    EXPECT_EQ(memory,body.view().data());
+    EXPECT_EQ(json,body.view());
+    // nested bodies take their own memory
+    QueryBuilder::Body nested(builder,"\"b\":2");
+    EXPECT_NE(body.view().data(),nested.view().data());
+    EXPECT_EQ(json.substr(0,json.size()-1)+",\"b\":2}",nested.view());
+}
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
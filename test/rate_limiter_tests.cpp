@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+using namespace telegram;
+using namespace std::chrono;
+
+TEST(RateLimiter, per_chat_rate) {
+    RateLimiter limiter(RateLimits{0, 20, 20, 1});
+    const auto begin = steady_clock::now();
+    for (int i = 0; i < 6; ++i)
+        limiter.acquire({"1", false});
+    // the first call passes immediately, the others wait for 1/20 s each
+    ASSERT_GE(steady_clock::now() - begin, milliseconds(240));
+}
+
+TEST(RateLimiter, round_robin) {
+    RateLimiter limiter(RateLimits{100, 0, 0, 1});
+    std::mutex mutex;
+    std::vector<std::string> order;
+    std::atomic<int> done{0};
+    // a busy chat uses the whole global burst and queues more calls,
+    // a quiet chat must not wait behind all of them
+    for (int i = 0; i < 150; ++i)
+        limiter.submit({"-100", true}, [&] {
+            std::unique_lock lock(mutex);
+            order.push_back("busy");
+            ++done;
+        });
+    limiter.submit({"2", false}, [&] {
+        std::unique_lock lock(mutex);
+        order.push_back("quiet");
+        ++done;
+    });
+    while (done < 151)
+        std::this_thread::sleep_for(milliseconds(10));
+    auto quiet = std::find(order.begin(), order.end(), "quiet") - order.begin();
+    ASSERT_LT(quiet, 105);
+}
+
+TEST(RateLimiter, delay_and_pause) {
+    RateLimiter limiter(RateLimits{0, 0, 0, 1});
+    auto begin = steady_clock::now();
+    limiter.acquire({"1", false}, milliseconds(100));
+    ASSERT_GE(steady_clock::now() - begin, milliseconds(100));
+
+    limiter.pause({"1", false}, milliseconds(200));
+    begin = steady_clock::now();
+    limiter.acquire({"2", false});
+    // other chats are not paused
+    ASSERT_LT(steady_clock::now() - begin, milliseconds(100));
+    limiter.acquire({"1", false});
+    ASSERT_GE(steady_clock::now() - begin, milliseconds(190));
+}
+
+TEST(RateLimiter, global_only) {
+    RateLimiter limiter(RateLimits{0, 1, 1, 1});
+    const auto begin = steady_clock::now();
+    // calls without a chat are not limited by the rate of one chat
+    for (int i = 0; i < 10; ++i)
+        limiter.acquire({});
+    ASSERT_LT(steady_clock::now() - begin, milliseconds(500));
+}
+
+TEST(RateLimiter, submit_after_stop) {
+    RateLimiter limiter(RateLimits{0, 1, 1, 1});
+    limiter.stop();
+    bool run = false;
+    limiter.submit({"1", false}, [&] { run = true; });
+    ASSERT_TRUE(run);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+using namespace telegram;
+using namespace std::chrono;
+
+TEST(RetryController, retry_after) {
+    RateLimiter limiter(RateLimits{0, 0, 0, 1});
+    RetryController retries(limiter);
+    auto delay = retries.onResult("sendMessage", {"1", false}, 429, 2, 1);
+    ASSERT_TRUE(delay);
+    ASSERT_GE(*delay, seconds(2));
+    ASSERT_LE(*delay, milliseconds(2200));
+    // waits longer than allowed are not retried
+    ASSERT_FALSE(retries.onResult("sendMessage", {"1", false}, 429, 3600, 1));
+    // it is unknown if a non-idempotent call took effect
+    ASSERT_FALSE(retries.onResult("sendMessage", {"1", false}, 502, {}, 1));
+    ASSERT_TRUE(retries.onResult("getChat", {"1", false}, 502, {}, 1));
+    ASSERT_FALSE(retries.onResult("getChat", {"1", false}, 502, {}, 4));
+    ASSERT_FALSE(retries.onResult("getChat", {"1", false}, 400, {}, 1));
+    auto counters = retries.counters();
+    ASSERT_EQ(counters.rate_limited, 2u);
+    ASSERT_EQ(counters.failures, 3u);
+    ASSERT_EQ(counters.retries, 2u);
+}
+
+TEST(RetryController, circuit_breaker) {
+    RateLimiter limiter(RateLimits{0, 0, 0, 1});
+    RetryPolicy policy;
+    policy.breaker_threshold = 3;
+    policy.breaker_pause = seconds(1);
+    RetryController retries(limiter, policy);
+    for (int i = 0; i < 3; ++i)
+        retries.onResult("getMe", {}, 503, {}, 1);
+    ASSERT_EQ(retries.counters().breaker_trips, 1u);
+    // calls that were in flight when the breaker tripped are not counted
+    retries.onResult("getMe", {}, 503, {}, 1);
+    ASSERT_EQ(retries.counters().breaker_trips, 1u);
+    auto begin = steady_clock::now();
+    limiter.acquire({"1", false});
+    ASSERT_GE(steady_clock::now() - begin, milliseconds(900));
+    // the first failure after the pause trips the breaker again
+    retries.onResult("getMe", {}, 503, {}, 1);
+    ASSERT_EQ(retries.counters().breaker_trips, 2u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
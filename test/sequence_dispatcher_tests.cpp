@@ -2,6 +2,67 @@
 #include "telegram_bot.h"
 using namespace telegram;
 
+TEST(Sequence, shared_between_users) {
+    int calls = 0;
+    auto seq = std::make_shared<Sequence<MessageCallback>>();
+    seq->addTransition([&](const Message&){ ++calls; })
+       ->addCheck([](const Message& m){ return m.text.has_value(); })
+       ->addTransition([&](const Message&){ ++calls; });
+
+    Message with_text;
+    with_text.text = "text";
+    std::size_t first_user = 0, second_user = 0;
+    first_user = seq->input(first_user, Message{});
+    EXPECT_EQ(first_user, 0u);
+    first_user = seq->input(first_user, with_text);
+    second_user = seq->input(second_user, with_text);
+    first_user = seq->input(first_user, with_text);
+
+    EXPECT_TRUE(seq->finished(first_user));
+    EXPECT_EQ(second_user, 1u);
+    EXPECT_EQ(seq->getStep(), 0u);
+    EXPECT_EQ(calls, 3);
+}
+
+TEST(StaticSequence, steps_and_checks) {
+    int calls = 0;
+    auto seq = makeStaticSequence<MessageCallback>(
+        [](const Message& m){ return m.text.has_value(); },
+        [&](const Message&){ ++calls; });
+    std::shared_ptr<SequenceBase<MessageCallback>> base = seq;
+
+    Message with_text;
+    with_text.text = "text";
+    std::size_t step = 0;
+    step = base->input(step, Message{});
+    EXPECT_EQ(step, 0u);
+    step = base->input(step, with_text);
+    step = base->input(step, Message{});
+    EXPECT_TRUE(base->finished(step));
+    EXPECT_EQ(base->input(step, with_text), step);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(TimerWheel, idle_timeouts) {
+    const auto start = std::chrono::steady_clock::now();
+    utility::TimerWheel<int64_t> wheel(std::chrono::seconds(1));
+    wheel.schedule(1, 0, std::chrono::seconds(3));
+    wheel.schedule(2, 0, std::chrono::seconds(100));
+    wheel.schedule(3, 0, std::chrono::hours(2));
+
+    std::vector<int64_t> expired;
+    auto collect = [&](int64_t id, uint32_t){ expired.push_back(id); };
+    wheel.advance(start + std::chrono::seconds(2), collect);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(start + std::chrono::seconds(5), collect);
+    EXPECT_EQ(expired, std::vector<int64_t>{1});
+    wheel.advance(start + std::chrono::seconds(102), collect);
+    EXPECT_EQ(expired, (std::vector<int64_t>{1, 2}));
+    wheel.advance(start + std::chrono::hours(2) + std::chrono::seconds(2), collect);
+    EXPECT_EQ(expired, (std::vector<int64_t>{1, 2, 3}));
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,64 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+using namespace telegram;
+
+TEST(SharedPool, reuse) {
+    utility::SharedPool<std::string> pool(2);
+    int resets = 0;
+    auto reset = [&](std::string &value) {
+        value.clear();
+        ++resets;
+    };
+    auto first = pool.acquire(reset);
+    *first = "first";
+    const auto *address = first.get();
+    first.reset();
+    // the released object is handed out again, reset before
+    auto again = pool.acquire(reset);
+    ASSERT_EQ(again.get(), address);
+    ASSERT_TRUE(again->empty());
+    ASSERT_EQ(resets, 1);
+
+    // objects in use are not handed out
+    auto second = pool.acquire(reset);
+    ASSERT_NE(second.get(), again.get());
+    ASSERT_EQ(pool.size(), 2u);
+    // every pooled object is in use, the new one is not pooled
+    auto extra = pool.acquire(reset);
+    ASSERT_NE(extra.get(), again.get());
+    ASSERT_NE(extra.get(), second.get());
+    ASSERT_EQ(pool.size(), 2u);
+    extra.reset();
+    // the released pooled object is found after the one in use
+    const auto *second_address = second.get();
+    second.reset();
+    ASSERT_EQ(pool.acquire(reset).get(), second_address);
+}
+
+TEST(SharedPool, concurrent) {
+    utility::SharedPool<std::atomic<int>> pool(4);
+    constexpr int threads = 8;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) {
+                auto object = pool.acquire([](std::atomic<int> &) {});
+                // an object is used by one owner at a time
+                ASSERT_EQ(object->fetch_add(1), 0);
+                object->fetch_sub(1);
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    ASSERT_LE(pool.size(), 4u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
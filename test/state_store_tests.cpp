@@ -0,0 +1,81 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+using namespace telegram;
+
+namespace {
+const char* state_file = "state_store_test.bin";
+}
+
+TEST(MappedStateStore, reload) {
+    std::remove(state_file);
+    {
+        MappedStateStore store(state_file);
+        store.save(1, "checkout", SequenceState{2, 5, "cart"});
+        store.save(2, "checkout", SequenceState{1, 1, {}});
+        store.save(1, "checkout", SequenceState{3, 6, "cart"});
+        store.erase(2);
+    }
+    MappedStateStore store(state_file);
+    auto states = store.load();
+    ASSERT_EQ(states.size(), 1u);
+    EXPECT_EQ(states[0].id, 1);
+    EXPECT_EQ(states[0].sequence, "checkout");
+    EXPECT_EQ(states[0].state.step, 3u);
+    EXPECT_EQ(states[0].state.data, "cart");
+}
+
+TEST(MappedStateStore, compaction_and_torn_tail) {
+    std::remove(state_file);
+    {
+        MappedStateStore store(state_file);
+        for (uint32_t i = 0; i < 10000; ++i)
+            store.save(i % 10, "seq", SequenceState{i, i, std::string(64, 'x')});
+    }
+    {
+        // simulate a record interrupted by a crash
+        std::ofstream out(state_file, std::ios::binary | std::ios::app);
+        out.write("\x20\0\0\0garbage", 11);
+    }
+    {
+        std::ifstream in(state_file, std::ios::binary | std::ios::ate);
+        EXPECT_LT(in.tellg(), 100 * 1024);
+    }
+    MappedStateStore store(state_file);
+    EXPECT_EQ(store.load().size(), 10u);
+    store.save(100, "seq", {});
+    EXPECT_EQ(store.load().size(), 11u);
+}
+
+TEST(MappedStateStore, failed_compaction) {
+    std::remove(state_file);
+    const std::string tmp_file = std::string(state_file) + ".tmp";
+    std::remove(tmp_file.data());
+    {
+        MappedStateStore store(state_file);
+        store.save(1, "seq", SequenceState{1, 1, {}});
+        store.save(2, "seq", SequenceState{1, 1, {}});
+        // the compacted file can not be written, the old one keeps the records
+        ASSERT_EQ(mkdir(tmp_file.data(), 0700), 0);
+        store.compact();
+        store.save(1, "seq", SequenceState{2, 2, {}});
+        store.erase(2);
+    }
+    std::remove(tmp_file.data());
+    MappedStateStore store(state_file);
+    auto states = store.load();
+    ASSERT_EQ(states.size(), 1u);
+    EXPECT_EQ(states[0].id, 1);
+    EXPECT_EQ(states[0].state.step, 2u);
+    // compaction works again
+    store.compact();
+    EXPECT_EQ(store.load().size(), 1u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
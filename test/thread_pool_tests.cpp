@@ -0,0 +1,111 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+using namespace telegram;
+using namespace std::chrono_literals;
+
+namespace {
+/// blocks tasks until it is opened
+class Gate {
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool open = false;
+public:
+    void wait() {
+        std::unique_lock lock(mutex);
+        condition.wait(lock, [this] { return open; });
+    }
+    void release() {
+        {
+            std::unique_lock lock(mutex);
+            open = true;
+        }
+        condition.notify_all();
+    }
+};
+
+/// wait until 'predicate' is true or 'timeout' passes
+template <class Predicate>
+bool eventually(Predicate predicate, std::chrono::milliseconds timeout = 2s) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+} // namespace
+
+TEST(ThreadPool, grows_on_stalled_queue) {
+    utility::ThreadPool pool(1, 4, 10s, 10ms);
+    Gate gate;
+    // the only worker is stuck, nothing is enqueued or taken after that
+    pool.enqueue([&] { gate.wait(); });
+    auto queued = pool.enqueue([] { return 42; });
+    // the control thread notices the waiting task
+    ASSERT_EQ(queued.wait_for(2s), std::future_status::ready);
+    ASSERT_EQ(queued.get(), 42);
+    ASSERT_GE(pool.size(), 2u);
+    gate.release();
+}
+
+TEST(ThreadPool, grows_on_blocked_workers) {
+    utility::ThreadPool pool(1, 2, 10s, 10s);
+    Gate gate;
+    pool.enqueue([&] {
+        utility::ThreadPool::BlockingScope blocking;
+        gate.wait();
+    });
+    ASSERT_TRUE(eventually([&] { return pool.size() == 1; }));
+    // every worker is blocked, so the task does not wait for the queue delay
+    auto queued = pool.enqueue([] { return true; });
+    ASSERT_EQ(queued.wait_for(2s), std::future_status::ready);
+    ASSERT_EQ(pool.size(), 2u);
+    gate.release();
+}
+
+TEST(ThreadPool, shrinks_when_idle) {
+    utility::ThreadPool pool(1, 4, 50ms, 1ms);
+    Gate gate;
+    std::vector<std::future<void>> tasks;
+    for (int i = 0; i < 4; ++i)
+        tasks.push_back(pool.enqueue([&] { gate.wait(); }));
+    ASSERT_TRUE(eventually([&] { return pool.size() == 4; }));
+    gate.release();
+    for (auto &task : tasks)
+        task.get();
+    // idle workers above the lower bound are retired
+    ASSERT_TRUE(eventually([&] { return pool.size() == 1; }));
+}
+
+TEST(ThreadPool, retires_on_new_bounds) {
+    utility::ThreadPool pool(4, 4);
+    ASSERT_EQ(pool.size(), 4u);
+    pool.setBounds(1, 2);
+    ASSERT_TRUE(eventually([&] { return pool.size() == 2; }));
+    // the pool keeps working after its workers were retired and joined
+    ASSERT_EQ(pool.enqueue([] { return 1; }).get(), 1);
+    pool.setBounds(3, 3);
+    ASSERT_EQ(pool.size(), 3u);
+}
+
+TEST(ThreadPool, parallel_for) {
+    utility::ThreadPool pool(2, 2);
+    std::atomic<int> sum{0};
+    pool.parallelFor(100, [&](std::size_t i) { sum += static_cast<int>(i); });
+    ASSERT_EQ(sum, 4950);
+    ASSERT_THROW(pool.parallelFor(3, [](std::size_t i) {
+        if (i == 1)
+            throw std::runtime_error("failed");
+    }), std::runtime_error);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "telegram_bot.h"
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#include "headers/conversation.h"
+#endif
+using namespace telegram;
+using namespace std::chrono_literals;
+
+namespace {
+/// JSON of getUpdates response with text messages from 'user'
+std::string messages(int64_t user, const std::vector<std::string> &texts,
+                     std::time_t date = std::time(nullptr)) {
+    static int64_t update_id = 0;
+    std::string result;
+    for (const auto &text : texts) {
+        if (!result.empty())
+            result += ',';
+        ++update_id;
+        result += fmt::format(R"({{"update_id":{0},"message":{{"message_id":{0},"date":{1},)"
+                              R"("from":{{"id":{2},"is_bot":false,"first_name":"user"}},)"
+                              R"("chat":{{"id":{2},"type":"private"}},"text":"{3}"}}}})",
+                              update_id, date, user, text);
+    }
+    return R"({"ok":true,"result":[)" + result + "]}";
+}
+
+/// wait until 'predicate' is true or 'timeout' passes
+template <class Predicate>
+bool eventually(Predicate predicate, std::chrono::milliseconds timeout = 2s) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+/// calls 'f' when the last copy is destroyed
+std::shared_ptr<void> finally(std::function<void()> f) {
+    return {nullptr, [f = std::move(f)](void *) { f(); }};
+}
+
+// a user and its neighbour fall into the same shard of waiters
+constexpr int64_t user = 1;
+constexpr int64_t neighbour = user + 64;
+} // namespace
+
+TEST(UpdateManager, allowed_updates) {
+    UpdateManager manager(1, 1);
+    // nothing is registered, so there is nothing to request (an empty list is not sent)
+    ASSERT_TRUE(manager.allowedUpdates().empty());
+    manager.addCallback("/start", MessageCallback([](const Message &) {}));
+    manager.addCallback("data", QueryCallback([](const CallbackQuery &) {}));
+    ASSERT_EQ(manager.allowedUpdates(), (std::vector<std::string_view>{"message", "callback_query"}));
+    manager.setUpdateCallback([](const Update &) {});
+    const auto all = manager.allowedUpdates();
+    ASSERT_EQ(all.size(), 11u);
+    ASSERT_NE(std::find(all.begin(), all.end(), "poll_answer"), all.end());
+}
+
+TEST(UpdateManager, pool_bounds_in_catch_up) {
+    UpdateManager manager(1, 2);
+    CatchUpPolicy policy;
+    policy.max_lag = 10s;
+    manager.setCatchUpPolicy(policy);
+    const std::time_t old = std::time(nullptr) - 60;
+    std::atomic<bool> stop{false};
+    // bounds change while the router switches catch-up mode
+    std::thread setter([&] {
+        for (std::size_t i = 0; !stop; i = (i + 1) % 4)
+            manager.setThreadPoolBounds(1 + i, 2 + i);
+    });
+    for (int i = 0; i < 50; ++i) {
+        manager.routeCallback(messages(user, {"old"}, old));
+        ASSERT_TRUE(manager.catchingUp());
+        manager.routeCallback(messages(user, {"new"}));
+        ASSERT_FALSE(manager.catchingUp());
+    }
+    stop = true;
+    setter.join();
+    // bounds set during catch-up are kept for normal mode
+    manager.routeCallback(messages(user, {"old"}, old));
+    manager.setThreadPoolBounds(3, 5);
+    manager.routeCallback(messages(user, {"new"}));
+    ASSERT_EQ(manager.threadPoolBounds(), (std::pair<std::size_t, std::size_t>{3, 5}));
+}
+
+TEST(UpdateManager, sequence_inputs_in_order) {
+    UpdateManager manager(4, 4);
+    std::mutex mutex;
+    std::vector<std::string> seen;
+    auto sequence = std::make_shared<Sequence<MessageCallback>>();
+    for (int i = 0; i < 3; ++i) {
+        sequence->addTransition([&](const Message &message) {
+            // inputs arrive while the transition is running
+            std::this_thread::sleep_for(20ms);
+            std::unique_lock lock(mutex);
+            seen.push_back(message.text.value_or(""));
+        });
+    }
+    manager.addSequence(1, std::shared_ptr<SequenceBase<MessageCallback>>(sequence));
+    manager.routeCallback(messages(1, {"a", "b", "c"}));
+    // every input makes its own transition, none is dropped
+    ASSERT_TRUE(eventually([&] { return !manager.getSequenceState(1); }));
+    std::unique_lock lock(mutex);
+    ASSERT_EQ(seen, (std::vector<std::string>{"a", "b", "c"}));
+}
+
+TEST(UpdateManager, sequence_idle_timeout) {
+    UpdateManager manager(2, 2);
+    std::atomic<bool> expired{false};
+    auto sequence = std::make_shared<Sequence<MessageCallback>>();
+    // the input never passes the check, so the sequence waits for the user
+    sequence->addTransition([](const Message &) {})
+            ->addCheck([](const Message &) { return false; });
+    sequence->setIdleTimeout(2s, [&](int64_t) { expired = true; });
+    manager.addSequence(user, std::shared_ptr<SequenceBase<MessageCallback>>(sequence));
+    // updates refresh the activity of the user, the sequence outlives its first deadline
+    const auto begin = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - begin < 3s) {
+        manager.routeCallback(messages(user, {"a"}));
+        std::this_thread::sleep_for(500ms);
+    }
+    ASSERT_FALSE(expired);
+    ASSERT_TRUE(manager.getSequenceState(user));
+    ASSERT_TRUE(eventually([&] { return expired.load(); }, 5s));
+    ASSERT_FALSE(manager.getSequenceState(user));
+}
+
+TEST(UpdateManager, waiter_replacement) {
+    UpdateManager manager(2, 2);
+    std::atomic<bool> released{false};
+    std::atomic<int> first{0}, second{0};
+    // replaced waiter may access the waiters when destroyed (e.g conversation frame)
+    auto guard = finally([&] {
+        manager.removeWaiter(neighbour);
+        released = true;
+    });
+    manager.addWaiter<MessageCallback>(user, [&, guard](Message &&) { ++first; });
+    guard.reset();
+    manager.addWaiter<MessageCallback>(user, [&](Message &&) { ++second; });
+    ASSERT_TRUE(released);
+
+    manager.routeCallback(messages(user, {"a"}));
+    ASSERT_TRUE(eventually([&] { return second == 1; }));
+    ASSERT_EQ(first, 0);
+}
+
+TEST(UpdateManager, waiter_cancellation) {
+    UpdateManager manager(2, 2);
+    std::atomic<bool> released{false};
+    std::atomic<int> waited{0}, routed{0};
+    auto guard = finally([&] {
+        manager.removeWaiter(neighbour);
+        released = true;
+    });
+    manager.addWaiter<MessageCallback>(user, [&, guard](Message &&) { ++waited; });
+    guard.reset();
+    manager.removeWaiter(user);
+    ASSERT_TRUE(released);
+
+    // the update is routed as usual
+    manager.setUpdateCallback([&](const Update &) { ++routed; });
+    manager.routeCallback(messages(user, {"a"}));
+    ASSERT_TRUE(eventually([&] { return routed == 1; }));
+    ASSERT_EQ(waited, 0);
+}
+
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+namespace {
+/// registers waiters of conversations without a Bot
+struct Router {
+    UpdateManager &manager;
+    template <class CallbackType, class Callback>
+    void onNextUpdate(int64_t id, Callback &&callback) {
+        manager.addWaiter<CallbackType>(id, std::forward<Callback>(callback));
+    }
+};
+
+Conversation converse(Router router, std::string &text, std::atomic<bool> &done) {
+    auto guard = finally([&] { router.manager.removeWaiter(neighbour); });
+    Message message = co_await nextUpdate<MessageCallback>(router, user);
+    text = message.text.value_or("");
+    done = true;
+}
+} // namespace
+
+TEST(Conversation, resumes_on_update) {
+    UpdateManager manager(2, 2);
+    std::string first_text, second_text;
+    std::atomic<bool> first{false}, second{false};
+    converse(Router{manager}, first_text, first);
+    // the first conversation is replaced and its frame is destroyed
+    converse(Router{manager}, second_text, second);
+
+    manager.routeCallback(messages(user, {"a"}));
+    ASSERT_TRUE(eventually([&] { return second.load(); }));
+    ASSERT_EQ(second_text, "a");
+    ASSERT_FALSE(first);
+}
+#endif
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}